@@ -0,0 +1,354 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of the serialization archives
+//
+// The documents are represented by C++ types rather than by the event
+// generators. UBJSON is omitted because its archives rely on the Boost
+// collection serialization instead of the protoc functors.
+
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/serialization/nvp.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/json/oarchive.hpp>
+#include <protoc/json/iarchive.hpp>
+#include <protoc/json/string.hpp>
+#include <protoc/json/vector.hpp>
+#include <protoc/json/map.hpp>
+#include <protoc/json/nvp.hpp>
+#include <protoc/msgpack/oarchive.hpp>
+#include <protoc/msgpack/iarchive.hpp>
+#include <protoc/msgpack/string.hpp>
+#include <protoc/msgpack/vector.hpp>
+#include <protoc/msgpack/map.hpp>
+#include <protoc/transenc/oarchive.hpp>
+#include <protoc/transenc/iarchive.hpp>
+#include <protoc/transenc/string.hpp>
+#include <protoc/transenc/vector.hpp>
+#include <protoc/transenc/map.hpp>
+#include <protoc/serialization/nvp.hpp>
+#include "benchmark.hpp"
+#include "documents.hpp"
+
+namespace
+{
+
+using namespace protoc::bench;
+
+//-----------------------------------------------------------------------------
+// Document types
+//-----------------------------------------------------------------------------
+
+struct rpc_params
+{
+    std::string name;
+    bool verbose;
+    long long limit;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & boost::serialization::make_nvp("name", name);
+        archive & boost::serialization::make_nvp("verbose", verbose);
+        archive & boost::serialization::make_nvp("limit", limit);
+    }
+};
+
+struct rpc_request
+{
+    std::string jsonrpc;
+    std::string method;
+    long long id;
+    rpc_params params;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & boost::serialization::make_nvp("jsonrpc", jsonrpc);
+        archive & boost::serialization::make_nvp("method", method);
+        archive & boost::serialization::make_nvp("id", id);
+        archive & boost::serialization::make_nvp("params", params);
+    }
+
+    static rpc_request make()
+    {
+        const corpus& text = corpus::instance();
+        rpc_request result;
+        result.jsonrpc = text.version;
+        result.method = text.method;
+        result.id = 1234567;
+        result.params.name = text.user;
+        result.params.verbose = true;
+        result.params.limit = 25;
+        return result;
+    }
+
+    double checksum() const
+    {
+        return double(id + params.limit) + method.size() + params.name.size();
+    }
+};
+
+struct series
+{
+    std::vector<long long> timestamps;
+    std::vector<double> values;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & boost::serialization::make_nvp("timestamps", timestamps);
+        archive & boost::serialization::make_nvp("values", values);
+    }
+
+    static series make()
+    {
+        series result;
+        for (std::size_t i = 0; i < numeric_count; ++i)
+        {
+            result.timestamps.push_back(numeric_timestamp(i));
+            result.values.push_back(numeric_value(i));
+        }
+        return result;
+    }
+
+    double checksum() const
+    {
+        return double(timestamps.size()) + values.size()
+            + (values.empty() ? 0.0 : values.back());
+    }
+};
+
+struct dictionary
+{
+    std::map<std::string, std::string> entries;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & entries;
+    }
+
+    static dictionary make()
+    {
+        const corpus& text = corpus::instance();
+        dictionary result;
+        for (std::size_t i = 0; i < strings_count; ++i)
+        {
+            result.entries[text.keys[i]] = text.texts[i];
+        }
+        return result;
+    }
+
+    double checksum() const
+    {
+        return double(entries.size());
+    }
+};
+
+// A node has at most one child
+struct node
+{
+    long long depth;
+    std::string name;
+    std::vector<node> child;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & boost::serialization::make_nvp("depth", depth);
+        archive & boost::serialization::make_nvp("name", name);
+        archive & boost::serialization::make_nvp("child", child);
+    }
+};
+
+struct forest
+{
+    explicit forest(std::size_t size = 0) : trees(size) {}
+
+    std::vector<node> trees;
+
+    template <typename T>
+    void serialize(T& archive, const unsigned int)
+    {
+        archive & trees;
+    }
+
+    static forest make()
+    {
+        const corpus& text = corpus::instance();
+        forest result(nested_count);
+        for (std::size_t i = 0; i < nested_count; ++i)
+        {
+            node *current = &result.trees[i];
+            for (std::size_t depth = 0; depth < nested_depth; ++depth)
+            {
+                current->depth = depth;
+                current->name = text.level;
+                if (depth + 1 < nested_depth)
+                {
+                    current->child.resize(1);
+                    current = &current->child[0];
+                }
+            }
+        }
+        return result;
+    }
+
+    double checksum() const
+    {
+        return double(trees.size());
+    }
+};
+
+template <typename Document> struct value_of;
+template <> struct value_of<rpc_document> { typedef rpc_request type; };
+template <> struct value_of<numeric_document> { typedef series type; };
+template <> struct value_of<strings_document> { typedef dictionary type; };
+template <> struct value_of<nested_document> { typedef forest type; };
+
+//-----------------------------------------------------------------------------
+// Codecs
+//-----------------------------------------------------------------------------
+
+struct json_codec
+{
+    typedef char value_type;
+    typedef protoc::json::iarchive iarchive_type;
+
+    static const char *name() { return "json"; }
+
+    template <typename T>
+    static void save(std::vector<value_type>& buffer, const T& data)
+    {
+        protoc::output_container<value_type, std::vector> output(buffer);
+        protoc::json::oarchive archive(output);
+        archive << data;
+    }
+};
+
+struct msgpack_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::msgpack::iarchive iarchive_type;
+
+    static const char *name() { return "msgpack"; }
+
+    template <typename T>
+    static void save(std::vector<value_type>& buffer, const T& data)
+    {
+        protoc::output_container<value_type, std::vector> output(buffer);
+        protoc::msgpack::writer writer(output);
+        protoc::msgpack::oarchive archive(writer);
+        archive << data;
+    }
+};
+
+struct transenc_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::transenc::iarchive iarchive_type;
+
+    static const char *name() { return "transenc"; }
+
+    template <typename T>
+    static void save(std::vector<value_type>& buffer, const T& data)
+    {
+        protoc::output_container<value_type, std::vector> output(buffer);
+        protoc::transenc::writer writer(output);
+        protoc::transenc::oarchive archive(writer);
+        archive << data;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Benchmarks
+//-----------------------------------------------------------------------------
+
+template <typename Document>
+const typename value_of<Document>::type& original()
+{
+    static const typename value_of<Document>::type result = value_of<Document>::type::make();
+    return result;
+}
+
+template <typename Codec, typename Document>
+void save(state& current)
+{
+    static std::vector<typename Codec::value_type> buffer;
+    static const std::size_t items = count_items<Document>();
+    const typename value_of<Document>::type& data = original<Document>();
+
+    buffer.clear();
+    Codec::save(buffer, data);
+    current.bytes = buffer.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+void load(state& current)
+{
+    static std::vector<typename Codec::value_type> input;
+    static const std::size_t items = count_items<Document>();
+    if (input.empty())
+    {
+        Codec::save(input, original<Document>());
+    }
+
+    typename value_of<Document>::type data = typename value_of<Document>::type();
+    const typename Codec::value_type *first = &input[0];
+    typename Codec::iarchive_type archive(first, first + input.size());
+    archive >> data;
+    current.checksum += data.checksum();
+    current.bytes = input.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+void add_document()
+{
+    add(Codec::name(), "archive", Document::name(), "save", &save<Codec, Document>);
+    add(Codec::name(), "archive", Document::name(), "load", &load<Codec, Document>);
+}
+
+template <typename Codec>
+void add_codec()
+{
+    add_document<Codec, rpc_document>();
+    add_document<Codec, numeric_document>();
+    add_document<Codec, strings_document>();
+    add_document<Codec, nested_document>();
+}
+
+} // anonymous namespace
+
+namespace protoc
+{
+namespace bench
+{
+
+void add_archive_benchmarks()
+{
+    add_codec<json_codec>();
+    add_codec<msgpack_codec>();
+    add_codec<transenc_codec>();
+}
+
+} // namespace bench
+} // namespace protoc
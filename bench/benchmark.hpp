@@ -0,0 +1,69 @@
+#ifndef PROTOC_BENCH_BENCHMARK_HPP
+#define PROTOC_BENCH_BENCHMARK_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+
+namespace protoc
+{
+namespace bench
+{
+
+// The benchmarked function performs a single operation and reports how many
+// bytes and items it processed. Input data must be prepared on the first
+// call, which is not measured.
+struct state
+{
+    state() : bytes(0), items(0), checksum(0) {}
+
+    std::size_t bytes;
+    std::size_t items;
+    // Accumulates decoded values so that the work cannot be optimized away
+    double checksum;
+};
+
+typedef void (*function_type)(state&);
+
+struct benchmark
+{
+    const char *codec;
+    const char *layer;
+    const char *document;
+    const char *operation;
+    function_type function;
+};
+
+void add(const char *codec,
+         const char *layer,
+         const char *document,
+         const char *operation,
+         function_type function);
+
+// Number of allocations made through the global operator new
+std::size_t allocations();
+
+// Registration functions for each layer
+void add_detail_benchmarks();
+void add_stream_benchmarks();
+void add_archive_benchmarks();
+
+} // namespace bench
+} // namespace protoc
+
+#endif // PROTOC_BENCH_BENCHMARK_HPP
@@ -0,0 +1,510 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of the detail encoders and decoders
+
+#include <cassert>
+#include <string>
+#include <vector>
+#include <protoc/output_container.hpp>
+#include <protoc/json/encoder.hpp>
+#include <protoc/json/decoder.hpp>
+#include <protoc/msgpack/detail/encoder.hpp>
+#include <protoc/msgpack/detail/decoder.hpp>
+#include <protoc/transenc/detail/encoder.hpp>
+#include <protoc/transenc/detail/decoder.hpp>
+#include <protoc/ubjson/encoder.hpp>
+#include <protoc/ubjson/decoder.hpp>
+#include "benchmark.hpp"
+#include "documents.hpp"
+
+namespace
+{
+
+using namespace protoc::bench;
+
+//-----------------------------------------------------------------------------
+// JSON
+//-----------------------------------------------------------------------------
+
+// Inserts the separators that the JSON encoder leaves to its caller
+class json_visitor
+{
+public:
+    json_visitor(protoc::json::detail::encoder& encoder)
+        : encoder(encoder),
+          depth(0)
+    {
+    }
+
+    void value(bool data) { separator(); encoder.put(data); }
+    void value(protoc::int64_t data) { separator(); encoder.put(data); }
+    void value(protoc::float64_t data) { separator(); encoder.put(data); }
+    void value(const std::string& data) { separator(); encoder.put(data); }
+
+    void array_begin(std::size_t)
+    {
+        separator();
+        encoder.put_array_begin();
+        push(false);
+    }
+
+    void array_end()
+    {
+        --depth;
+        encoder.put_array_end();
+    }
+
+    void map_begin(std::size_t)
+    {
+        separator();
+        encoder.put_map_begin();
+        push(true);
+    }
+
+    void map_end()
+    {
+        --depth;
+        encoder.put_map_end();
+    }
+
+private:
+    void push(bool is_map)
+    {
+        assert(depth < max_depth);
+        stack[depth].is_map = is_map;
+        stack[depth].count = 0;
+        ++depth;
+    }
+
+    void separator()
+    {
+        if (depth == 0)
+            return;
+        frame& top = stack[depth - 1];
+        if (top.count > 0)
+        {
+            if (top.is_map && (top.count % 2 != 0))
+                encoder.put_colon();
+            else
+                encoder.put_comma();
+        }
+        ++top.count;
+    }
+
+private:
+    protoc::json::detail::encoder& encoder;
+    static const std::size_t max_depth = 64;
+    struct frame
+    {
+        bool is_map;
+        std::size_t count;
+    } stack[max_depth];
+    std::size_t depth;
+};
+
+struct json_codec
+{
+    typedef char value_type;
+    typedef protoc::json::detail::encoder encoder_type;
+    typedef json_visitor visitor_type;
+
+    static const char *name() { return "json"; }
+
+    static double decode(const value_type *first, const value_type *last)
+    {
+        namespace detail = protoc::json::detail;
+
+        std::string buffer;
+        double result = 0.0;
+        for (detail::decoder decoder(first, last);
+             decoder.type() != detail::token_eof;
+             decoder.next())
+        {
+            switch (decoder.type())
+            {
+            case detail::token_true:
+                result += 1.0;
+                break;
+            case detail::token_integer:
+                result += decoder.get_integer();
+                break;
+            case detail::token_float:
+                result += decoder.get_float();
+                break;
+            case detail::token_string:
+                buffer.clear();
+                decoder.get_string(buffer);
+                result += buffer.size();
+                break;
+            case detail::token_error:
+                assert(false);
+                return result;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// MessagePack
+//-----------------------------------------------------------------------------
+
+class msgpack_visitor
+{
+public:
+    msgpack_visitor(protoc::msgpack::detail::encoder& encoder)
+        : encoder(encoder)
+    {
+    }
+
+    void value(bool data) { encoder.put(data); }
+    void value(protoc::int64_t data) { encoder.put(data); }
+    void value(protoc::float64_t data) { encoder.put(data); }
+    void value(const std::string& data) { encoder.put(data); }
+    void array_begin(std::size_t count) { encoder.put_array_begin(count); }
+    void array_end() {}
+    void map_begin(std::size_t count) { encoder.put_map_begin(count); }
+    void map_end() {}
+
+private:
+    protoc::msgpack::detail::encoder& encoder;
+};
+
+struct msgpack_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::msgpack::detail::encoder encoder_type;
+    typedef msgpack_visitor visitor_type;
+
+    static const char *name() { return "msgpack"; }
+
+    static double decode(const value_type *first, const value_type *last)
+    {
+        namespace detail = protoc::msgpack::detail;
+
+        double result = 0.0;
+        for (detail::decoder decoder(first, last);
+             decoder.type() != detail::token_eof;
+             decoder.next())
+        {
+            switch (decoder.type())
+            {
+            case detail::token_true:
+                result += 1.0;
+                break;
+            case detail::token_int8:
+                result += decoder.get_int8();
+                break;
+            case detail::token_int16:
+                result += decoder.get_int16();
+                break;
+            case detail::token_int32:
+                result += decoder.get_int32();
+                break;
+            case detail::token_int64:
+                result += decoder.get_int64();
+                break;
+            case detail::token_uint8:
+                result += decoder.get_uint8();
+                break;
+            case detail::token_uint16:
+                result += decoder.get_uint16();
+                break;
+            case detail::token_uint32:
+                result += decoder.get_uint32();
+                break;
+            case detail::token_uint64:
+                result += decoder.get_uint64();
+                break;
+            case detail::token_float32:
+                result += decoder.get_float32();
+                break;
+            case detail::token_float64:
+                result += decoder.get_float64();
+                break;
+            case detail::token_str8:
+            case detail::token_str16:
+            case detail::token_str32:
+                result += decoder.get_string_view().size();
+                break;
+            case detail::token_error:
+                assert(false);
+                return result;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Transenc
+//-----------------------------------------------------------------------------
+
+class transenc_visitor
+{
+public:
+    transenc_visitor(protoc::transenc::detail::encoder& encoder)
+        : encoder(encoder)
+    {
+    }
+
+    void value(bool data) { encoder.put(data); }
+    void value(protoc::int64_t data) { encoder.put(data); }
+    void value(protoc::float64_t data) { encoder.put(data); }
+    void value(const std::string& data) { encoder.put(data); }
+    void array_begin(std::size_t count) { encoder.put_array_begin(count); }
+    void array_end() { encoder.put_array_end(); }
+    void map_begin(std::size_t count) { encoder.put_map_begin(count); }
+    void map_end() { encoder.put_map_end(); }
+
+private:
+    protoc::transenc::detail::encoder& encoder;
+};
+
+struct transenc_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::transenc::detail::encoder encoder_type;
+    typedef transenc_visitor visitor_type;
+
+    static const char *name() { return "transenc"; }
+
+    static double decode(const value_type *first, const value_type *last)
+    {
+        namespace detail = protoc::transenc::detail;
+
+        double result = 0.0;
+        for (detail::decoder decoder(first, last);
+             decoder.type() != detail::token_eof;
+             decoder.next())
+        {
+            switch (decoder.type())
+            {
+            case detail::token_true:
+                result += 1.0;
+                break;
+            case detail::token_int8:
+                result += decoder.get_int8();
+                break;
+            case detail::token_int16:
+                result += decoder.get_int16();
+                break;
+            case detail::token_int32:
+                result += decoder.get_int32();
+                break;
+            case detail::token_int64:
+                result += decoder.get_int64();
+                break;
+            case detail::token_float32:
+                result += decoder.get_float32();
+                break;
+            case detail::token_float64:
+                result += decoder.get_float64();
+                break;
+            case detail::token_string:
+                result += decoder.get_string_view().size();
+                break;
+            case detail::token_error:
+                assert(false);
+                return result;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// UBJSON
+//-----------------------------------------------------------------------------
+
+class ubjson_visitor
+{
+public:
+    ubjson_visitor(protoc::ubjson::encoder& encoder)
+        : encoder(encoder)
+    {
+    }
+
+    void value(bool data) { encoder.put(data); }
+    void value(protoc::int64_t data) { encoder.put(data); }
+    void value(protoc::float64_t data) { encoder.put(data); }
+    void value(const std::string& data) { encoder.put(data); }
+    void array_begin(std::size_t) { encoder.put_array_begin(); }
+    void array_end() { encoder.put_array_end(); }
+    void map_begin(std::size_t) { encoder.put_object_begin(); }
+    void map_end() { encoder.put_object_end(); }
+
+private:
+    protoc::ubjson::encoder& encoder;
+};
+
+struct ubjson_codec
+{
+    typedef char value_type;
+    typedef protoc::ubjson::encoder encoder_type;
+    typedef ubjson_visitor visitor_type;
+
+    static const char *name() { return "ubjson"; }
+
+    static double decode(const value_type *first, const value_type *last)
+    {
+        namespace ubjson = protoc::ubjson;
+
+        double result = 0.0;
+        for (ubjson::decoder decoder(first, last);
+             decoder.type() != ubjson::token_eof;
+             decoder.next())
+        {
+            switch (decoder.type())
+            {
+            case ubjson::token_true:
+                result += 1.0;
+                break;
+            case ubjson::token_int8:
+                result += decoder.get_int8();
+                break;
+            case ubjson::token_int16:
+                result += decoder.get_int16();
+                break;
+            case ubjson::token_int32:
+                result += decoder.get_int32();
+                break;
+            case ubjson::token_int64:
+                result += decoder.get_int64();
+                break;
+            case ubjson::token_float32:
+                result += decoder.get_float32();
+                break;
+            case ubjson::token_float64:
+                result += decoder.get_float64();
+                break;
+            case ubjson::token_string:
+                result += decoder.get_string().size();
+                break;
+            case ubjson::token_error:
+                assert(false);
+                return result;
+            default:
+                break;
+            }
+        }
+        return result;
+    }
+};
+
+//-----------------------------------------------------------------------------
+// Benchmarks
+//-----------------------------------------------------------------------------
+
+template <typename Codec, typename Document>
+void encode_into(std::vector<typename Codec::value_type>& buffer)
+{
+    buffer.clear();
+    protoc::output_container<typename Codec::value_type, std::vector> output(buffer);
+    typename Codec::encoder_type encoder(output);
+    typename Codec::visitor_type visitor(encoder);
+    Document::generate(visitor);
+}
+
+template <typename Codec, typename Document>
+void encode(state& current)
+{
+    // The buffer is reused so that only the allocations of the encoder are
+    // counted
+    static std::vector<typename Codec::value_type> buffer;
+    static const std::size_t items = count_items<Document>();
+
+    encode_into<Codec, Document>(buffer);
+    current.bytes = buffer.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+const std::vector<typename Codec::value_type>& encoded()
+{
+    static std::vector<typename Codec::value_type> result;
+    if (result.empty())
+    {
+        encode_into<Codec, Document>(result);
+    }
+    return result;
+}
+
+template <typename Codec, typename Document>
+void decode(state& current)
+{
+    static const std::size_t items = count_items<Document>();
+    const std::vector<typename Codec::value_type>& input = encoded<Codec, Document>();
+
+    current.checksum += Codec::decode(&input[0], &input[0] + input.size());
+    current.bytes = input.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+void add_document()
+{
+    add(Codec::name(), "detail", Document::name(), "encode", &encode<Codec, Document>);
+    add(Codec::name(), "detail", Document::name(), "decode", &decode<Codec, Document>);
+}
+
+template <typename Codec>
+void add_codec()
+{
+    add_document<Codec, rpc_document>();
+    add_document<Codec, numeric_document>();
+    add_document<Codec, fixed_document>();
+    add_document<Codec, strings_document>();
+    add_document<Codec, nested_document>();
+}
+
+// Microbenchmarks of the number encodings of the binary codecs
+template <typename Codec>
+void add_scalars()
+{
+    add_document<Codec, integers_document>();
+    add_document<Codec, floats_document>();
+}
+
+} // anonymous namespace
+
+namespace protoc
+{
+namespace bench
+{
+
+void add_detail_benchmarks()
+{
+    add_codec<json_codec>();
+    add_codec<msgpack_codec>();
+    add_codec<transenc_codec>();
+    add_codec<ubjson_codec>();
+
+    add_scalars<msgpack_codec>();
+    add_scalars<transenc_codec>();
+    add_scalars<ubjson_codec>();
+}
+
+} // namespace bench
+} // namespace protoc
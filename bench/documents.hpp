@@ -0,0 +1,332 @@
+#ifndef PROTOC_BENCH_DOCUMENTS_HPP
+#define PROTOC_BENCH_DOCUMENTS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <protoc/types.hpp>
+
+// Representative documents described as a sequence of events. A generator
+// drives a visitor with the following interface:
+//
+//   void value(bool);
+//   void value(protoc::int64_t);
+//   void value(protoc::float64_t);
+//   void value(const std::string&);
+//   void array_begin(std::size_t count);
+//   void array_end();
+//   void map_begin(std::size_t count); // Number of key-value pairs
+//   void map_end();
+
+namespace protoc
+{
+namespace bench
+{
+
+const std::size_t numeric_count = 50000;
+const std::size_t fixed_count = 50000;
+const std::size_t scalar_count = 200000;
+const std::size_t strings_count = 5000;
+const std::size_t nested_count = 100;
+const std::size_t nested_depth = 32;
+
+// Text used by the documents. Created once so that the generators do not
+// allocate.
+struct corpus
+{
+    corpus()
+        : jsonrpc("jsonrpc"),
+          version("2.0"),
+          method_key("method"),
+          method("user.lookup"),
+          id("id"),
+          params("params"),
+          name("name"),
+          user("alice"),
+          verbose("verbose"),
+          limit("limit"),
+          timestamps("timestamps"),
+          values("values"),
+          depth("depth"),
+          level("level"),
+          child("child")
+    {
+        for (std::size_t i = 0; i < strings_count; ++i)
+        {
+            char buffer[64];
+            std::sprintf(buffer, "key-%05u", unsigned(i));
+            keys.push_back(buffer);
+            if (i % 8 == 0)
+            {
+                std::sprintf(buffer, "line %u\n\"quoted\" text", unsigned(i));
+            }
+            else
+            {
+                std::sprintf(buffer, "value number %u of the string corpus", unsigned(i));
+            }
+            texts.push_back(buffer);
+        }
+    }
+
+    static const corpus& instance()
+    {
+        static corpus result;
+        return result;
+    }
+
+    const std::string jsonrpc;
+    const std::string version;
+    const std::string method_key;
+    const std::string method;
+    const std::string id;
+    const std::string params;
+    const std::string name;
+    const std::string user;
+    const std::string verbose;
+    const std::string limit;
+    const std::string timestamps;
+    const std::string values;
+    const std::string depth;
+    const std::string level;
+    const std::string child;
+    std::vector<std::string> keys;
+    std::vector<std::string> texts;
+};
+
+inline protoc::int64_t numeric_timestamp(std::size_t index)
+{
+    return protoc::int64_t(1400000000000LL) + protoc::int64_t(index) * 250;
+}
+
+inline protoc::float64_t numeric_value(std::size_t index)
+{
+    return 20.0 + (index % 1000) * 0.0625 - (index % 7) * 1.5;
+}
+
+// Small RPC request
+struct rpc_document
+{
+    static const char *name() { return "rpc"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        const corpus& text = corpus::instance();
+        visitor.map_begin(4);
+        visitor.value(text.jsonrpc);
+        visitor.value(text.version);
+        visitor.value(text.method_key);
+        visitor.value(text.method);
+        visitor.value(text.id);
+        visitor.value(protoc::int64_t(1234567));
+        visitor.value(text.params);
+        visitor.map_begin(3);
+        visitor.value(text.name);
+        visitor.value(text.user);
+        visitor.value(text.verbose);
+        visitor.value(true);
+        visitor.value(text.limit);
+        visitor.value(protoc::int64_t(25));
+        visitor.map_end();
+        visitor.map_end();
+    }
+};
+
+// Large arrays of timestamps and measurements
+struct numeric_document
+{
+    static const char *name() { return "numeric"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        const corpus& text = corpus::instance();
+        visitor.map_begin(2);
+        visitor.value(text.timestamps);
+        visitor.array_begin(numeric_count);
+        for (std::size_t i = 0; i < numeric_count; ++i)
+        {
+            visitor.value(numeric_timestamp(i));
+        }
+        visitor.array_end();
+        visitor.value(text.values);
+        visitor.array_begin(numeric_count);
+        for (std::size_t i = 0; i < numeric_count; ++i)
+        {
+            visitor.value(numeric_value(i));
+        }
+        visitor.array_end();
+        visitor.map_end();
+    }
+};
+
+// Map of strings, some of which need escaping in JSON
+struct strings_document
+{
+    static const char *name() { return "strings"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        const corpus& text = corpus::instance();
+        visitor.map_begin(strings_count);
+        for (std::size_t i = 0; i < strings_count; ++i)
+        {
+            visitor.value(text.keys[i]);
+            visitor.value(text.texts[i]);
+        }
+        visitor.map_end();
+    }
+};
+
+// Deeply nested records
+struct nested_document
+{
+    static const char *name() { return "nested"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        const corpus& text = corpus::instance();
+        visitor.array_begin(nested_count);
+        for (std::size_t i = 0; i < nested_count; ++i)
+        {
+            for (std::size_t depth = 0; depth < nested_depth; ++depth)
+            {
+                visitor.map_begin(3);
+                visitor.value(text.depth);
+                visitor.value(protoc::int64_t(depth));
+                visitor.value(text.name);
+                visitor.value(text.level);
+                visitor.value(text.child);
+            }
+            visitor.map_begin(0);
+            for (std::size_t depth = 0; depth <= nested_depth; ++depth)
+            {
+                visitor.map_end();
+            }
+        }
+        visitor.array_end();
+    }
+};
+
+// Array of integers of every fixed width and doubles, which exercises the
+// multi-byte loads and stores of the binary codecs
+struct fixed_document
+{
+    static const char *name() { return "fixed"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        visitor.array_begin(5 * fixed_count);
+        for (std::size_t i = 0; i < fixed_count; ++i)
+        {
+            const protoc::int64_t index = protoc::int64_t(i);
+            visitor.value(protoc::int64_t(200) + index % 30000);
+            visitor.value(protoc::int64_t(-300) - index % 30000);
+            visitor.value(protoc::int64_t(70000) + index * 3);
+            visitor.value(protoc::int64_t(5000000000LL) + index * 7);
+            visitor.value(numeric_value(i));
+        }
+        visitor.array_end();
+    }
+};
+
+// Array of integers that cycles through the 8, 16, 32 and 64-bit encodings
+struct integers_document
+{
+    static const char *name() { return "integers"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        visitor.array_begin(scalar_count);
+        for (std::size_t i = 0; i < scalar_count; ++i)
+        {
+            const protoc::int64_t index = protoc::int64_t(i);
+            switch (i % 4)
+            {
+            case 0:
+                visitor.value(protoc::int64_t(-100) + index % 200);
+                break;
+            case 1:
+                visitor.value(protoc::int64_t(-1000) - index % 30000);
+                break;
+            case 2:
+                visitor.value(protoc::int64_t(70000) + index * 3);
+                break;
+            default:
+                visitor.value(protoc::int64_t(5000000000LL) + index * 7);
+                break;
+            }
+        }
+        visitor.array_end();
+    }
+};
+
+// Array of doubles
+struct floats_document
+{
+    static const char *name() { return "floats"; }
+
+    template <typename Visitor>
+    static void generate(Visitor& visitor)
+    {
+        visitor.array_begin(scalar_count);
+        for (std::size_t i = 0; i < scalar_count; ++i)
+        {
+            visitor.value(numeric_value(i) / 3.0);
+        }
+        visitor.array_end();
+    }
+};
+
+// Counts the scalar items of a document
+class item_counter
+{
+public:
+    item_counter() : count(0) {}
+
+    void value(bool) { ++count; }
+    void value(protoc::int64_t) { ++count; }
+    void value(protoc::float64_t) { ++count; }
+    void value(const std::string&) { ++count; }
+    void array_begin(std::size_t) {}
+    void array_end() {}
+    void map_begin(std::size_t) {}
+    void map_end() {}
+
+    std::size_t count;
+};
+
+template <typename Document>
+std::size_t count_items()
+{
+    item_counter counter;
+    Document::generate(counter);
+    return counter.count;
+}
+
+} // namespace bench
+} // namespace protoc
+
+#endif // PROTOC_BENCH_DOCUMENTS_HPP
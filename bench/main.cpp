@@ -0,0 +1,359 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Compares the codecs on representative documents.
+//
+// Usage: protocbench [--format=text|csv|json] [--filter=TEXT] [--min-time=SECONDS]
+//
+// The filter selects the benchmarks whose name contains the text. Names have
+// the form codec/layer/document/operation. The json format writes one object
+// per line.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <new>
+#include <string>
+#include <vector>
+#include "benchmark.hpp"
+
+#if __cplusplus >= 201103L
+# define PROTOC_BENCH_THROW_BAD_ALLOC
+# define PROTOC_BENCH_NOTHROW noexcept
+#else
+# define PROTOC_BENCH_THROW_BAD_ALLOC throw(std::bad_alloc)
+# define PROTOC_BENCH_NOTHROW throw()
+#endif
+
+//-----------------------------------------------------------------------------
+// Allocation counting
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+std::size_t allocation_count = 0;
+
+void *allocate(std::size_t size)
+{
+    ++allocation_count;
+    void *result = std::malloc(size ? size : 1);
+    if (result == 0)
+        throw std::bad_alloc();
+    return result;
+}
+
+} // anonymous namespace
+
+void *operator new(std::size_t size) PROTOC_BENCH_THROW_BAD_ALLOC
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size) PROTOC_BENCH_THROW_BAD_ALLOC
+{
+    return allocate(size);
+}
+
+void operator delete(void *pointer) PROTOC_BENCH_NOTHROW
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) PROTOC_BENCH_NOTHROW
+{
+    std::free(pointer);
+}
+
+#if __cplusplus >= 201402L
+// Sized deallocation is used by C++14 compilers when the size is known
+void operator delete(void *pointer, std::size_t) PROTOC_BENCH_NOTHROW
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) PROTOC_BENCH_NOTHROW
+{
+    operator delete[](pointer);
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// Registry
+//-----------------------------------------------------------------------------
+
+namespace protoc
+{
+namespace bench
+{
+
+namespace
+{
+
+std::vector<benchmark>& registry()
+{
+    static std::vector<benchmark> result;
+    return result;
+}
+
+} // anonymous namespace
+
+void add(const char *codec,
+         const char *layer,
+         const char *document,
+         const char *operation,
+         function_type function)
+{
+    benchmark entry = { codec, layer, document, operation, function };
+    registry().push_back(entry);
+}
+
+std::size_t allocations()
+{
+    return allocation_count;
+}
+
+} // namespace bench
+} // namespace protoc
+
+//-----------------------------------------------------------------------------
+// Measurement
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+using namespace protoc::bench;
+
+enum format_type
+{
+    format_text,
+    format_csv,
+    format_json
+};
+
+struct options
+{
+    options()
+        : format(format_text),
+          min_time(0.5)
+    {
+    }
+
+    format_type format;
+    std::string filter;
+    double min_time;
+};
+
+struct result
+{
+    std::size_t iterations;
+    double seconds;
+    std::size_t bytes;
+    std::size_t items;
+    std::size_t allocations;
+};
+
+volatile double sink = 0.0;
+
+double elapsed(std::clock_t start)
+{
+    return double(std::clock() - start) / CLOCKS_PER_SEC;
+}
+
+// Doubles the number of iterations until a batch runs for at least min_time
+result measure(const benchmark& entry, double min_time)
+{
+    state current;
+    // Warm up and let the benchmark prepare its input
+    entry.function(current);
+
+    result outcome;
+    outcome.iterations = 1;
+    while (true)
+    {
+        const std::size_t allocations_before = allocations();
+        const std::clock_t start = std::clock();
+        for (std::size_t i = 0; i < outcome.iterations; ++i)
+        {
+            entry.function(current);
+        }
+        outcome.seconds = elapsed(start);
+        outcome.allocations = allocations() - allocations_before;
+        if (outcome.seconds >= min_time)
+            break;
+        outcome.iterations *= 2;
+    }
+    outcome.bytes = current.bytes;
+    outcome.items = current.items;
+    sink = sink + current.checksum;
+    return outcome;
+}
+
+std::string name_of(const benchmark& entry)
+{
+    std::string name = entry.codec;
+    name += '/';
+    name += entry.layer;
+    name += '/';
+    name += entry.document;
+    name += '/';
+    name += entry.operation;
+    return name;
+}
+
+void print_header(format_type format)
+{
+    switch (format)
+    {
+    case format_text:
+        std::printf("%-36s %12s %14s %10s %14s %12s\n",
+                    "name", "iterations", "ns/op", "MB/s", "items/s", "allocs/op");
+        break;
+    case format_csv:
+        std::printf("codec,layer,document,operation,iterations,ns_per_op,mb_per_s,items_per_s,allocs_per_op\n");
+        break;
+    case format_json:
+        break;
+    }
+}
+
+void print_result(format_type format, const benchmark& entry, const result& outcome)
+{
+    const double iterations = double(outcome.iterations);
+    const double seconds = (outcome.seconds > 0.0) ? outcome.seconds : 1e-9;
+    const double ns_per_op = seconds * 1e9 / iterations;
+    const double mb_per_s = outcome.bytes * iterations / seconds / (1024.0 * 1024.0);
+    const double items_per_s = outcome.items * iterations / seconds;
+    const double allocs_per_op = outcome.allocations / iterations;
+
+    switch (format)
+    {
+    case format_text:
+        std::printf("%-36s %12lu %14.0f %10.1f %14.0f %12.2f\n",
+                    name_of(entry).c_str(),
+                    static_cast<unsigned long>(outcome.iterations),
+                    ns_per_op,
+                    mb_per_s,
+                    items_per_s,
+                    allocs_per_op);
+        break;
+    case format_csv:
+        std::printf("%s,%s,%s,%s,%lu,%.1f,%.3f,%.1f,%.3f\n",
+                    entry.codec,
+                    entry.layer,
+                    entry.document,
+                    entry.operation,
+                    static_cast<unsigned long>(outcome.iterations),
+                    ns_per_op,
+                    mb_per_s,
+                    items_per_s,
+                    allocs_per_op);
+        break;
+    case format_json:
+        std::printf("{\"codec\":\"%s\",\"layer\":\"%s\",\"document\":\"%s\",\"operation\":\"%s\","
+                    "\"iterations\":%lu,\"ns_per_op\":%.1f,\"mb_per_s\":%.3f,"
+                    "\"items_per_s\":%.1f,\"allocs_per_op\":%.3f,\"bytes\":%lu}\n",
+                    entry.codec,
+                    entry.layer,
+                    entry.document,
+                    entry.operation,
+                    static_cast<unsigned long>(outcome.iterations),
+                    ns_per_op,
+                    mb_per_s,
+                    items_per_s,
+                    allocs_per_op,
+                    static_cast<unsigned long>(outcome.bytes));
+        break;
+    }
+    std::fflush(stdout);
+}
+
+bool starts_with(const char *text, const char *prefix, const char *& rest)
+{
+    const std::size_t size = std::strlen(prefix);
+    if (std::strncmp(text, prefix, size) != 0)
+        return false;
+    rest = text + size;
+    return true;
+}
+
+bool parse(int argc, char *argv[], options& result)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        const char *value = 0;
+        if (starts_with(argv[i], "--format=", value))
+        {
+            if (std::strcmp(value, "text") == 0)
+                result.format = format_text;
+            else if (std::strcmp(value, "csv") == 0)
+                result.format = format_csv;
+            else if (std::strcmp(value, "json") == 0)
+                result.format = format_json;
+            else
+                return false;
+        }
+        else if (starts_with(argv[i], "--filter=", value))
+        {
+            result.filter = value;
+        }
+        else if (starts_with(argv[i], "--min-time=", value))
+        {
+            result.min_time = std::atof(value);
+            if (result.min_time <= 0.0)
+                return false;
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+} // anonymous namespace
+
+int main(int argc, char *argv[])
+{
+    options settings;
+    if (!parse(argc, argv, settings))
+    {
+        std::fprintf(stderr,
+                     "Usage: %s [--format=text|csv|json] [--filter=TEXT] [--min-time=SECONDS]\n",
+                     argv[0]);
+        return 1;
+    }
+
+    add_detail_benchmarks();
+    add_stream_benchmarks();
+    add_archive_benchmarks();
+
+    print_header(settings.format);
+    const std::vector<benchmark>& benchmarks = registry();
+    for (std::vector<benchmark>::const_iterator it = benchmarks.begin();
+         it != benchmarks.end();
+         ++it)
+    {
+        if (name_of(*it).find(settings.filter) == std::string::npos)
+            continue;
+        print_result(settings.format, *it, measure(*it, settings.min_time));
+    }
+    return 0;
+}
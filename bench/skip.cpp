@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Compares reader::next_sibling() with skipping unwanted subtrees token by
+// token. Each document is an array of records of which only the "id" field is
+// read.
+
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <protoc/reader.hpp>
+#include <protoc/output_vector.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/detail/encoder.hpp>
+#include <protoc/transenc/reader.hpp>
+#include <protoc/transenc/detail/encoder.hpp>
+
+namespace
+{
+
+const int record_count = 10000;
+const int value_count = 32;
+
+struct binary_output : public protoc::output_vector<unsigned char>
+{
+};
+
+std::string make_name(int index)
+{
+    char buffer[32];
+    std::sprintf(buffer, "record-%d", index);
+    return buffer;
+}
+
+//-----------------------------------------------------------------------------
+// Documents
+//-----------------------------------------------------------------------------
+
+std::string make_json()
+{
+    std::string result = "[";
+    for (int i = 0; i < record_count; ++i)
+    {
+        char buffer[64];
+        if (i > 0)
+            result += ',';
+        std::sprintf(buffer, "{\"id\":%d,\"name\":\"", i);
+        result += buffer;
+        result += make_name(i);
+        result += "\",\"values\":[";
+        for (int j = 0; j < value_count; ++j)
+        {
+            std::sprintf(buffer, "%s%d.5", (j > 0) ? "," : "", i + j);
+            result += buffer;
+        }
+        result += "],\"meta\":{\"tags\":[\"a\",\"[b]\",\"{c}\"],\"nested\":{\"x\":[1,2,3]}}}";
+    }
+    result += "]";
+    return result;
+}
+
+template <typename Encoder>
+void put_meta(Encoder& encoder)
+{
+    encoder.put(std::string("tags"));
+    encoder.put_array_begin(3);
+    encoder.put(std::string("a"));
+    encoder.put(std::string("[b]"));
+    encoder.put(std::string("{c}"));
+}
+
+std::vector<unsigned char> make_msgpack()
+{
+    binary_output buffer;
+    protoc::msgpack::detail::encoder encoder(buffer);
+    encoder.put_array_begin(record_count);
+    for (int i = 0; i < record_count; ++i)
+    {
+        encoder.put_map_begin(4);
+        encoder.put(std::string("id"));
+        encoder.put(i);
+        encoder.put(std::string("name"));
+        encoder.put(make_name(i));
+        encoder.put(std::string("values"));
+        encoder.put_array_begin(value_count);
+        for (int j = 0; j < value_count; ++j)
+        {
+            encoder.put(i + j + 0.5);
+        }
+        encoder.put(std::string("meta"));
+        encoder.put_map_begin(2);
+        put_meta(encoder);
+        encoder.put(std::string("nested"));
+        encoder.put_map_begin(1);
+        encoder.put(std::string("x"));
+        encoder.put_array_begin(3);
+        encoder.put(1);
+        encoder.put(2);
+        encoder.put(3);
+    }
+    return std::vector<unsigned char>(buffer.begin(), buffer.end());
+}
+
+std::vector<unsigned char> make_transenc()
+{
+    binary_output buffer;
+    protoc::transenc::detail::encoder encoder(buffer);
+    encoder.put_array_begin();
+    for (int i = 0; i < record_count; ++i)
+    {
+        encoder.put_map_begin();
+        encoder.put(std::string("id"));
+        encoder.put(protoc::int32_t(i));
+        encoder.put(std::string("name"));
+        encoder.put(make_name(i));
+        encoder.put(std::string("values"));
+        encoder.put_array_begin();
+        for (int j = 0; j < value_count; ++j)
+        {
+            encoder.put(i + j + 0.5);
+        }
+        encoder.put_array_end();
+        encoder.put(std::string("meta"));
+        encoder.put_map_begin();
+        put_meta(encoder);
+        encoder.put_array_end();
+        encoder.put(std::string("nested"));
+        encoder.put_map_begin();
+        encoder.put(std::string("x"));
+        encoder.put_array_begin();
+        encoder.put(protoc::int32_t(1));
+        encoder.put(protoc::int32_t(2));
+        encoder.put(protoc::int32_t(3));
+        encoder.put_array_end();
+        encoder.put_map_end();
+        encoder.put_map_end();
+        encoder.put_map_end();
+    }
+    encoder.put_array_end();
+    return std::vector<unsigned char>(buffer.begin(), buffer.end());
+}
+
+//-----------------------------------------------------------------------------
+// Consumers
+//-----------------------------------------------------------------------------
+
+void skip_sibling(protoc::reader& reader)
+{
+    reader.next_sibling();
+}
+
+void skip_tokens(protoc::reader& reader)
+{
+    const protoc::reader::size_type depth = reader.size();
+    reader.next();
+    while (reader.size() > depth)
+    {
+        reader.next();
+    }
+}
+
+// Returns the sum of all record identifiers. Transenc containers start with
+// their element count (or null) which is skipped.
+long long consume(protoc::reader& reader,
+                  void (*skip)(protoc::reader&),
+                  bool has_count)
+{
+    long long result = 0;
+    reader.next(protoc::token::token_array_begin);
+    if (has_count)
+        reader.next();
+    while (reader.type() == protoc::token::token_map_begin)
+    {
+        reader.next();
+        if (has_count)
+            reader.next();
+        while (reader.type() != protoc::token::token_map_end)
+        {
+            const protoc::reader::string_view_type key = reader.get_string_view();
+            const bool is_id = (key.size() == 2) && (std::memcmp(key.begin(), "id", 2) == 0);
+            reader.next();
+            if (is_id)
+            {
+                result += reader.get_long_long();
+                reader.next();
+            }
+            else
+            {
+                skip(reader);
+            }
+        }
+        reader.next();
+    }
+    return result;
+}
+
+template <typename Reader, typename Iterator>
+void run(const char *codec,
+         const char *method,
+         Iterator begin,
+         Iterator end,
+         void (*skip)(protoc::reader&),
+         bool has_count = false)
+{
+    const long long expected = (long long)record_count * (record_count - 1) / 2;
+    const std::size_t size = (end - begin) * sizeof(*begin);
+    int iterations = 0;
+    const std::clock_t start = std::clock();
+    std::clock_t elapsed;
+    do
+    {
+        Reader reader(begin, end);
+        if (consume(reader, skip, has_count) != expected)
+        {
+            std::printf("%s %s: wrong result\n", codec, method);
+            return;
+        }
+        ++iterations;
+        elapsed = std::clock() - start;
+    } while (elapsed < CLOCKS_PER_SEC / 2);
+
+    const double seconds = double(elapsed) / CLOCKS_PER_SEC;
+    std::printf("%-10s %-8s %10.1f MB/s\n",
+                codec,
+                method,
+                (double(size) * iterations) / seconds / 1e6);
+}
+
+} // anonymous namespace
+
+int main()
+{
+    const std::string json = make_json();
+    const char *json_begin = json.data();
+    const char *json_end = json_begin + json.size();
+    run<protoc::json::reader>("json", "tokens", json_begin, json_end, skip_tokens);
+    run<protoc::json::reader>("json", "sibling", json_begin, json_end, skip_sibling);
+
+    const std::vector<unsigned char> msgpack = make_msgpack();
+    const unsigned char *msgpack_begin = &msgpack[0];
+    const unsigned char *msgpack_end = msgpack_begin + msgpack.size();
+    run<protoc::msgpack::reader>("msgpack", "tokens", msgpack_begin, msgpack_end, skip_tokens);
+    run<protoc::msgpack::reader>("msgpack", "sibling", msgpack_begin, msgpack_end, skip_sibling);
+
+    const std::vector<unsigned char> transenc = make_transenc();
+    const unsigned char *transenc_begin = &transenc[0];
+    const unsigned char *transenc_end = transenc_begin + transenc.size();
+    run<protoc::transenc::reader>("transenc", "tokens", transenc_begin, transenc_end, skip_tokens, true);
+    run<protoc::transenc::reader>("transenc", "sibling", transenc_begin, transenc_end, skip_sibling, true);
+
+    return 0;
+}
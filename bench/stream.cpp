@@ -0,0 +1,575 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+// Benchmarks of the readers, writers, push parsers and transcoder
+
+#include <string>
+#include <vector>
+#include <protoc/reader.hpp>
+#include <protoc/writer.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/output_counter.hpp>
+#include <protoc/output_segments.hpp>
+#include <protoc/transcoder.hpp>
+#include <protoc/query.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/json/writer.hpp>
+#include <protoc/json/parser.hpp>
+#include <protoc/json/document.hpp>
+#include <protoc/json/transcoder.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/msgpack/parser.hpp>
+#include <protoc/transenc/reader.hpp>
+#include <protoc/transenc/writer.hpp>
+#include <protoc/transenc/parser.hpp>
+#include "benchmark.hpp"
+#include "documents.hpp"
+
+namespace
+{
+
+using namespace protoc::bench;
+
+// Adapts the document events to the dynamic writer interface
+class dynamic_visitor
+{
+public:
+    dynamic_visitor(protoc::writer& writer)
+        : writer(writer)
+    {
+    }
+
+    void value(bool data) { writer.write(data); }
+    void value(protoc::int64_t data) { writer.write(static_cast<long long>(data)); }
+    void value(protoc::float64_t data) { writer.write(static_cast<double>(data)); }
+    void value(const std::string& data) { writer.write(data); }
+    void array_begin(std::size_t count) { writer.array_begin(count); }
+    void array_end() { writer.array_end(); }
+    void map_begin(std::size_t count) { writer.map_begin(count); }
+    void map_end() { writer.map_end(); }
+
+private:
+    protoc::writer& writer;
+};
+
+class json_visitor
+{
+public:
+    json_visitor(protoc::json::writer& writer)
+        : writer(writer)
+    {
+    }
+
+    void value(bool data) { writer.write(data); }
+    void value(protoc::int64_t data) { writer.write(data); }
+    void value(protoc::float64_t data) { writer.write(data); }
+    void value(const std::string& data) { writer.write(data); }
+    void array_begin(std::size_t count) { writer.write_array_begin(count); }
+    void array_end() { writer.write_array_end(); }
+    void map_begin(std::size_t count) { writer.write_map_begin(count); }
+    void map_end() { writer.write_map_end(); }
+
+private:
+    protoc::json::writer& writer;
+};
+
+struct json_codec
+{
+    typedef char value_type;
+    typedef protoc::json::writer writer_type;
+    typedef json_visitor visitor_type;
+    typedef protoc::json::reader reader_type;
+
+    static const char *name() { return "json"; }
+
+    template <typename Handler>
+    static void parse(const value_type *first, const value_type *last, Handler& handler)
+    {
+        protoc::json::parse(first, last, handler);
+    }
+};
+
+struct msgpack_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::msgpack::writer writer_type;
+    typedef dynamic_visitor visitor_type;
+    typedef protoc::msgpack::reader reader_type;
+
+    static const char *name() { return "msgpack"; }
+
+    template <typename Handler>
+    static void parse(const value_type *first, const value_type *last, Handler& handler)
+    {
+        protoc::msgpack::parse(first, last, handler);
+    }
+};
+
+struct transenc_codec
+{
+    typedef unsigned char value_type;
+    typedef protoc::transenc::writer writer_type;
+    typedef dynamic_visitor visitor_type;
+    typedef protoc::transenc::reader reader_type;
+
+    static const char *name() { return "transenc"; }
+
+    template <typename Handler>
+    static void parse(const value_type *first, const value_type *last, Handler& handler)
+    {
+        protoc::transenc::parse(first, last, handler);
+    }
+};
+
+// Visits every token through the dynamic reader interface
+double read_all(protoc::reader& reader)
+{
+    double result = 0.0;
+    do
+    {
+        switch (reader.type())
+        {
+        case protoc::token::token_boolean:
+            result += reader.get_bool() ? 1.0 : 0.0;
+            break;
+        case protoc::token::token_integer:
+            result += reader.get_long_long();
+            break;
+        case protoc::token::token_floating:
+            result += reader.get_double();
+            break;
+        case protoc::token::token_string:
+            if (reader.has_escapes())
+                result += reader.get_string().size();
+            else
+                result += reader.get_string_view().size();
+            break;
+        default:
+            break;
+        }
+    } while (reader.next());
+    return result;
+}
+
+// Same accumulation as read_all() for the push parsers
+struct checksum_handler
+{
+    checksum_handler() : result(0.0) {}
+
+    void on_null() {}
+    void on_bool(bool value) { result += value ? 1.0 : 0.0; }
+    void on_int(protoc::int64_t value) { result += value; }
+    void on_double(protoc::float64_t value) { result += value; }
+    void on_string(const protoc::string_view& value) { result += value.size(); }
+    void on_binary(const protoc::binary_view&) {}
+    void on_record_begin() {}
+    void on_record_end() {}
+    void on_array_begin() {}
+    void on_array_end() {}
+    void on_map_begin() {}
+    void on_map_end() {}
+
+    double result;
+};
+
+template <typename Codec, typename Document>
+void write_into(std::vector<typename Codec::value_type>& buffer)
+{
+    buffer.clear();
+    protoc::output_container<typename Codec::value_type, std::vector> output(buffer);
+    typename Codec::writer_type writer(output);
+    typename Codec::visitor_type visitor(writer);
+    Document::generate(visitor);
+}
+
+template <typename Codec, typename Document>
+void write(state& current)
+{
+    static std::vector<typename Codec::value_type> buffer;
+    static const std::size_t items = count_items<Document>();
+
+    write_into<Codec, Document>(buffer);
+    current.bytes = buffer.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+void read(state& current)
+{
+    static std::vector<typename Codec::value_type> input;
+    static const std::size_t items = count_items<Document>();
+    if (input.empty())
+    {
+        write_into<Codec, Document>(input);
+    }
+
+    const typename Codec::value_type *first = &input[0];
+    typename Codec::reader_type reader(first, first + input.size());
+    current.checksum += read_all(reader);
+    current.bytes = input.size();
+    current.items = items;
+}
+
+template <typename Codec, typename Document>
+void parse(state& current)
+{
+    static std::vector<typename Codec::value_type> input;
+    static const std::size_t items = count_items<Document>();
+    if (input.empty())
+    {
+        write_into<Codec, Document>(input);
+    }
+
+    const typename Codec::value_type *first = &input[0];
+    checksum_handler handler;
+    Codec::parse(first, first + input.size(), handler);
+    current.checksum += handler.result;
+    current.bytes = input.size();
+    current.items = items;
+}
+
+// Writes into a fresh buffer that grows as the document is encoded
+template <typename Codec, typename Document>
+void grow(state& current)
+{
+    static const std::size_t items = count_items<Document>();
+
+    std::vector<typename Codec::value_type> buffer;
+    write_into<Codec, Document>(buffer);
+    current.checksum += buffer.size();
+    current.bytes = buffer.size();
+    current.items = items;
+}
+
+// Counts the encoded size first, so the fresh buffer is allocated once
+template <typename Codec, typename Document>
+void sized(state& current)
+{
+    static const std::size_t items = count_items<Document>();
+
+    protoc::output_counter<typename Codec::value_type> counter;
+    {
+        typename Codec::writer_type writer(counter);
+        typename Codec::visitor_type visitor(writer);
+        Document::generate(visitor);
+    }
+    std::vector<typename Codec::value_type> buffer;
+    buffer.reserve(counter.size());
+    write_into<Codec, Document>(buffer);
+    current.checksum += buffer.size();
+    current.bytes = buffer.size();
+    current.items = items;
+}
+
+// Converts the input into msgpack without an intermediate representation
+template <typename Codec, typename Document>
+void transcode(state& current)
+{
+    static std::vector<typename Codec::value_type> input;
+    static std::vector<protoc::msgpack::writer::value_type> buffer;
+    static const std::size_t items = count_items<Document>();
+    if (input.empty())
+    {
+        write_into<Codec, Document>(input);
+    }
+
+    const typename Codec::value_type *first = &input[0];
+    typename Codec::reader_type reader(first, first + input.size());
+    buffer.clear();
+    protoc::output_container<protoc::msgpack::writer::value_type, std::vector> output(buffer);
+    protoc::msgpack::writer writer(output, protoc::msgpack::writer::count_deferred_compact);
+    protoc::transcode(reader, writer);
+    current.checksum += buffer.size();
+    current.bytes = input.size();
+    current.items = items;
+}
+
+// Extracts one value behind the skipped timestamps of the numeric document
+template <typename Codec>
+void query(state& current)
+{
+    static std::vector<typename Codec::value_type> input;
+    static const std::size_t items = count_items<numeric_document>();
+    static const protoc::path where("/values/0");
+    if (input.empty())
+    {
+        write_into<Codec, numeric_document>(input);
+    }
+
+    const typename Codec::value_type *first = &input[0];
+    typename Codec::reader_type reader(first, first + input.size());
+    if (protoc::query(reader, where))
+    {
+        // JSON writes integral doubles as integers
+        current.checksum += (reader.type() == protoc::token::token_floating)
+            ? reader.get_double()
+            : reader.get_long_long();
+    }
+    current.bytes = input.size();
+    current.items = items;
+}
+
+// Array of large binary payloads, such as images
+const std::size_t blob_count = 16;
+const std::size_t blob_size = 1024 * 1024;
+
+template <typename Writer>
+void write_blobs(Writer& writer)
+{
+    static const std::vector<unsigned char> blob(blob_size, 0x2A);
+    writer.array_begin(blob_count);
+    for (std::size_t i = 0; i < blob_count; ++i)
+    {
+        writer.write(&blob[0], blob.size());
+    }
+    writer.array_end();
+}
+
+// Copies the payloads into the output buffer
+template <typename Codec>
+void blob_copy(state& current)
+{
+    static std::vector<unsigned char> buffer;
+    buffer.clear();
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    typename Codec::writer_type writer(output);
+    write_blobs(writer);
+    current.checksum += buffer.size();
+    current.bytes = buffer.size();
+    current.items = blob_count;
+}
+
+// Keeps references to the payloads in a segment list
+template <typename Codec>
+void blob_gather(state& current)
+{
+    static protoc::output_segments<unsigned char> output;
+    output.clear();
+    typename Codec::writer_type writer(output);
+    write_blobs(writer);
+    current.checksum += output.segments().size();
+    current.bytes = output.size();
+    current.items = blob_count;
+}
+
+template <typename Codec>
+void add_blobs()
+{
+    add(Codec::name(), "stream", "blobs", "copy", &blob_copy<Codec>);
+    add(Codec::name(), "stream", "blobs", "gather", &blob_gather<Codec>);
+}
+
+// Arrays of numbers written element by element or in bulk
+const std::size_t array_count = 100000;
+
+template <typename T>
+const std::vector<T>& array_values()
+{
+    static std::vector<T> values;
+    if (values.empty())
+    {
+        for (std::size_t i = 0; i < array_count; ++i)
+        {
+            values.push_back(T(numeric_value(i) * 1000));
+        }
+    }
+    return values;
+}
+
+template <typename Codec, typename T>
+void array_elements(state& current)
+{
+    static std::vector<unsigned char> buffer;
+    const std::vector<T>& values = array_values<T>();
+    buffer.clear();
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    typename Codec::writer_type writer(output);
+    writer.array_begin(values.size());
+    for (typename std::vector<T>::const_iterator it = values.begin(); it != values.end(); ++it)
+    {
+        writer.write(*it);
+    }
+    writer.array_end();
+    current.checksum += buffer.size();
+    current.bytes = buffer.size();
+    current.items = values.size();
+}
+
+template <typename Codec, typename T>
+void array_bulk(state& current)
+{
+    static std::vector<unsigned char> buffer;
+    const std::vector<T>& values = array_values<T>();
+    buffer.clear();
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    typename Codec::writer_type writer(output);
+    writer.write_array(&values[0], values.size());
+    current.checksum += buffer.size();
+    current.bytes = buffer.size();
+    current.items = values.size();
+}
+
+// Arrays of numbers read element by element or in bulk
+template <typename Codec, typename T>
+const std::vector<unsigned char>& array_input()
+{
+    static std::vector<unsigned char> buffer;
+    if (buffer.empty())
+    {
+        const std::vector<T>& values = array_values<T>();
+        protoc::output_container<unsigned char, std::vector> output(buffer);
+        typename Codec::writer_type writer(output);
+        writer.write_array(&values[0], values.size());
+    }
+    return buffer;
+}
+
+template <typename Reader>
+void get_value(const Reader& reader, int& value)
+{
+    value = reader.get_int();
+}
+
+template <typename Reader>
+void get_value(const Reader& reader, double& value)
+{
+    value = reader.get_double();
+}
+
+template <typename Codec, typename T>
+void array_read_elements(state& current)
+{
+    static std::vector<T> values;
+    const std::vector<unsigned char>& input = array_input<Codec, T>();
+    const unsigned char *first = &input[0];
+    typename Codec::reader_type reader(first, first + input.size());
+    std::size_t count = 0;
+    protoc::transcoder_reader_traits<typename Codec::reader_type>::container_begin(reader, count);
+    values.clear();
+    values.reserve(count);
+    while (reader.type() != protoc::token::token_array_end)
+    {
+        T value;
+        get_value(reader, value);
+        values.push_back(value);
+        reader.next();
+    }
+    current.checksum += values.size() + std::size_t(values.back());
+    current.bytes = input.size();
+    current.items = values.size();
+}
+
+template <typename Codec, typename T>
+void array_read_bulk(state& current)
+{
+    static std::vector<T> values;
+    const std::vector<unsigned char>& input = array_input<Codec, T>();
+    const unsigned char *first = &input[0];
+    typename Codec::reader_type reader(first, first + input.size());
+    std::size_t count = 0;
+    protoc::transcoder_reader_traits<typename Codec::reader_type>::container_begin(reader, count);
+    values.resize(count);
+    values.resize(reader.read_values(&values[0], values.size()));
+    current.checksum += values.size() + std::size_t(values.back());
+    current.bytes = input.size();
+    current.items = values.size();
+}
+
+template <typename Codec>
+void add_arrays()
+{
+    add(Codec::name(), "stream", "int_array", "elements", &array_elements<Codec, int>);
+    add(Codec::name(), "stream", "int_array", "bulk", &array_bulk<Codec, int>);
+    add(Codec::name(), "stream", "double_array", "elements", &array_elements<Codec, double>);
+    add(Codec::name(), "stream", "double_array", "bulk", &array_bulk<Codec, double>);
+    add(Codec::name(), "stream", "int_array", "read_elements", &array_read_elements<Codec, int>);
+    add(Codec::name(), "stream", "int_array", "read_bulk", &array_read_bulk<Codec, int>);
+    add(Codec::name(), "stream", "double_array", "read_elements", &array_read_elements<Codec, double>);
+    add(Codec::name(), "stream", "double_array", "read_bulk", &array_read_bulk<Codec, double>);
+}
+
+// Structural pass of the lazy JSON document, touching only the root
+template <typename Document>
+void index(state& current)
+{
+    static std::vector<char> input;
+    static const std::size_t items = count_items<Document>();
+    if (input.empty())
+    {
+        write_into<json_codec, Document>(input);
+    }
+
+    const char *first = &input[0];
+    protoc::json::document document(first, first + input.size());
+    current.checksum += document.size();
+    current.bytes = input.size();
+    current.items = items;
+}
+
+template <typename Document>
+void add_json_index()
+{
+    add(json_codec::name(), "stream", Document::name(), "index", &index<Document>);
+}
+
+template <typename Codec, typename Document>
+void add_document()
+{
+    add(Codec::name(), "stream", Document::name(), "write", &write<Codec, Document>);
+    add(Codec::name(), "stream", Document::name(), "read", &read<Codec, Document>);
+    add(Codec::name(), "stream", Document::name(), "parse", &parse<Codec, Document>);
+    add(Codec::name(), "stream", Document::name(), "transcode", &transcode<Codec, Document>);
+    add(Codec::name(), "stream", Document::name(), "grow", &grow<Codec, Document>);
+    add(Codec::name(), "stream", Document::name(), "sized", &sized<Codec, Document>);
+}
+
+template <typename Codec>
+void add_codec()
+{
+    add(Codec::name(), "stream", numeric_document::name(), "query", &query<Codec>);
+    add_document<Codec, rpc_document>();
+    add_document<Codec, numeric_document>();
+    add_document<Codec, strings_document>();
+    add_document<Codec, nested_document>();
+}
+
+} // anonymous namespace
+
+namespace protoc
+{
+namespace bench
+{
+
+// UBJSON has no reader or writer
+void add_stream_benchmarks()
+{
+    add_codec<json_codec>();
+    add_json_index<rpc_document>();
+    add_json_index<numeric_document>();
+    add_json_index<strings_document>();
+    add_json_index<nested_document>();
+    add_codec<msgpack_codec>();
+    add_blobs<msgpack_codec>();
+    add_arrays<msgpack_codec>();
+    add_codec<transenc_codec>();
+    add_blobs<transenc_codec>();
+    add_arrays<transenc_codec>();
+}
+
+} // namespace bench
+} // namespace protoc
@@ -0,0 +1,107 @@
+#ifndef PROTOC_CHUNK_DECODER_HPP
+#define PROTOC_CHUNK_DECODER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <vector>
+#include <boost/noncopyable.hpp>
+#include <boost/type_traits/remove_const.hpp>
+
+namespace protoc
+{
+
+// Resumable decoding of input that arrives in chunks
+//
+// Wraps one of the detail decoders, such as protoc::msgpack::detail::decoder.
+// Tokens are decoded directly from the chunks. When a chunk ends inside a
+// token, need_more() becomes true and the partial token is copied into an
+// internal buffer. The token_scanner of the decoder follows the token into
+// the next chunks, so only the values up to the end of the token are
+// appended to the buffer and no value is scanned twice. Once the token has
+// been decoded from the buffer, the rest of the chunk is decoded in place.
+//
+//   protoc::chunk_decoder<protoc::msgpack::detail::decoder> input;
+//   while (receive(chunk))
+//   {
+//       input.feed(chunk.begin(), chunk.end());
+//       while (!input.need_more())
+//       {
+//           process(input.current());
+//           input.next();
+//       }
+//   }
+//   input.finish();
+template <typename Decoder>
+class chunk_decoder
+    : private boost::noncopyable
+{
+public:
+    typedef Decoder decoder_type;
+    typedef typename boost::remove_const<typename Decoder::value_type>::type value_type;
+
+    chunk_decoder();
+
+    // Continues decoding with the next chunk. Must only be called when
+    // need_more() is true. The chunk must remain valid until need_more()
+    // becomes true again.
+    void feed(const value_type *first, const value_type *last);
+    // No more chunks will arrive. A partial token is decoded as is, which
+    // yields token_eof or token_error if it is incomplete.
+    void finish();
+
+    // The current token cannot be decoded until more input has been fed
+    bool need_more() const;
+    // Size of the partial token that is kept between chunks
+    std::size_t pending() const;
+
+    // The decoder positioned at the current token. Views obtained from it
+    // are valid until next() is called.
+    const decoder_type& current() const;
+    void next();
+
+private:
+    typedef typename decoder_type::token_scanner scanner_type;
+
+    void restart(const value_type *first, const value_type *last, bool buffered);
+    void check();
+    void keep(const value_type *first, const value_type *last);
+
+private:
+    decoder_type decoder;
+    scanner_type scanner;
+    // Start of the current token and end of the input
+    const value_type *mark;
+    const value_type *last;
+    // Partial token, followed by the part of the chunk that completes it
+    std::vector<value_type> buffer;
+    // Size of the partial token in the buffer
+    std::size_t joint;
+    // The chunk that completes the buffered token
+    const value_type *chunk_first;
+    const value_type *chunk_last;
+    bool buffered;
+    bool waiting;
+    bool finished;
+};
+
+} // namespace protoc
+
+#include <protoc/impl/chunk_decoder.ipp>
+
+#endif /* PROTOC_CHUNK_DECODER_HPP */
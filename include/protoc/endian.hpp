@@ -0,0 +1,194 @@
+#ifndef PROTOC_ENDIAN_HPP
+#define PROTOC_ENDIAN_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <cstring> // std::memcpy
+#include <protoc/types.hpp>
+
+// Byte order of the host, determined at compile time
+#if defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && defined(__ORDER_LITTLE_ENDIAN__)
+# if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#  define PROTOC_BIG_ENDIAN 1
+# elif __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#  define PROTOC_LITTLE_ENDIAN 1
+# endif
+#elif defined(_WIN32) || defined(__i386__) || defined(__x86_64__)
+# define PROTOC_LITTLE_ENDIAN 1
+#else
+# include <boost/detail/endian.hpp>
+# if defined(BOOST_BIG_ENDIAN)
+#  define PROTOC_BIG_ENDIAN 1
+# elif defined(BOOST_LITTLE_ENDIAN)
+#  define PROTOC_LITTLE_ENDIAN 1
+# endif
+#endif
+
+#if !defined(PROTOC_BIG_ENDIAN) && !defined(PROTOC_LITTLE_ENDIAN)
+# error "Unsupported byte order"
+#endif
+
+#if defined(_MSC_VER)
+# include <stdlib.h> // _byteswap_*
+#endif
+
+// Loading and storing of fixed-width values in a given byte order
+//
+// The functions work on unaligned byte buffers of any character type and
+// accept the integer and floating-point types of protoc/types.hpp. Values
+// are copied with std::memcpy and byte-swapped with compiler intrinsics
+// when the byte order differs from the host, so each access compiles into
+// a plain load or store, possibly followed by a single bswap instruction.
+//
+//   protoc::uint32_t length = protoc::endian::load_big<protoc::uint32_t>(data);
+//   output = protoc::endian::store_little(output, protoc::float64_t(1.0));
+
+namespace protoc
+{
+namespace endian
+{
+
+template <typename T, typename Byte>
+T load_big(const Byte *position);
+
+template <typename T, typename Byte>
+T load_little(const Byte *position);
+
+// Returns the position after the stored value
+template <typename T, typename Byte>
+Byte *store_big(Byte *position, T value);
+
+template <typename T, typename Byte>
+Byte *store_little(Byte *position, T value);
+
+namespace detail
+{
+
+// Unsigned integer of the same size as the value
+template <std::size_t Size> struct bits;
+template <> struct bits<1> { typedef protoc::uint8_t type; };
+template <> struct bits<2> { typedef protoc::uint16_t type; };
+template <> struct bits<4> { typedef protoc::uint32_t type; };
+template <> struct bits<8> { typedef protoc::uint64_t type; };
+
+inline protoc::uint8_t swap(protoc::uint8_t value)
+{
+    return value;
+}
+
+inline protoc::uint16_t swap(protoc::uint16_t value)
+{
+#if defined(_MSC_VER)
+    return _byteswap_ushort(value);
+#else
+    return static_cast<protoc::uint16_t>((value << 8) | (value >> 8));
+#endif
+}
+
+inline protoc::uint32_t swap(protoc::uint32_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap32(value);
+#elif defined(_MSC_VER)
+    return _byteswap_ulong(value);
+#else
+    return ((value & 0x000000FFU) << 24) |
+        ((value & 0x0000FF00U) << 8) |
+        ((value & 0x00FF0000U) >> 8) |
+        ((value & 0xFF000000U) >> 24);
+#endif
+}
+
+inline protoc::uint64_t swap(protoc::uint64_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_bswap64(value);
+#elif defined(_MSC_VER)
+    return _byteswap_uint64(value);
+#else
+    return (protoc::uint64_t(swap(protoc::uint32_t(value))) << 32) |
+        swap(protoc::uint32_t(value >> 32));
+#endif
+}
+
+// Converts between host order and the given order. The unused branch is
+// removed at compile time.
+template <bool BigEndian, typename Bits>
+Bits convert(Bits value)
+{
+#if defined(PROTOC_BIG_ENDIAN)
+    return BigEndian ? value : swap(value);
+#else
+    return BigEndian ? swap(value) : value;
+#endif
+}
+
+template <bool BigEndian, typename T, typename Byte>
+T load(const Byte *position)
+{
+    typedef typename bits<sizeof(T)>::type bits_type;
+    bits_type bits;
+    std::memcpy(&bits, position, sizeof(bits));
+    bits = convert<BigEndian>(bits);
+    T result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+template <bool BigEndian, typename T, typename Byte>
+Byte *store(Byte *position, T value)
+{
+    typedef typename bits<sizeof(T)>::type bits_type;
+    bits_type bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    bits = convert<BigEndian>(bits);
+    std::memcpy(position, &bits, sizeof(bits));
+    return position + sizeof(bits);
+}
+
+} // namespace detail
+
+template <typename T, typename Byte>
+inline T load_big(const Byte *position)
+{
+    return detail::load<true, T>(position);
+}
+
+template <typename T, typename Byte>
+inline T load_little(const Byte *position)
+{
+    return detail::load<false, T>(position);
+}
+
+template <typename T, typename Byte>
+inline Byte *store_big(Byte *position, T value)
+{
+    return detail::store<true>(position, value);
+}
+
+template <typename T, typename Byte>
+inline Byte *store_little(Byte *position, T value)
+{
+    return detail::store<false>(position, value);
+}
+
+} // namespace endian
+} // namespace protoc
+
+#endif /* PROTOC_ENDIAN_HPP */
@@ -0,0 +1,179 @@
+#ifndef PROTOC_IMPL_CHUNK_DECODER_IPP
+#define PROTOC_IMPL_CHUNK_DECODER_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+
+namespace protoc
+{
+
+template <typename Decoder>
+chunk_decoder<Decoder>::chunk_decoder()
+    : decoder(static_cast<const value_type *>(0), static_cast<const value_type *>(0)),
+      mark(0),
+      last(0),
+      joint(0),
+      chunk_first(0),
+      chunk_last(0),
+      buffered(false),
+      waiting(true),
+      finished(false)
+{
+}
+
+template <typename Decoder>
+void chunk_decoder<Decoder>::feed(const value_type *first, const value_type *last)
+{
+    assert(waiting);
+    assert(!finished);
+
+    if (buffer.empty())
+    {
+        restart(first, last, false);
+        return;
+    }
+
+    // Only the part of the chunk that belongs to the partial token is copied
+    const std::size_t size = scanner.scan(first, last);
+    if (!scanner.done())
+    {
+        buffer.insert(buffer.end(), first, last);
+        return;
+    }
+    joint = buffer.size();
+    buffer.insert(buffer.end(), first, first + size);
+    chunk_first = first;
+    chunk_last = last;
+    restart(&buffer[0], &buffer[0] + buffer.size(), true);
+}
+
+template <typename Decoder>
+void chunk_decoder<Decoder>::finish()
+{
+    finished = true;
+    if (waiting)
+    {
+        if (buffer.empty())
+            restart(0, 0, false);
+        else
+            restart(&buffer[0], &buffer[0] + buffer.size(), false);
+    }
+}
+
+template <typename Decoder>
+bool chunk_decoder<Decoder>::need_more() const
+{
+    return waiting;
+}
+
+template <typename Decoder>
+std::size_t chunk_decoder<Decoder>::pending() const
+{
+    return waiting ? buffer.size() : 0;
+}
+
+template <typename Decoder>
+const typename chunk_decoder<Decoder>::decoder_type& chunk_decoder<Decoder>::current() const
+{
+    return decoder;
+}
+
+template <typename Decoder>
+void chunk_decoder<Decoder>::next()
+{
+    assert(!waiting);
+
+    mark = decoder.remaining().begin();
+    decoder.next();
+    check();
+}
+
+template <typename Decoder>
+void chunk_decoder<Decoder>::restart(const value_type *first,
+                                     const value_type *last,
+                                     bool buffered)
+{
+    this->mark = first;
+    this->last = last;
+    this->buffered = buffered;
+    decoder.reset(first, last);
+    check();
+}
+
+template <typename Decoder>
+void chunk_decoder<Decoder>::check()
+{
+    if (!decoder.is_truncated())
+    {
+        waiting = false;
+        return;
+    }
+
+    if (buffered)
+    {
+        const std::size_t offset = mark - &buffer[0];
+        if (offset >= joint)
+        {
+            // The buffered token is done, and the current token starts in
+            // the chunk, so decoding continues there in place
+            const value_type *position = chunk_first + (offset - joint);
+            buffer.clear();
+            restart(position, chunk_last, false);
+        }
+        else
+        {
+            // The decoder needs more than the scanner found, which only
+            // happens with malformed input. The rest of the chunk is kept
+            // as well and the token is decoded again.
+            buffer.insert(buffer.end(), chunk_first + (buffer.size() - joint), chunk_last);
+            restart(&buffer[0] + offset, &buffer[0] + buffer.size(), false);
+        }
+        return;
+    }
+
+    waiting = !finished;
+    if (waiting)
+    {
+        keep(mark, last);
+    }
+}
+
+// Keeps the partial token for the next chunk and scans it once
+template <typename Decoder>
+void chunk_decoder<Decoder>::keep(const value_type *first, const value_type *last)
+{
+    if (!buffer.empty() && (last == &buffer[0] + buffer.size()))
+    {
+        // The partial token is already at the end of the buffer
+        buffer.erase(buffer.begin(), buffer.begin() + (first - &buffer[0]));
+    }
+    else
+    {
+        buffer.assign(first, last);
+    }
+    scanner = scanner_type();
+    if (!buffer.empty())
+    {
+        scanner.scan(&buffer[0], &buffer[0] + buffer.size());
+    }
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_CHUNK_DECODER_IPP
@@ -0,0 +1,123 @@
+#ifndef PROTOC_IMPL_MEMORY_RESOURCE_IPP
+#define PROTOC_IMPL_MEMORY_RESOURCE_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits>
+
+namespace protoc
+{
+
+inline void *memory_resource::allocate(std::size_t size, std::size_t alignment)
+{
+    return do_allocate(size, alignment);
+}
+
+inline void memory_resource::deallocate(void *pointer, std::size_t size, std::size_t alignment)
+{
+    do_deallocate(pointer, size, alignment);
+}
+
+inline bool memory_resource::is_equal(const memory_resource& other) const
+{
+    return do_is_equal(other);
+}
+
+inline memory_resource& monotonic_buffer_resource::upstream_resource() const
+{
+    return upstream;
+}
+
+//-----------------------------------------------------------------------------
+// polymorphic_allocator
+//-----------------------------------------------------------------------------
+
+template <typename T>
+polymorphic_allocator<T>::polymorphic_allocator()
+    : memory(&new_delete_resource())
+{
+}
+
+template <typename T>
+polymorphic_allocator<T>::polymorphic_allocator(memory_resource *resource)
+    : memory(resource ? resource : &new_delete_resource())
+{
+}
+
+template <typename T>
+template <typename U>
+polymorphic_allocator<T>::polymorphic_allocator(const polymorphic_allocator<U>& other)
+    : memory(other.resource())
+{
+}
+
+template <typename T>
+typename polymorphic_allocator<T>::pointer
+polymorphic_allocator<T>::allocate(size_type count, const void *)
+{
+    if (count > max_size())
+        throw std::bad_alloc();
+    return static_cast<pointer>(memory->allocate(count * sizeof(T)));
+}
+
+template <typename T>
+void polymorphic_allocator<T>::deallocate(pointer pointer, size_type count)
+{
+    memory->deallocate(pointer, count * sizeof(T));
+}
+
+template <typename T>
+void polymorphic_allocator<T>::construct(pointer pointer, const T& value)
+{
+    ::new (static_cast<void *>(pointer)) T(value);
+}
+
+template <typename T>
+void polymorphic_allocator<T>::destroy(pointer pointer)
+{
+    pointer->~T();
+}
+
+template <typename T>
+typename polymorphic_allocator<T>::size_type
+polymorphic_allocator<T>::max_size() const
+{
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+}
+
+template <typename T>
+memory_resource *polymorphic_allocator<T>::resource() const
+{
+    return memory;
+}
+
+template <typename T, typename U>
+bool operator == (const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs)
+{
+    return (lhs.resource() == rhs.resource()) || lhs.resource()->is_equal(*rhs.resource());
+}
+
+template <typename T, typename U>
+bool operator != (const polymorphic_allocator<T>& lhs, const polymorphic_allocator<U>& rhs)
+{
+    return !(lhs == rhs);
+}
+
+} // namespace protoc
+
+#endif /* PROTOC_IMPL_MEMORY_RESOURCE_IPP */
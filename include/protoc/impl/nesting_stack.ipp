@@ -0,0 +1,155 @@
+#ifndef PROTOC_IMPL_NESTING_STACK_IPP
+#define PROTOC_IMPL_NESTING_STACK_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <new>
+#include <protoc/exceptions.hpp>
+
+namespace protoc
+{
+
+template <typename T, std::size_t N>
+const typename nesting_stack<T, N>::size_type nesting_stack<T, N>::default_max_depth;
+
+template <typename T, std::size_t N>
+nesting_stack<T, N>::nesting_stack(size_type max_depth)
+    : count(0),
+      limit(max_depth)
+{
+}
+
+template <typename T, std::size_t N>
+nesting_stack<T, N>::nesting_stack(const nesting_stack& other)
+    : count(0),
+      limit(other.limit),
+      overflow(other.overflow)
+{
+    const size_type amount = (other.count < N) ? other.count : N;
+    for (; count < amount; ++count)
+    {
+        new (local() + count) value_type(other.local()[count]);
+    }
+    count = other.count;
+}
+
+template <typename T, std::size_t N>
+nesting_stack<T, N>::~nesting_stack()
+{
+    clear();
+}
+
+template <typename T, std::size_t N>
+bool nesting_stack<T, N>::empty() const
+{
+    return (count == 0);
+}
+
+template <typename T, std::size_t N>
+typename nesting_stack<T, N>::size_type nesting_stack<T, N>::size() const
+{
+    return count;
+}
+
+template <typename T, std::size_t N>
+typename nesting_stack<T, N>::size_type nesting_stack<T, N>::max_depth() const
+{
+    return limit;
+}
+
+template <typename T, std::size_t N>
+void nesting_stack<T, N>::max_depth(size_type depth)
+{
+    limit = depth;
+}
+
+template <typename T, std::size_t N>
+typename nesting_stack<T, N>::reference nesting_stack<T, N>::top()
+{
+    assert(count > 0);
+    return (count > N) ? overflow.back() : local()[count - 1];
+}
+
+template <typename T, std::size_t N>
+typename nesting_stack<T, N>::const_reference nesting_stack<T, N>::top() const
+{
+    assert(count > 0);
+    return (count > N) ? overflow.back() : local()[count - 1];
+}
+
+template <typename T, std::size_t N>
+void nesting_stack<T, N>::push(const value_type& value)
+{
+    if (count >= limit)
+        throw invalid_scope("maximum nesting depth exceeded");
+
+    if (count < N)
+    {
+        new (local() + count) value_type(value);
+    }
+    else
+    {
+        overflow.push_back(value);
+    }
+    ++count;
+}
+
+template <typename T, std::size_t N>
+void nesting_stack<T, N>::pop()
+{
+    assert(count > 0);
+    --count;
+    if (count >= N)
+    {
+        overflow.pop_back();
+    }
+    else
+    {
+        local()[count].~value_type();
+    }
+}
+
+template <typename T, std::size_t N>
+void nesting_stack<T, N>::clear()
+{
+    overflow.clear();
+    if (count > N)
+        count = N;
+    while (count > 0)
+    {
+        --count;
+        local()[count].~value_type();
+    }
+}
+
+template <typename T, std::size_t N>
+typename nesting_stack<T, N>::value_type *nesting_stack<T, N>::local()
+{
+    return static_cast<value_type *>(static_cast<void *>(&storage));
+}
+
+template <typename T, std::size_t N>
+const typename nesting_stack<T, N>::value_type *nesting_stack<T, N>::local() const
+{
+    return static_cast<const value_type *>(static_cast<const void *>(&storage));
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_NESTING_STACK_IPP
@@ -0,0 +1,154 @@
+#ifndef PROTOC_IMPL_OUTPUT_IPP
+#define PROTOC_IMPL_OUTPUT_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+
+namespace protoc
+{
+
+template<typename Value>
+output<Value>::output()
+    : threshold(size_type(-1))
+{
+    clear_window();
+}
+
+template<typename Value>
+inline typename output<Value>::value_type *output<Value>::reserve(size_type size)
+{
+    if (size_type(window.last - window.first) >= size)
+    {
+        return window.first;
+    }
+    return (overflow(size)) ? window.first : 0;
+}
+
+template<typename Value>
+inline void output<Value>::commit(value_type *position)
+{
+    assert(position >= window.first);
+    assert(position <= window.last);
+
+    window.first = position;
+    if (window.eager)
+    {
+        sync();
+    }
+}
+
+template<typename Value>
+inline bool output<Value>::by_reference(size_type size) const
+{
+    return (size >= threshold);
+}
+
+template<typename Value>
+inline typename output<Value>::size_type output<Value>::reference_threshold() const
+{
+    return threshold;
+}
+
+template<typename Value>
+void output<Value>::reference(const value_type *values, size_type size)
+{
+    if (grow(size))
+    {
+        write(values, size);
+    }
+}
+
+template<typename Value>
+bool output<Value>::rewritable() const
+{
+    return false;
+}
+
+template<typename Value>
+typename output<Value>::size_type output<Value>::position() const
+{
+    return 0;
+}
+
+template<typename Value>
+typename output<Value>::value_type *output<Value>::rewrite(size_type)
+{
+    return 0;
+}
+
+template<typename Value>
+void output<Value>::truncate(size_type)
+{
+    assert(false);
+}
+
+template<typename Value>
+bool output<Value>::overflow(size_type size)
+{
+    // Fallback for outputs without a window of their own
+    if (!grow(size))
+    {
+        return false;
+    }
+    if (scratch.size() < size)
+    {
+        scratch.resize(size);
+    }
+    set_window(&scratch[0], &scratch[0] + scratch.size(), true);
+    return true;
+}
+
+template<typename Value>
+void output<Value>::sync()
+{
+    assert(!scratch.empty());
+
+    const size_type size = window.first - &scratch[0];
+    clear_window();
+    if (size > 0)
+    {
+        write(&scratch[0], size);
+    }
+}
+
+template<typename Value>
+void output<Value>::set_window(value_type *first,
+                               value_type *last,
+                               bool eager)
+{
+    window.first = first;
+    window.last = last;
+    window.eager = eager;
+}
+
+template<typename Value>
+void output<Value>::clear_window()
+{
+    set_window(0, 0);
+}
+
+template<typename Value>
+void output<Value>::set_reference_threshold(size_type size)
+{
+    threshold = size;
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_OUTPUT_IPP
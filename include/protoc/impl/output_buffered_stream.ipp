@@ -0,0 +1,136 @@
+#ifndef PROTOC_IMPL_OUTPUT_BUFFERED_STREAM_IPP
+#define PROTOC_IMPL_OUTPUT_BUFFERED_STREAM_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+namespace protoc
+{
+
+template<typename Value>
+const typename output_buffered_stream<Value>::size_type output_buffered_stream<Value>::default_block_size;
+
+template<typename Value>
+output_buffered_stream<Value>::output_buffered_stream(std::ostream& stream,
+                                                      size_type block_size)
+    : stream(stream),
+      block(std::max(block_size, size_type(1)))
+{
+    reset();
+}
+
+template<typename Value>
+output_buffered_stream<Value>::output_buffered_stream(const output_buffered_stream& other)
+    : output<Value>(),
+      stream(other.stream),
+      block(other.block.size())
+{
+    // Buffered data stays with the original
+    reset();
+}
+
+template<typename Value>
+output_buffered_stream<Value>::~output_buffered_stream()
+{
+    try
+    {
+        flush();
+    }
+    catch (...)
+    {
+        // Stream exceptions must not escape the destructor
+    }
+}
+
+template<typename Value>
+bool output_buffered_stream<Value>::flush()
+{
+    const size_type size = pending();
+    reset();
+    if (size > 0)
+    {
+        stream.write(reinterpret_cast<const char *>(&block[0]),
+                     size * sizeof(value_type));
+    }
+    return stream.good();
+}
+
+template<typename Value>
+typename output_buffered_stream<Value>::size_type output_buffered_stream<Value>::pending() const
+{
+    return this->window.first - &block[0];
+}
+
+template<typename Value>
+void output_buffered_stream<Value>::reset()
+{
+    this->set_window(&block[0], &block[0] + block.size());
+}
+
+template<typename Value>
+bool output_buffered_stream<Value>::grow(size_type)
+{
+    return stream.good();
+}
+
+template<typename Value>
+void output_buffered_stream<Value>::write(value_type value)
+{
+    if ((this->window.first == this->window.last) && !flush())
+        return;
+    *this->window.first = value;
+    ++this->window.first;
+}
+
+template<typename Value>
+void output_buffered_stream<Value>::write(const value_type *values,
+                                          size_type size)
+{
+    if (size > size_type(this->window.last - this->window.first))
+    {
+        if (!flush())
+            return;
+        if (size >= block.size())
+        {
+            // Bypass the block for large payloads
+            stream.write(reinterpret_cast<const char *>(values),
+                         size * sizeof(value_type));
+            return;
+        }
+    }
+    this->window.first = std::copy(values, values + size, this->window.first);
+}
+
+template<typename Value>
+bool output_buffered_stream<Value>::overflow(size_type size)
+{
+    if (!flush())
+        return false;
+    if (size > block.size())
+    {
+        // The window must be contiguous, so enlarge the block
+        block.resize(size);
+        reset();
+    }
+    return true;
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_OUTPUT_BUFFERED_STREAM_IPP
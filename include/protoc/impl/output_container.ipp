@@ -19,6 +19,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
 #include <cassert>
 
 namespace protoc
@@ -30,9 +31,13 @@ bool output_container<Value, Container>::grow(size_type delta)
     const size_type size = buffer.size() + delta;
     if (size > buffer.capacity())
     {
-        if (size > buffer.max_size())
+        if (delta > buffer.max_size() - buffer.size())
             return false;
-        buffer.reserve(size);
+        // Geometric growth to keep repeated appends linear
+        const size_type doubled = (buffer.capacity() > buffer.max_size() / 2)
+            ? buffer.max_size()
+            : 2 * buffer.capacity();
+        buffer.reserve(std::max(size, doubled));
     }
     return true;
 }
@@ -53,6 +58,57 @@ void output_container<Value, Container>::write(const value_type *values,
     }
 }
 
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+bool output_container<Value, Container>::overflow(size_type size)
+{
+    if (!grow(size))
+        return false;
+
+    const size_type used = buffer.size();
+    buffer.resize(used + size);
+    this->set_window(&buffer[0] + used, &buffer[0] + buffer.size(), true);
+    return true;
+}
+
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+void output_container<Value, Container>::sync()
+{
+    // Trim the container to what has been committed
+    buffer.resize(this->window.first - &buffer[0]);
+    this->clear_window();
+}
+
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+bool output_container<Value, Container>::rewritable() const
+{
+    return true;
+}
+
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+typename output_container<Value, Container>::size_type output_container<Value, Container>::position() const
+{
+    // Commits are synchronized eagerly, so an open window only covers
+    // values that have not been committed yet
+    return (this->window.first == 0)
+        ? buffer.size()
+        : size_type(this->window.first - &buffer[0]);
+}
+
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+typename output_container<Value, Container>::value_type *output_container<Value, Container>::rewrite(size_type offset)
+{
+    assert(offset <= position());
+    return buffer.empty() ? 0 : &buffer[0] + offset;
+}
+
+template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
+void output_container<Value, Container>::truncate(size_type offset)
+{
+    assert(offset <= position());
+    buffer.resize(offset);
+    this->clear_window();
+}
+
 } // namespace protoc
 
 #endif // PROTOC_IMPL_OUTPUT_CONTAINER_IPP
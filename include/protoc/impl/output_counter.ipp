@@ -0,0 +1,82 @@
+#ifndef PROTOC_IMPL_OUTPUT_COUNTER_IPP
+#define PROTOC_IMPL_OUTPUT_COUNTER_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+namespace protoc
+{
+
+template<typename Value>
+output_counter<Value>::output_counter()
+    : counted(0)
+{
+}
+
+template<typename Value>
+typename output_counter<Value>::size_type output_counter<Value>::size() const
+{
+    return scratch.empty() ? counted : counted + (this->window.first - &scratch[0]);
+}
+
+template<typename Value>
+void output_counter<Value>::clear()
+{
+    counted = 0;
+    if (!scratch.empty())
+    {
+        this->set_window(&scratch[0], &scratch[0] + scratch.size());
+    }
+}
+
+template<typename Value>
+bool output_counter<Value>::grow(size_type)
+{
+    return true;
+}
+
+template<typename Value>
+void output_counter<Value>::write(value_type)
+{
+    ++counted;
+}
+
+template <typename Value>
+void output_counter<Value>::write(const value_type *,
+                                  size_type size)
+{
+    counted += size;
+}
+
+template <typename Value>
+bool output_counter<Value>::overflow(size_type needed)
+{
+    // Account for the window and start over at the beginning of it
+    counted = size();
+    if (scratch.size() < needed)
+    {
+        scratch.resize(std::max(needed, size_type(256)));
+    }
+    this->set_window(&scratch[0], &scratch[0] + scratch.size());
+    return true;
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_OUTPUT_COUNTER_IPP
@@ -0,0 +1,147 @@
+#ifndef PROTOC_IMPL_OUTPUT_SEGMENTS_IPP
+#define PROTOC_IMPL_OUTPUT_SEGMENTS_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+
+namespace protoc
+{
+
+template<typename Value>
+output_segments<Value>::output_segments(size_type threshold)
+    : pending(0),
+      referenced(0)
+{
+    this->set_reference_threshold(threshold);
+}
+
+template<typename Value>
+typename output_segments<Value>::size_type output_segments<Value>::used() const
+{
+    return buffer.empty() ? 0 : this->window.first - &buffer[0];
+}
+
+template<typename Value>
+typename output_segments<Value>::size_type output_segments<Value>::size() const
+{
+    return used() + referenced;
+}
+
+template<typename Value>
+void output_segments<Value>::clear()
+{
+    parts.clear();
+    list.clear();
+    pending = 0;
+    referenced = 0;
+    if (!buffer.empty())
+    {
+        this->set_window(&buffer[0], &buffer[0] + buffer.size());
+    }
+}
+
+template<typename Value>
+const std::vector<typename output_segments<Value>::segment>& output_segments<Value>::segments()
+{
+    list.clear();
+    list.reserve(parts.size() + 1);
+    for (typename std::vector<part>::const_iterator it = parts.begin();
+         it != parts.end();
+         ++it)
+    {
+        segment current;
+        current.data = it->external ? it->external : &buffer[it->offset];
+        current.size = it->size;
+        list.push_back(current);
+    }
+    const size_type end = used();
+    if (end > pending)
+    {
+        segment current;
+        current.data = &buffer[pending];
+        current.size = end - pending;
+        list.push_back(current);
+    }
+    return list;
+}
+
+template<typename Value>
+void output_segments<Value>::reference(const value_type *values, size_type size)
+{
+    const size_type end = used();
+    if (end > pending)
+    {
+        part current = { 0, pending, end - pending };
+        parts.push_back(current);
+        pending = end;
+    }
+    part current = { values, 0, size };
+    parts.push_back(current);
+    referenced += size;
+}
+
+template<typename Value>
+bool output_segments<Value>::grow(size_type delta)
+{
+    const size_type end = used();
+    if (delta <= buffer.size() - end)
+        return true;
+
+    if (delta > buffer.max_size() - end)
+        return false;
+    // Geometric growth to keep repeated appends linear
+    const size_type minimum = end + delta;
+    const size_type doubled = (buffer.size() > buffer.max_size() / 2)
+        ? buffer.max_size()
+        : 2 * buffer.size();
+    buffer.resize(std::max(minimum, doubled));
+    this->set_window(&buffer[0] + end, &buffer[0] + buffer.size());
+    return true;
+}
+
+template<typename Value>
+void output_segments<Value>::write(value_type value)
+{
+    if (grow(1))
+    {
+        *this->window.first = value;
+        ++this->window.first;
+    }
+}
+
+template <typename Value>
+void output_segments<Value>::write(const value_type *values,
+                                   size_type size)
+{
+    if (grow(size))
+    {
+        std::copy(values, values + size, this->window.first);
+        this->window.first += size;
+    }
+}
+
+template <typename Value>
+bool output_segments<Value>::overflow(size_type size)
+{
+    return grow(size);
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_OUTPUT_SEGMENTS_IPP
@@ -19,6 +19,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 
+#include <algorithm>
 #include <cassert>
 
 namespace protoc
@@ -33,13 +34,13 @@ typename output_vector<Value>::const_iterator output_vector<Value>::begin() cons
 template<typename Value>
 typename output_vector<Value>::const_iterator output_vector<Value>::end() const
 {
-    return buffer.end();
+    return buffer.begin() + size();
 }
 
 template<typename Value>
 typename output_vector<Value>::size_type output_vector<Value>::size() const
 {
-    return buffer.size();
+    return buffer.empty() ? 0 : this->window.first - &buffer[0];
 }
 
 template<typename Value>
@@ -48,30 +49,51 @@ typename output_vector<Value>::size_type output_vector<Value>::capacity() const
     return buffer.capacity();
 }
 
+template<typename Value>
+void output_vector<Value>::reserve_capacity(size_type total)
+{
+    const size_type used = size();
+    if (total > buffer.size())
+    {
+        buffer.resize(total);
+        this->set_window(&buffer[0] + used, &buffer[0] + buffer.size());
+    }
+}
+
 template<typename Value>
 typename output_vector<Value>::const_reference output_vector<Value>::operator [] (size_type ix) const
 {
-    assert(ix < buffer.size());
+    assert(ix < size());
     return buffer[ix];
 }
 
 template<typename Value>
 bool output_vector<Value>::grow(size_type delta)
 {
-    const size_type size = buffer.size() + delta;
-    if (size > buffer.capacity())
-    {
-        if (size > buffer.max_size())
-            return false;
-        buffer.reserve(size);
-    }
+    const size_type used = size();
+    if (delta <= buffer.size() - used)
+        return true;
+
+    if (delta > buffer.max_size() - used)
+        return false;
+    // Geometric growth to keep repeated appends linear
+    const size_type minimum = used + delta;
+    const size_type doubled = (buffer.size() > buffer.max_size() / 2)
+        ? buffer.max_size()
+        : 2 * buffer.size();
+    buffer.resize(std::max(minimum, doubled));
+    this->set_window(&buffer[0] + used, &buffer[0] + buffer.size());
     return true;
 }
 
 template<typename Value>
 void output_vector<Value>::write(value_type value)
 {
-    buffer.push_back(value);
+    if (grow(1))
+    {
+        *this->window.first = value;
+        ++this->window.first;
+    }
 }
 
 template <typename Value>
@@ -80,7 +102,43 @@ void output_vector<Value>::write(const value_type *values,
 {
     if (grow(size))
     {
-        buffer.insert(buffer.end(), values, values + size);
+        std::copy(values, values + size, this->window.first);
+        this->window.first += size;
+    }
+}
+
+template <typename Value>
+bool output_vector<Value>::overflow(size_type size)
+{
+    return grow(size);
+}
+
+template <typename Value>
+bool output_vector<Value>::rewritable() const
+{
+    return true;
+}
+
+template <typename Value>
+typename output_vector<Value>::size_type output_vector<Value>::position() const
+{
+    return size();
+}
+
+template <typename Value>
+typename output_vector<Value>::value_type *output_vector<Value>::rewrite(size_type offset)
+{
+    assert(offset <= size());
+    return buffer.empty() ? 0 : &buffer[0] + offset;
+}
+
+template <typename Value>
+void output_vector<Value>::truncate(size_type offset)
+{
+    assert(offset <= size());
+    if (!buffer.empty())
+    {
+        this->set_window(&buffer[0] + offset, &buffer[0] + buffer.size());
     }
 }
 
@@ -0,0 +1,252 @@
+#ifndef PROTOC_IMPL_PARALLEL_IPP
+#define PROTOC_IMPL_PARALLEL_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <exception>
+#include <stdexcept>
+#include <boost/bind/bind.hpp>
+#include <boost/static_assert.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/type_traits/is_same.hpp>
+#include <protoc/exceptions.hpp>
+
+namespace protoc
+{
+namespace detail
+{
+
+template <typename Record, typename Result, typename Function>
+parallel_decoder<Record, Result, Function>::parallel_decoder(const std::vector<Record>& records,
+                                                             std::vector<Result>& results,
+                                                             const Function& function,
+                                                             std::size_t shards)
+    : records(records),
+      results(results),
+      function(function),
+      next(0)
+{
+    std::size_t total = 0;
+    for (typename std::vector<Record>::const_iterator it = records.begin();
+         it != records.end();
+         ++it)
+    {
+        total += it->size();
+    }
+    const std::size_t target = total / shards + 1;
+
+    // Shards end at the first record that fills them up to the target size
+    boundaries.push_back(0);
+    std::size_t size = 0;
+    for (std::size_t index = 0; index < records.size(); ++index)
+    {
+        size += records[index].size();
+        if (size >= target)
+        {
+            boundaries.push_back(index + 1);
+            size = 0;
+        }
+    }
+    if (boundaries.back() != records.size())
+    {
+        boundaries.push_back(records.size());
+    }
+}
+
+template <typename Record, typename Result, typename Function>
+void parallel_decoder<Record, Result, Function>::run(std::size_t threads)
+{
+    if (threads > boundaries.size() - 1)
+    {
+        threads = boundaries.size() - 1;
+    }
+
+    // The calling thread is one of the workers
+    boost::thread_group workers;
+    try
+    {
+        for (std::size_t i = 1; i < threads; ++i)
+        {
+            workers.create_thread(boost::bind(&parallel_decoder::work, this));
+        }
+    }
+    catch (...)
+    {
+        // The workers already started must not outlive the decoder
+        stop();
+        workers.join_all();
+        throw;
+    }
+    work();
+    workers.join_all();
+
+    rethrow();
+}
+
+template <typename Record, typename Result, typename Function>
+void parallel_decoder<Record, Result, Function>::work()
+{
+    Function decode(function);
+    std::size_t first;
+    std::size_t last;
+    while (next_shard(first, last))
+    {
+        for (std::size_t index = first; index < last; ++index)
+        {
+            try
+            {
+                results[index] = decode(records[index]);
+            }
+            catch (const protoc::unexpected_token& ex)
+            {
+                fail(index, failure::unexpected_token, ex.what());
+                return;
+            }
+            catch (const protoc::invalid_value& ex)
+            {
+                fail(index, failure::invalid_value, ex.what());
+                return;
+            }
+            catch (const protoc::invalid_scope& ex)
+            {
+                fail(index, failure::invalid_scope, ex.what());
+                return;
+            }
+            catch (const std::exception& ex)
+            {
+                fail(index, failure::other, ex.what());
+                return;
+            }
+            catch (...)
+            {
+                fail(index, failure::other, "unknown exception");
+                return;
+            }
+        }
+    }
+}
+
+template <typename Record, typename Result, typename Function>
+bool parallel_decoder<Record, Result, Function>::next_shard(std::size_t& first,
+                                                           std::size_t& last)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    // Shards are handed out in order, so every shard before a failure has
+    // already been taken and will be completed by its worker
+    if ((error.kind != failure::none) || (next + 1 >= boundaries.size()))
+    {
+        return false;
+    }
+    first = boundaries[next];
+    last = boundaries[next + 1];
+    ++next;
+    return true;
+}
+
+template <typename Record, typename Result, typename Function>
+void parallel_decoder<Record, Result, Function>::stop()
+{
+    boost::mutex::scoped_lock lock(mutex);
+    // No further shards are handed out
+    next = boundaries.size();
+}
+
+template <typename Record, typename Result, typename Function>
+void parallel_decoder<Record, Result, Function>::fail(std::size_t index,
+                                                     int kind,
+                                                     const std::string& message)
+{
+    boost::mutex::scoped_lock lock(mutex);
+    if ((error.kind == failure::none) || (index < error.index))
+    {
+        error.kind = kind;
+        error.index = index;
+        error.message = message;
+    }
+}
+
+template <typename Record, typename Result, typename Function>
+void parallel_decoder<Record, Result, Function>::rethrow() const
+{
+    switch (error.kind)
+    {
+    case failure::none:
+        break;
+
+    case failure::unexpected_token:
+        throw protoc::unexpected_token(error.message);
+
+    case failure::invalid_value:
+        throw protoc::invalid_value(error.message);
+
+    case failure::invalid_scope:
+        throw protoc::invalid_scope(error.message);
+
+    default:
+        throw std::runtime_error(error.message);
+    }
+}
+
+template <typename Record, typename Result, typename Function>
+parallel_decoder<Record, Result, Function>::failure::failure()
+    : kind(none),
+      index(0)
+{
+}
+
+} // namespace detail
+
+template <typename Record, typename Result, typename Function>
+void decode_parallel(const std::vector<Record>& records,
+                     std::vector<Result>& results,
+                     Function function,
+                     std::size_t threads)
+{
+    // Workers assign neighbouring elements concurrently, which is a data
+    // race for the packed elements of std::vector<bool>
+    BOOST_STATIC_ASSERT_MSG((!boost::is_same<Result, bool>::value),
+                            "decode_parallel() cannot store results in std::vector<bool>");
+
+    results.clear();
+    results.resize(records.size());
+    if (records.empty())
+    {
+        return;
+    }
+
+    if (threads == 0)
+    {
+        threads = boost::thread::hardware_concurrency();
+        if (threads == 0)
+        {
+            threads = 1;
+        }
+    }
+
+    // Several shards per thread keep the workers busy when records differ
+    // in decoding cost
+    detail::parallel_decoder<Record, Result, Function> decoder(records,
+                                                               results,
+                                                               function,
+                                                               4 * threads);
+    decoder.run(threads);
+}
+
+} // namespace protoc
+
+#endif /* PROTOC_IMPL_PARALLEL_IPP */
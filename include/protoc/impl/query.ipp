@@ -0,0 +1,344 @@
+#ifndef PROTOC_IMPL_QUERY_IPP
+#define PROTOC_IMPL_QUERY_IPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <cstring> // std::strlen
+#include <protoc/exceptions.hpp>
+
+namespace protoc
+{
+
+//-----------------------------------------------------------------------------
+// path
+//-----------------------------------------------------------------------------
+
+inline path::path()
+{
+}
+
+inline path::path(const char *pointer)
+{
+    compile(pointer, pointer + std::strlen(pointer));
+}
+
+inline path::path(const std::string& pointer)
+{
+    compile(pointer.data(), pointer.data() + pointer.size());
+}
+
+inline path::size_type path::size() const
+{
+    return segments.size();
+}
+
+inline bool path::empty() const
+{
+    return segments.empty();
+}
+
+inline const std::string& path::key(size_type n) const
+{
+    assert(n < segments.size());
+    return segments[n].key;
+}
+
+inline path::size_type path::index(size_type n) const
+{
+    assert(n < segments.size());
+    return segments[n].index;
+}
+
+inline void path::compile(const char *first, const char *last)
+{
+    if (first == last)
+        return;
+    if (*first != '/')
+        throw invalid_value("path must start with '/'");
+
+    while (first != last)
+    {
+        ++first; // Skip '/'
+        segment current;
+        const char *end = std::find(first, last, '/');
+        for (; first != end; ++first)
+        {
+            if (*first == '~')
+            {
+                ++first;
+                if (first == end)
+                    throw invalid_value("incomplete escape in path");
+                switch (*first)
+                {
+                case '0':
+                    current.key += '~';
+                    break;
+                case '1':
+                    current.key += '/';
+                    break;
+                default:
+                    throw invalid_value("invalid escape in path");
+                }
+            }
+            else
+            {
+                current.key += *first;
+            }
+        }
+
+        // Array indices are decimal numbers without leading zeros
+        current.index = npos;
+        const std::string& key = current.key;
+        if (!key.empty() && (key.size() == 1 || key[0] != '0'))
+        {
+            size_type index = 0;
+            std::string::const_iterator it = key.begin();
+            for (; it != key.end(); ++it)
+            {
+                if ((*it < '0') || (*it > '9'))
+                    break;
+                const size_type digit = *it - '0';
+                if (index > (npos - 1 - digit) / 10)
+                    break;
+                index = 10 * index + digit;
+            }
+            if (it == key.end())
+            {
+                current.index = index;
+            }
+        }
+        segments.push_back(current);
+    }
+}
+
+namespace detail
+{
+
+//-----------------------------------------------------------------------------
+// query_engine
+//-----------------------------------------------------------------------------
+
+template <typename Reader, typename Visitor>
+class query_engine
+{
+public:
+    typedef std::vector<std::size_t> active_type;
+
+    query_engine(Reader& input, const path *paths, std::size_t size, Visitor& visitor)
+        : input(input),
+          paths(paths),
+          found(size, false),
+          pending(size),
+          visitor(visitor)
+    {
+    }
+
+    // Returns the number of paths found
+    std::size_t run()
+    {
+        active_type active(found.size());
+        for (std::size_t i = 0; i < active.size(); ++i)
+        {
+            active[i] = i;
+        }
+        if (!active.empty())
+        {
+            visit(active, 0);
+        }
+        return found.size() - pending;
+    }
+
+private:
+    // Evaluates the active paths against the value at the current position,
+    // whose location is given by the first depth tokens of the paths.
+    // Returns true once all paths have been found.
+    bool visit(const active_type& active, std::size_t depth)
+    {
+        active_type deeper;
+        for (active_type::const_iterator it = active.begin(); it != active.end(); ++it)
+        {
+            if (paths[*it].size() == depth)
+            {
+                found[*it] = true;
+                visitor(*it, input);
+                if (--pending == 0)
+                    return true;
+            }
+            else
+            {
+                deeper.push_back(*it);
+            }
+        }
+        if (deeper.empty())
+        {
+            input.next_sibling();
+            return false;
+        }
+
+        std::size_t count = 0;
+        switch (input.type())
+        {
+        case token::token_map_begin:
+            transcoder_reader_traits<Reader>::container_begin(input, count);
+            return visit_map(deeper, depth);
+
+        case token::token_array_begin:
+            transcoder_reader_traits<Reader>::container_begin(input, count);
+            return visit_array(deeper, depth, token::token_array_end);
+
+        case token::token_record_begin:
+            input.next();
+            return visit_array(deeper, depth, token::token_record_end);
+
+        default:
+            // Paths continue below a scalar, so they cannot be found
+            input.next_sibling();
+            return false;
+        }
+    }
+
+    bool visit_map(const active_type& active, std::size_t depth)
+    {
+        active_type matching;
+        while (input.type() != token::token_map_end)
+        {
+            expect_more();
+            matching.clear();
+            for (active_type::const_iterator it = active.begin(); it != active.end(); ++it)
+            {
+                if (!found[*it] && match_key(paths[*it], depth))
+                {
+                    matching.push_back(*it);
+                }
+            }
+            input.next(); // Skip key
+            expect_more();
+            if (matching.empty())
+            {
+                input.next_sibling();
+            }
+            else if (visit(matching, depth + 1))
+            {
+                return true;
+            }
+        }
+        input.next();
+        return false;
+    }
+
+    bool visit_array(const active_type& active, std::size_t depth, token::value end)
+    {
+        active_type matching;
+        for (std::size_t index = 0; input.type() != end; ++index)
+        {
+            expect_more();
+            matching.clear();
+            for (active_type::const_iterator it = active.begin(); it != active.end(); ++it)
+            {
+                if (!found[*it] && (paths[*it].index(depth) == index))
+                {
+                    matching.push_back(*it);
+                }
+            }
+            if (matching.empty())
+            {
+                input.next_sibling();
+            }
+            else if (visit(matching, depth + 1))
+            {
+                return true;
+            }
+        }
+        input.next();
+        return false;
+    }
+
+    // Compares the map key at the current position with token depth
+    bool match_key(const path& where, std::size_t depth) const
+    {
+        switch (input.type())
+        {
+        case token::token_string:
+            if (input.has_escapes())
+            {
+                return input.get_string() == where.key(depth);
+            }
+            else
+            {
+                typename Reader::string_view_type view = input.get_string_view();
+                const std::string& key = where.key(depth);
+                return (std::size_t(view.size()) == key.size())
+                    && std::equal(view.begin(), view.end(), key.begin());
+            }
+
+        case token::token_integer:
+            // Binary formats allow integer keys
+            return (where.index(depth) != path::npos)
+                && (input.get_long_long() >= 0)
+                && (static_cast<unsigned long long>(input.get_long_long()) == where.index(depth));
+
+        default:
+            return false;
+        }
+    }
+
+    void expect_more() const
+    {
+        if (input.type() == token::token_eof)
+            throw unexpected_token("unexpected end of input");
+    }
+
+private:
+    Reader& input;
+    const path *paths;
+    std::vector<bool> found;
+    std::size_t pending;
+    Visitor& visitor;
+};
+
+// Visitor that leaves the reader at the value
+struct query_ignore
+{
+    template <typename Reader>
+    void operator () (std::size_t, Reader&) const {}
+};
+
+} // namespace detail
+
+template <typename Reader>
+bool query(Reader& input, const path& where)
+{
+    detail::query_ignore visitor;
+    detail::query_engine<Reader, detail::query_ignore> engine(input, &where, 1, visitor);
+    return (engine.run() == 1);
+}
+
+template <typename Reader, typename Visitor>
+std::size_t query(Reader& input, const std::vector<path>& paths, Visitor& visitor)
+{
+    if (paths.empty())
+        return 0;
+    detail::query_engine<Reader, Visitor> engine(input, &paths[0], paths.size(), visitor);
+    return engine.run();
+}
+
+} // namespace protoc
+
+#endif // PROTOC_IMPL_QUERY_IPP
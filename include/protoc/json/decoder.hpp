@@ -32,17 +32,65 @@ namespace detail
 
 class decoder
 {
-    typedef protoc::input_range<char> input_range;
-
 public:
+    typedef protoc::input_range<char> input_range;
     typedef input_range::value_type value_type;
 
     decoder(const char *begin, const char *end);
 
+    // Decodes new input as if the decoder had been constructed with it
+    void reset(const char *begin, const char *end);
+
     token type() const;
     void next();
+    // Input after the current token
+    const input_range& remaining() const;
+    // More input could change the current token, because the input ends
+    // before or inside it, or because it is a number, or a number out of
+    // range, at the end of the input. Used by chunk_decoder to decide when
+    // to wait for more data.
+    bool is_truncated() const;
+
+    // Finds the end of a token that is split across chunks, so that
+    // chunk_decoder looks at each value only once. scan() continues with
+    // the next piece of input and returns how many of its values belong to
+    // the token. done() becomes true when the end has been found. A number
+    // only ends at the value after it, which is therefore included.
+    class token_scanner
+    {
+    public:
+        token_scanner();
+
+        std::size_t scan(input_range::const_iterator first,
+                         input_range::const_iterator last);
+        bool done() const;
+
+    private:
+        enum
+        {
+            state_leading,
+            state_string,
+            state_escape,
+            state_number,
+            state_keyword,
+            state_done
+        } state;
+    };
+    // Skips the content of the array or object that the current token opens
+    // and makes the matching end token current. The skipped content is not
+    // tokenized, so it is only checked for balanced brackets and strings.
+    void skip_container();
 
     std::string get_string() const;
+    // Appends the unescaped string to result
+    void get_string(std::string& result) const;
+    // Writes the unescaped string into [first, last) and returns the end of
+    // the written string, or null if the buffer is too small. A buffer of
+    // get_string_view().size() characters is always large enough.
+    char *get_string(char *first, char *last) const;
+    // Raw string without the surrounding quotes and with escapes intact
+    const input_range& get_string_view() const;
+    bool has_escapes() const;
     protoc::int64_t get_integer() const;
     protoc::float64_t get_float() const;
 
@@ -66,6 +114,13 @@ private:
     {
         token type;
         input_range range;
+        bool escaped;
+        // Converted during the scan of token_integer and token_float
+        union
+        {
+            protoc::int64_t integer;
+            protoc::float64_t floating;
+        } number;
     } current;
 };
 
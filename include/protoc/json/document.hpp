@@ -0,0 +1,197 @@
+#ifndef PROTOC_JSON_DOCUMENT_HPP
+#define PROTOC_JSON_DOCUMENT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+#include <protoc/types.hpp>
+#include <protoc/token.hpp>
+#include <protoc/parser.hpp>
+#include <protoc/nesting_stack.hpp>
+#include <protoc/json/token.hpp>
+
+namespace protoc
+{
+namespace json
+{
+
+// Lazily parsed JSON document
+//
+// The constructor makes a single structural pass over the buffer. It checks
+// the nesting, separators, literals and number syntax, and records every
+// value on a tape with its position in the buffer, and for arrays and
+// objects the number of elements and the extent of their content on the
+// tape. Numbers and strings are not converted.
+//
+// The values are then navigated through document::value, which looks up
+// object members and array elements by skipping whole subtrees on the tape.
+// Numbers and strings are decoded with the JSON decoder when they are
+// requested, so out-of-range numbers and malformed escape sequences or UTF-8
+// are only reported then, with protoc::invalid_value.
+//
+// Documents are limited to 4 GiB, so that the tape can use 32-bit lengths.
+//
+//   protoc::json::document doc(input.data(), input.data() + input.size());
+//   protoc::int64_t id = doc.root()["id"].get_integer();
+//
+// The document refers to the buffer, which must outlive it.
+class document
+{
+public:
+    typedef std::size_t size_type;
+    class value;
+
+    // Malformed structure throws protoc::unexpected_token. Documents larger
+    // than 4 GiB throw protoc::invalid_value.
+    document(const char *begin, const char *end);
+
+    value root() const;
+    // Number of values on the tape, including object keys
+    size_type size() const;
+
+private:
+    friend class value;
+
+    struct entry
+    {
+        entry(detail::token type, size_type offset);
+
+        detail::token type() const;
+        bool escaped() const;
+        size_type offset() const;
+        void set_escaped();
+
+        // Position of the value in the buffer in the upper bits, and the
+        // token type and escape flag in the lowest byte
+        protoc::uint64_t position;
+        // Length of the value in the buffer. Strings exclude the quotes, and
+        // containers include the brackets.
+        protoc::uint32_t length;
+        // Number of entries of the content of a container
+        protoc::uint32_t span;
+        // Number of elements of an array, or members of an object
+        protoc::uint32_t count;
+    };
+
+    typedef protoc::nesting_stack<size_type> stack_type;
+
+    void scan();
+    const char *scan_value(const char *, stack_type&);
+    const char *scan_string(const char *);
+    const char *scan_close(const char *, detail::token, stack_type&);
+    void push(detail::token, const char *);
+
+private:
+    const char *begin;
+    const char *end;
+    std::vector<entry> tape;
+};
+
+class document::value
+{
+public:
+    class const_iterator;
+
+    // Placeholder for find()
+    value();
+
+    protoc::token::value type() const;
+    bool is_null() const;
+
+    // Number of elements of an array, or members of an object
+    size_type size() const;
+
+    // Array element. Throws protoc::invalid_value if out of range. The
+    // preceding elements are skipped on the tape, so the lookup is linear in
+    // the index. Use begin() and end() to visit all elements.
+    value operator [] (size_type index) const;
+    // Avoids ambiguity between index 0 and a null key
+    value operator [] (int index) const;
+    // Object member. Throws protoc::invalid_value if not found.
+    value operator [] (const std::string& key) const;
+    value operator [] (const char *key) const;
+    // Returns false if the object has no member with the key
+    bool find(const std::string& key, value& result) const;
+
+    // Elements of an array, or member values of an object
+    const_iterator begin() const;
+    const_iterator end() const;
+
+    bool get_bool() const;
+    protoc::int64_t get_integer() const;
+    // Also accepts integers
+    protoc::float64_t get_double() const;
+    // Strings are validated by the decoder, and malformed escape sequences
+    // or UTF-8 throw protoc::invalid_value
+    std::string get_string() const;
+    // Raw string without the quotes. If has_escapes() is true, the view
+    // contains escape sequences and get_string() must be used instead.
+    protoc::string_view get_string_view() const;
+    bool has_escapes() const;
+    // Text of the value as it appears in the buffer
+    protoc::string_view get_range() const;
+
+private:
+    friend class document;
+    friend class const_iterator;
+
+    value(const document *, size_type);
+
+    const entry& current() const;
+    void expect(detail::token, const char *) const;
+    size_type next(size_type) const;
+    bool key_equal(size_type, const char *, size_type) const;
+    bool find(const char *, size_type, value&) const;
+
+private:
+    const document *owner;
+    size_type index;
+};
+
+class document::value::const_iterator
+{
+public:
+    const_iterator();
+
+    value operator * () const;
+    const_iterator& operator ++ ();
+    const_iterator operator ++ (int);
+    bool operator == (const const_iterator&) const;
+    bool operator != (const const_iterator&) const;
+
+    // Key of the current member if iterating over an object
+    std::string key() const;
+
+private:
+    friend class value;
+
+    const_iterator(const document *, size_type, bool);
+
+private:
+    const document *owner;
+    // Tape index of the current element, or of the key of the current member
+    size_type index;
+    bool members;
+};
+
+} // namespace json
+} // namespace protoc
+
+#endif /* PROTOC_JSON_DOCUMENT_HPP */
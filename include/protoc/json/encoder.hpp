@@ -44,6 +44,7 @@ public:
     std::size_t put(protoc::float64_t);
     std::size_t put(const char *);
     std::size_t put(const std::string&);
+    std::size_t put(const char *, std::size_t);
 
     std::size_t put_record_begin();
     std::size_t put_record_end();
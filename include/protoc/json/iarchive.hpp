@@ -18,6 +18,7 @@
 #include <boost/archive/detail/common_iarchive.hpp>
 #include <boost/archive/detail/register_archive.hpp>
 #include <protoc/types.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/json/reader.hpp>
 
 namespace protoc
@@ -32,8 +33,16 @@ class iarchive
 
 public:
     iarchive(const json::reader&);
+    iarchive(const json::reader&, protoc::memory_resource&);
     template <typename Iterator>
     iarchive(Iterator begin, Iterator end);
+    // Allocator-aware values created during loading, such as strings and
+    // containers using protoc::polymorphic_allocator, obtain their memory
+    // from the resource.
+    template <typename Iterator>
+    iarchive(Iterator begin, Iterator end, protoc::memory_resource&);
+    explicit iarchive(const protoc::mapped_file&);
+    iarchive(const protoc::mapped_file&, protoc::memory_resource&);
 
     template<typename value_type>
     void load_override(value_type& data, long /*version*/)
@@ -48,6 +57,8 @@ public:
     void load(float&);
     void load(double&);
     void load(std::string&);
+    template <typename Traits, typename Allocator>
+    void load(std::basic_string<char, Traits, Allocator>&);
 
     void load_record_begin();
     void load_record_end();
@@ -72,8 +83,11 @@ public:
     void load(boost::archive::tracking_type) {}
     void load(boost::archive::class_name_type&) {}
 
+    protoc::memory_resource& resource() const;
+
 private:
     json::reader reader;
+    protoc::memory_resource *memory;
 };
 
 } // namespace json
@@ -91,13 +105,43 @@ namespace json
 {
 
 inline iarchive::iarchive(const json::reader& reader)
-    : reader(reader)
+    : reader(reader),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const json::reader& reader,
+                          protoc::memory_resource& resource)
+    : reader(reader),
+      memory(&resource)
 {
 }
 
 template <typename Iterator>
 inline iarchive::iarchive(Iterator begin, Iterator end)
-    : reader(begin, end)
+    : reader(begin, end),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+template <typename Iterator>
+inline iarchive::iarchive(Iterator begin, Iterator end,
+                          protoc::memory_resource& resource)
+    : reader(begin, end),
+      memory(&resource)
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file)
+    : reader(file),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file,
+                          protoc::memory_resource& resource)
+    : reader(file),
+      memory(&resource)
 {
 }
 
@@ -146,6 +190,23 @@ inline void iarchive::load(std::string& value)
     reader.next();
 }
 
+template <typename Traits, typename Allocator>
+void iarchive::load(std::basic_string<char, Traits, Allocator>& value)
+{
+    // Copy from the input to avoid a temporary std::string
+    if (reader.has_escapes())
+    {
+        const std::string unescaped = reader.get_string();
+        value.assign(unescaped.begin(), unescaped.end());
+    }
+    else
+    {
+        const protoc::reader::string_view_type view = reader.get_string_view();
+        value.assign(view.begin(), view.end());
+    }
+    reader.next();
+}
+
 inline void iarchive::load_record_begin()
 {
     reader.next(protoc::token::token_array_begin);
@@ -193,6 +254,11 @@ inline protoc::token::value iarchive::type() const
     return reader.type();
 }
 
+inline protoc::memory_resource& iarchive::resource() const
+{
+    return *memory;
+}
+
 } // namespace json
 } // namespace protoc
 
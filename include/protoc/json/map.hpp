@@ -18,6 +18,7 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <utility> // std::swap
 #include <protoc/json/serialization.hpp>
 #include <protoc/serialization/map.hpp>
 
@@ -47,6 +48,9 @@ struct save_functor< protoc::json::oarchive, typename std::map<Key, T, Compare,
 template <typename Key, typename T, typename Compare, typename Allocator>
 struct load_functor< protoc::json::iarchive, typename std::map<Key, T, Compare, Allocator> >
 {
+    typedef typename std::map<Key, T, Compare, Allocator>::value_type value_type;
+    typedef typename std::map<Key, T, Compare, Allocator>::iterator iterator;
+
     void operator () (protoc::json::iarchive& ar,
                       std::map<Key, T, Compare, Allocator>& data,
                       const unsigned int version)
@@ -55,9 +59,17 @@ struct load_functor< protoc::json::iarchive, typename std::map<Key, T, Compare,
         while (!ar.at_array_end())
         {
             // We cannot use std::map<Key, T>::value_type because it has a const key
-            std::pair<Key, T> value;
+            std::pair<Key, T> value(construct_functor<Key>()(ar),
+                                    construct_functor<T>()(ar));
             ar.load_override(value, version);
-            data.insert(value);
+            // Only the key is copied. The mapped value is swapped in.
+            std::pair<iterator, bool> where
+                = data.insert(value_type(value.first, construct_functor<T>()(ar)));
+            if (where.second)
+            {
+                using std::swap;
+                swap(where.first->second, value.second);
+            }
         }
         ar.load_array_end();
     }
@@ -92,6 +104,9 @@ struct load_functor< protoc::json::iarchive,
                      typename std::map<std::basic_string<CharT, Traits, StringAllocator>, T, Compare, MapAllocator> >
 {
     typedef std::basic_string<CharT, Traits, StringAllocator> key_type;
+    typedef typename std::map<key_type, T, Compare, MapAllocator>::value_type value_type;
+    typedef typename std::map<key_type, T, Compare, MapAllocator>::iterator iterator;
+
     void operator () (protoc::json::iarchive& ar,
                       std::map<key_type, T, Compare, MapAllocator>& data,
                       const unsigned int version)
@@ -99,11 +114,20 @@ struct load_functor< protoc::json::iarchive,
         ar.load_map_begin();
         while (!ar.at_map_end())
         {
-            // We cannot use std::map<Key, T>::value_type because it has a const key
-            std::pair<key_type, T> value;
-            ar >> value.first;
-            ar >> value.second;
-            data.insert(value);
+            key_type key = construct_functor<key_type>()(ar);
+            ar >> key;
+            // The mapped value is loaded in place unless the key is a duplicate
+            std::pair<iterator, bool> where
+                = data.insert(value_type(key, construct_functor<T>()(ar)));
+            if (where.second)
+            {
+                ar >> where.first->second;
+            }
+            else
+            {
+                T ignored = construct_functor<T>()(ar);
+                ar >> ignored;
+            }
         }
         ar.load_map_end();
     }
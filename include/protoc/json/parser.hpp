@@ -0,0 +1,247 @@
+#ifndef PROTOC_JSON_PARSER_HPP
+#define PROTOC_JSON_PARSER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <string>
+#include <protoc/types.hpp>
+#include <protoc/parser.hpp>
+#include <protoc/nesting_stack.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/json/token.hpp>
+#include <protoc/json/decoder.hpp>
+
+namespace protoc
+{
+namespace json
+{
+
+// Parses a single JSON value and pushes its content to the handler.
+// See protoc/parser.hpp for the handler interface.
+template <typename Handler>
+void parse(const char *begin, const char *end, Handler& handler);
+
+template <typename Handler>
+void parse(const std::string& buffer, Handler& handler);
+
+} // namespace json
+} // namespace protoc
+
+namespace protoc
+{
+namespace json
+{
+namespace detail
+{
+
+template <typename Handler>
+class push_parser
+{
+public:
+    push_parser(const char *begin, const char *end, Handler& handler)
+        : decoder(begin, end),
+          handler(handler)
+    {
+    }
+
+    void parse()
+    {
+        state current = expect_value;
+        do
+        {
+            const token type = decoder.type();
+            switch (current)
+            {
+            case expect_value_or_end:
+                if (type == token_array_end)
+                {
+                    stack.pop();
+                    handler.on_array_end();
+                    current = after_value();
+                    break;
+                }
+                // Fall through
+            case expect_value:
+                current = value(type);
+                break;
+
+            case expect_key_or_end:
+                if (type == token_object_end)
+                {
+                    stack.pop();
+                    handler.on_map_end();
+                    current = after_value();
+                    break;
+                }
+                // Fall through
+            case expect_key:
+                if (type != token_string)
+                    unexpected(type);
+                string(type);
+                current = expect_colon;
+                break;
+
+            case expect_colon:
+                if (type != token_colon)
+                    unexpected(type);
+                current = expect_value;
+                break;
+
+            case expect_comma_or_end:
+                if (type == token_comma)
+                {
+                    current = (stack.top() == token_array_end) ? expect_value : expect_key;
+                }
+                else if (type == stack.top())
+                {
+                    stack.pop();
+                    if (type == token_array_end)
+                        handler.on_array_end();
+                    else
+                        handler.on_map_end();
+                    current = after_value();
+                }
+                else
+                {
+                    unexpected(type);
+                }
+                break;
+
+            case done:
+                break;
+            }
+            decoder.next();
+        } while (current != done);
+
+        if (decoder.type() != token_eof)
+            unexpected(decoder.type());
+    }
+
+private:
+    enum state
+    {
+        expect_value,
+        expect_value_or_end,
+        expect_key,
+        expect_key_or_end,
+        expect_colon,
+        expect_comma_or_end,
+        done
+    };
+
+    state after_value() const
+    {
+        return stack.empty() ? done : expect_comma_or_end;
+    }
+
+    state value(token type)
+    {
+        switch (type)
+        {
+        case token_null:
+            handler.on_null();
+            break;
+
+        case token_true:
+            handler.on_bool(true);
+            break;
+
+        case token_false:
+            handler.on_bool(false);
+            break;
+
+        case token_integer:
+            handler.on_int(decoder.get_integer());
+            break;
+
+        case token_float:
+            handler.on_double(decoder.get_float());
+            break;
+
+        case token_string:
+            string(type);
+            break;
+
+        case token_array_begin:
+            stack.push(token_array_end);
+            handler.on_array_begin();
+            return expect_value_or_end;
+
+        case token_object_begin:
+            stack.push(token_object_end);
+            handler.on_map_begin();
+            return expect_key_or_end;
+
+        default:
+            unexpected(type);
+        }
+        return after_value();
+    }
+
+    void string(token)
+    {
+        if (decoder.has_escapes())
+        {
+            buffer.clear();
+            decoder.get_string(buffer);
+            handler.on_string(protoc::string_view(buffer.data(), buffer.data() + buffer.size()));
+        }
+        else
+        {
+            const decoder_type::input_range& view = decoder.get_string_view();
+            handler.on_string(protoc::string_view(view.begin(), view.end()));
+        }
+    }
+
+    void unexpected(token type)
+    {
+        std::ostringstream error;
+        error << type;
+        throw unexpected_token(error.str());
+    }
+
+private:
+    typedef detail::decoder decoder_type;
+    decoder_type decoder;
+    Handler& handler;
+    // Expected end tokens of the open containers
+    protoc::nesting_stack<token> stack;
+    // Unescaped strings
+    std::string buffer;
+};
+
+} // namespace detail
+
+template <typename Handler>
+void parse(const char *begin, const char *end, Handler& handler)
+{
+    detail::push_parser<Handler> parser(begin, end, handler);
+    parser.parse();
+}
+
+template <typename Handler>
+void parse(const std::string& buffer, Handler& handler)
+{
+    json::parse(buffer.data(), buffer.data() + buffer.size(), handler);
+}
+
+} // namespace json
+} // namespace protoc
+
+#endif /* PROTOC_JSON_PARSER_HPP */
@@ -18,8 +18,9 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/reader.hpp>
+#include <protoc/mapped_file.hpp>
 #include <protoc/json/token.hpp>
 #include <protoc/json/decoder.hpp>
 
@@ -33,10 +34,14 @@ class reader : public protoc::reader
 public:
     template <typename ForwardIterator>
     reader(ForwardIterator begin, ForwardIterator end);
+    // Views refer directly to the mapping, which must outlive the reader
+    explicit reader(const protoc::mapped_file&);
     reader(const reader&);
 
     virtual protoc::token::value type() const;
     virtual size_type size() const;
+    // Input with deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     virtual bool next();
     virtual bool next(protoc::token::value);
@@ -47,6 +52,10 @@ public:
     virtual long long get_long_long() const;
     virtual double get_double() const;
     virtual std::string get_string() const;
+    // Appends the string to result, which can be reused between calls
+    void get_string(std::string& result) const;
+    virtual string_view_type get_string_view() const;
+    virtual bool has_escapes() const;
     virtual range_type get_range() const;
 
 private:
@@ -64,7 +73,7 @@ private:
         detail::token token;
         std::size_t counter;
     };
-    std::stack<frame> stack;
+    protoc::nesting_stack<frame> stack;
 };
 
 } // namespace json
@@ -84,6 +93,11 @@ reader::reader(ForwardIterator begin, ForwardIterator end)
 {
 }
 
+inline reader::reader(const protoc::mapped_file& file)
+    : decoder(file.data(), file.data() + file.size())
+{
+}
+
 inline reader::reader(const reader& other)
     : decoder(other.decoder)
 {
@@ -140,6 +154,11 @@ inline reader::size_type reader::size() const
     return stack.size();
 }
 
+inline void reader::max_depth(size_type depth)
+{
+    stack.max_depth(depth);
+}
+
 inline bool reader::next()
 {
     const detail::token current = decoder.type();
@@ -207,8 +226,30 @@ inline bool reader::next(protoc::token::value expect)
 
 inline void reader::next_sibling()
 {
-    // FIXME: Skip over children
-    throw unexpected_token("not implemented");
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_array_begin:
+    case detail::token_object_begin:
+        decoder.skip_container();
+        switch (decoder.type())
+        {
+        case detail::token_array_end:
+        case detail::token_object_end:
+            // Continue as if the children had been traversed
+            stack.push(decoder.type());
+            break;
+
+        default:
+            // Leave eof and error for type()
+            return;
+        }
+        break;
+
+    default:
+        break;
+    }
+    next();
 }
 
 inline bool reader::get_bool() const
@@ -289,6 +330,55 @@ inline std::string reader::get_string() const
     }
 }
 
+inline void reader::get_string(std::string& result) const
+{
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_string:
+        decoder.get_string(result);
+        break;
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
+inline reader::string_view_type reader::get_string_view() const
+{
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_string:
+        {
+            const detail::decoder::input_range& range = decoder.get_string_view();
+            return string_view_type(range.begin(), range.end());
+        }
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
+inline bool reader::has_escapes() const
+{
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_string:
+        return decoder.has_escapes();
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
 inline reader::range_type reader::get_range() const
 {
     assert(false); // FIXME
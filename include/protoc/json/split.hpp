@@ -0,0 +1,59 @@
+#ifndef PROTOC_JSON_SPLIT_HPP
+#define PROTOC_JSON_SPLIT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring> // std::memchr
+#include <vector>
+#include <protoc/parser.hpp>
+
+namespace protoc
+{
+namespace json
+{
+
+// Splits newline-delimited JSON into one record per line. The records do
+// not include the newline, and blank lines are skipped. The content of the
+// lines is not validated.
+inline void split(const char *begin, const char *end, std::vector<protoc::string_view>& records)
+{
+    while (begin != end)
+    {
+        const char *last = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+        if (last == 0)
+        {
+            last = end;
+        }
+
+        for (const char *it = begin; it != last; ++it)
+        {
+            if ((*it != ' ') && (*it != '\t') && (*it != '\r'))
+            {
+                records.push_back(protoc::string_view(begin, last));
+                break;
+            }
+        }
+
+        begin = (last == end) ? end : last + 1;
+    }
+}
+
+} // namespace json
+} // namespace protoc
+
+#endif /* PROTOC_JSON_SPLIT_HPP */
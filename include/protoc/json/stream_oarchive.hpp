@@ -14,8 +14,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ostream>
+#include <boost/ref.hpp>
 #include <boost/utility/base_from_member.hpp>
-#include <protoc/output_stream.hpp>
+#include <protoc/output_buffered_stream.hpp>
 #include <protoc/json/oarchive.hpp>
 
 namespace protoc
@@ -24,17 +25,24 @@ namespace json
 {
 
 class stream_oarchive
-    : private boost::base_from_member< protoc::output_stream<char> >,
+    : private boost::base_from_member< protoc::output_buffered_stream<char> >,
       public oarchive
 {
-    typedef protoc::output_stream<char> member1_type;
+    typedef protoc::output_buffered_stream<char> member1_type;
     typedef boost::base_from_member<member1_type> base_member1_type;
 
 public:
-    stream_oarchive(std::ostream& stream)
-        : base_member1_type(member1_type(stream)),
+    stream_oarchive(std::ostream& stream,
+                    std::size_t block_size = member1_type::default_block_size)
+        : base_member1_type(boost::ref(stream), block_size),
           oarchive(base_member1_type::member)
     {}
+
+    // Writes buffered output to the stream
+    bool flush()
+    {
+        return base_member1_type::member.flush();
+    }
 };
 
 } // namespace json
@@ -0,0 +1,68 @@
+#ifndef PROTOC_JSON_TRANSCODER_HPP
+#define PROTOC_JSON_TRANSCODER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <protoc/types.hpp>
+#include <protoc/transcoder.hpp>
+#include <protoc/json/writer.hpp>
+
+namespace protoc
+{
+
+template <>
+struct transcoder_writer_traits<json::writer>
+{
+    typedef json::writer writer_type;
+
+    static void write_null(writer_type& output) { output.write(); }
+    static void write_bool(writer_type& output, bool value) { output.write(value); }
+
+    static void write_integer(writer_type& output, long long value)
+    {
+        output.write(protoc::int64_t(value));
+    }
+
+    static void write_floating(writer_type& output, double value)
+    {
+        output.write(protoc::float64_t(value));
+    }
+
+    static void write_string(writer_type& output, const char *data, std::size_t size)
+    {
+        output.write(data, size);
+    }
+
+    static void write_binary(writer_type&, const unsigned char *, std::size_t)
+    {
+        throw invalid_value("binary data cannot be written as JSON");
+    }
+
+    static void record_begin(writer_type& output) { output.write_record_begin(); }
+    static void record_end(writer_type& output) { output.write_record_end(); }
+    static void array_begin(writer_type& output) { output.write_array_begin(); }
+    static void array_begin(writer_type& output, std::size_t count) { output.write_array_begin(count); }
+    static void array_end(writer_type& output) { output.write_array_end(); }
+    static void map_begin(writer_type& output) { output.write_map_begin(); }
+    static void map_begin(writer_type& output, std::size_t count) { output.write_map_begin(count); }
+    static void map_end(writer_type& output) { output.write_map_end(); }
+};
+
+} // namespace protoc
+
+#endif /* PROTOC_JSON_TRANSCODER_HPP */
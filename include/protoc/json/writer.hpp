@@ -18,8 +18,8 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
 #include <boost/move/move.hpp>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/output.hpp>
 #include <protoc/json/token.hpp>
 #include <protoc/json/encoder.hpp>
@@ -38,11 +38,15 @@ public:
     writer(output_type& output);
 
     size_type size() const;
+    // Deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     void write(); // Null
 
     template <typename T>
     void write(BOOST_FWD_REF(T) value);
+    // String of the given length, which need not be null-terminated
+    void write(const char *, size_type);
 
     void write_array_begin();
     void write_array_begin(size_type);
@@ -74,7 +78,8 @@ private:
         detail::token token;
         std::size_t counter;
     };
-    std::stack<frame> stack;
+    typedef protoc::nesting_stack<frame> stack_type;
+    stack_type stack;
 };
 
 } // namespace json
@@ -88,7 +93,8 @@ namespace json
 {
 
 inline writer::writer(output_type& output)
-    : encoder(output)
+    : encoder(output),
+      stack(stack_type::default_max_depth + 1)
 {
     // Push outer scope
     stack.push(frame(encoder, detail::token_array_end));
@@ -99,6 +105,12 @@ inline writer::size_type writer::size() const
     return stack.size() - 1;
 }
 
+inline void writer::max_depth(size_type depth)
+{
+    // The bottom frame is the top-level scope
+    stack.max_depth(depth + 1);
+}
+
 inline void writer::write()
 {
     validate();
@@ -114,6 +126,13 @@ void writer::write(BOOST_FWD_REF(T) value)
     encoder.put(boost::forward<T>(value));
 }
 
+inline void writer::write(const char *value, size_type size)
+{
+    validate();
+    stack.top().write_separator();
+    encoder.put(value, size);
+}
+
 inline void writer::write_array_begin()
 {
     validate();
@@ -0,0 +1,90 @@
+#ifndef PROTOC_MAPPED_FILE_HPP
+#define PROTOC_MAPPED_FILE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+#include <boost/noncopyable.hpp>
+
+namespace protoc
+{
+
+// Read-only view of a file mapped into memory
+//
+// Readers and iarchives can be constructed directly from a mapped file.
+// Strings and binary data obtained as views then point into the mapping,
+// so nothing is copied when the file is opened. The mapping must outlive
+// the readers and views that refer to it.
+//
+// Empty files are not mapped and yield an empty range. Platforms without
+// mmap fall back to reading the file into memory. Failure to open or map
+// the file throws std::runtime_error.
+class mapped_file
+    : private boost::noncopyable
+{
+public:
+    typedef std::size_t size_type;
+
+    // Expected access pattern, which is passed on to the kernel
+    enum access
+    {
+        // Aggressive read-ahead, and the whole file is requested up front
+        sequential,
+        // Read-ahead is disabled
+        random
+    };
+
+    explicit mapped_file(const char *path, access = sequential);
+    explicit mapped_file(const std::string& path, access = sequential);
+    ~mapped_file();
+
+    const char *data() const;
+    size_type size() const;
+    bool empty() const;
+
+private:
+    void open(const char *path, access);
+
+private:
+    const char *address;
+    size_type length;
+    bool mapped;
+    // Content of the file when it cannot be mapped
+    std::vector<char> fallback;
+};
+
+inline const char *mapped_file::data() const
+{
+    return address;
+}
+
+inline mapped_file::size_type mapped_file::size() const
+{
+    return length;
+}
+
+inline bool mapped_file::empty() const
+{
+    return (length == 0);
+}
+
+} // namespace protoc
+
+#endif /* PROTOC_MAPPED_FILE_HPP */
@@ -0,0 +1,152 @@
+#ifndef PROTOC_MEMORY_RESOURCE_HPP
+#define PROTOC_MEMORY_RESOURCE_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <new>
+#include <boost/noncopyable.hpp>
+
+namespace protoc
+{
+
+// Source of memory for allocator-aware containers
+//
+// Modelled after std::pmr::memory_resource.
+class memory_resource
+{
+public:
+    virtual ~memory_resource() {}
+
+    void *allocate(std::size_t size, std::size_t alignment = default_alignment);
+    void deallocate(void *pointer, std::size_t size, std::size_t alignment = default_alignment);
+
+    bool is_equal(const memory_resource& other) const;
+
+    static const std::size_t default_alignment = sizeof(void *) * 2;
+
+protected:
+    virtual void *do_allocate(std::size_t size, std::size_t alignment) = 0;
+    virtual void do_deallocate(void *pointer, std::size_t size, std::size_t alignment) = 0;
+    virtual bool do_is_equal(const memory_resource& other) const;
+};
+
+// Returns the resource that uses the global operator new and delete
+memory_resource& new_delete_resource();
+
+// Arena that hands out memory from a growing list of blocks
+//
+// Deallocation is a no-op. All memory is released at once by release() or
+// when the resource is destroyed. The first block can be supplied by the
+// caller, for instance a stack buffer. Not thread-safe.
+class monotonic_buffer_resource
+    : public memory_resource,
+      private boost::noncopyable
+{
+public:
+    static const std::size_t default_block_size = 4 * 1024;
+
+    explicit monotonic_buffer_resource(std::size_t block_size = default_block_size,
+                                       memory_resource& upstream = new_delete_resource());
+    monotonic_buffer_resource(void *buffer,
+                              std::size_t size,
+                              memory_resource& upstream = new_delete_resource());
+    ~monotonic_buffer_resource();
+
+    // Releases all blocks obtained from the upstream resource
+    void release();
+
+    memory_resource& upstream_resource() const;
+
+protected:
+    virtual void *do_allocate(std::size_t size, std::size_t alignment);
+    virtual void do_deallocate(void *pointer, std::size_t size, std::size_t alignment);
+
+private:
+    void next_block(std::size_t size, std::size_t alignment);
+
+private:
+    struct block_header
+    {
+        block_header *next;
+        std::size_t size;
+    };
+
+    memory_resource& upstream;
+    block_header *blocks;
+    void *initial_buffer;
+    std::size_t initial_size;
+    char *current;
+    std::size_t available;
+    std::size_t next_size;
+};
+
+// Allocator that obtains memory from a memory_resource
+//
+// Containers using this allocator propagate the resource to copies, so
+// elements copied into a container share the arena of the original.
+template <typename T>
+class polymorphic_allocator
+{
+public:
+    typedef T value_type;
+    typedef T *pointer;
+    typedef const T *const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef std::size_t size_type;
+    typedef std::ptrdiff_t difference_type;
+
+    template <typename U>
+    struct rebind
+    {
+        typedef polymorphic_allocator<U> other;
+    };
+
+    polymorphic_allocator();
+    polymorphic_allocator(memory_resource *);
+    template <typename U>
+    polymorphic_allocator(const polymorphic_allocator<U>&);
+
+    pointer allocate(size_type count, const void * = 0);
+    void deallocate(pointer, size_type count);
+
+    void construct(pointer, const T&);
+    void destroy(pointer);
+
+    pointer address(reference value) const { return &value; }
+    const_pointer address(const_reference value) const { return &value; }
+    size_type max_size() const;
+
+    memory_resource *resource() const;
+
+private:
+    memory_resource *memory;
+};
+
+template <typename T, typename U>
+bool operator == (const polymorphic_allocator<T>&, const polymorphic_allocator<U>&);
+
+template <typename T, typename U>
+bool operator != (const polymorphic_allocator<T>&, const polymorphic_allocator<U>&);
+
+} // namespace protoc
+
+#include <protoc/impl/memory_resource.ipp>
+
+#endif /* PROTOC_MEMORY_RESOURCE_HPP */
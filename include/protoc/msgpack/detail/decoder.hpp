@@ -35,8 +35,39 @@ public:
     decoder(input_range::const_iterator begin, input_range::const_iterator end);
     decoder(const decoder&);
 
+    // Decodes new input as if the decoder had been constructed with it
+    void reset(input_range::const_iterator begin, input_range::const_iterator end);
+
     token type() const;
     void next();
+    // Input after the current token
+    const input_range& remaining() const;
+    // More input could change the current token, because the input ends
+    // before or inside it. Used by chunk_decoder to decide when to wait for
+    // more data.
+    bool is_truncated() const;
+
+    // Finds the end of a token that is split across chunks, so that
+    // chunk_decoder looks at each value only once. scan() continues with
+    // the next piece of input and returns how many of its values belong to
+    // the token. done() becomes true when the end has been found.
+    class token_scanner
+    {
+    public:
+        token_scanner();
+
+        std::size_t scan(input_range::const_iterator first,
+                         input_range::const_iterator last);
+        bool done() const;
+
+    private:
+        // The longest header is a code followed by a 32-bit length
+        unsigned char header[1 + sizeof(protoc::uint32_t)];
+        std::size_t header_size;
+        // Size of the token, or zero until the header is complete
+        std::size_t size;
+        std::size_t scanned;
+    };
 
     protoc::int8_t get_int8() const;
     protoc::int16_t get_int16() const;
@@ -49,6 +80,7 @@ public:
     protoc::float32_t get_float32() const;
     protoc::float64_t get_float64() const;
     std::string get_string() const;
+    const input_range& get_string_view() const;
     // Decoder does not enforces that maps must have a even number of objects
     protoc::uint32_t get_count() const;
     const input_range& get_range() const;
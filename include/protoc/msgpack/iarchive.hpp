@@ -16,6 +16,7 @@
 #include <cstddef> // std::size_t
 #include <string>
 #include <boost/archive/detail/common_iarchive.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/msgpack/reader.hpp>
 
 namespace protoc
@@ -32,8 +33,16 @@ public:
     typedef msgpack::reader::value_type value_type;
 
     iarchive(const msgpack::reader&);
+    iarchive(const msgpack::reader&, protoc::memory_resource&);
     template <typename Iterator>
     iarchive(Iterator begin, Iterator end);
+    // Allocator-aware values created during loading, such as strings and
+    // containers using protoc::polymorphic_allocator, obtain their memory
+    // from the resource.
+    template <typename Iterator>
+    iarchive(Iterator begin, Iterator end, protoc::memory_resource&);
+    explicit iarchive(const protoc::mapped_file&);
+    iarchive(const protoc::mapped_file&, protoc::memory_resource&);
 
     template<typename value_type>
     void load_override(value_type& data, long /*version*/)
@@ -48,10 +57,19 @@ public:
     void load(float&);
     void load(double&);
     void load(std::string&);
+    template <typename Traits, typename Allocator>
+    void load(std::basic_string<char, Traits, Allocator>&);
 
     std::size_t load_binary_begin();
     void load(void *, std::size_t);
 
+    // Arrays of numbers that are decoded in bulk. Loads up to size
+    // consecutive elements and returns how many were loaded.
+    std::size_t load_array(int *, std::size_t);
+    std::size_t load_array(long long *, std::size_t);
+    std::size_t load_array(float *, std::size_t);
+    std::size_t load_array(double *, std::size_t);
+
     void load_record_begin();
     void load_record_end();
 
@@ -75,8 +93,11 @@ public:
     void load(boost::archive::tracking_type) {}
     void load(boost::archive::class_name_type&) {}
 
+    protoc::memory_resource& resource() const;
+
 private:
     msgpack::reader reader;
+    protoc::memory_resource *memory;
 };
 
 } // namespace msgpack
@@ -86,19 +107,53 @@ private:
 
 BOOST_SERIALIZATION_REGISTER_ARCHIVE(protoc::msgpack::iarchive);
 
+#include <cassert>
+#include <cstring> // std::memcpy
+#include <protoc/exceptions.hpp>
+
 namespace protoc
 {
 namespace msgpack
 {
 
 inline iarchive::iarchive(const msgpack::reader& reader)
-    : reader(reader)
+    : reader(reader),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const msgpack::reader& reader,
+                          protoc::memory_resource& resource)
+    : reader(reader),
+      memory(&resource)
 {
 }
 
 template <typename Iterator>
 inline iarchive::iarchive(Iterator begin, Iterator end)
-    : reader(begin, end)
+    : reader(begin, end),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+template <typename Iterator>
+inline iarchive::iarchive(Iterator begin, Iterator end,
+                          protoc::memory_resource& resource)
+    : reader(begin, end),
+      memory(&resource)
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file)
+    : reader(file),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file,
+                          protoc::memory_resource& resource)
+    : reader(file),
+      memory(&resource)
 {
 }
 
@@ -138,6 +193,105 @@ inline void iarchive::load(std::string& value)
     reader.next();
 }
 
+template <typename Traits, typename Allocator>
+void iarchive::load(std::basic_string<char, Traits, Allocator>& value)
+{
+    // Copy from the input to avoid a temporary std::string
+    const protoc::reader::string_view_type view = reader.get_string_view();
+    value.assign(view.begin(), view.end());
+    reader.next();
+}
+
+inline std::size_t iarchive::load_binary_begin()
+{
+    return reader.get_range().size();
+}
+
+inline void iarchive::load(void *destination, std::size_t size)
+{
+    reader::range_type range = reader.get_range();
+    assert(range.size() == size);
+    std::memcpy(destination, range.begin(), size);
+    reader.next(protoc::token::token_binary);
+}
+
+// Records have no delimiters in MessagePack
+inline std::size_t iarchive::load_array(int *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(long long *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(float *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(double *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline void iarchive::load_record_begin()
+{
+}
+
+inline void iarchive::load_record_end()
+{
+}
+
+inline std::size_t iarchive::load_array_begin()
+{
+    if (reader.type() != protoc::token::token_array_begin)
+        throw unexpected_token("expected array begin");
+    const std::size_t result = reader.get_count();
+    reader.next();
+    return result;
+}
+
+inline void iarchive::load_array_end()
+{
+    reader.next(protoc::token::token_array_end);
+}
+
+inline bool iarchive::at_array_end() const
+{
+    return (reader.type() == protoc::token::token_array_end);
+}
+
+inline std::size_t iarchive::load_map_begin()
+{
+    if (reader.type() != protoc::token::token_map_begin)
+        throw unexpected_token("expected map begin");
+    const std::size_t result = reader.get_count();
+    reader.next();
+    return result;
+}
+
+inline void iarchive::load_map_end()
+{
+    reader.next(protoc::token::token_map_end);
+}
+
+inline bool iarchive::at_map_end() const
+{
+    return (reader.type() == protoc::token::token_map_end);
+}
+
+inline protoc::token::value iarchive::type() const
+{
+    return reader.type();
+}
+
+inline protoc::memory_resource& iarchive::resource() const
+{
+    return *memory;
+}
+
 } // namespace msgpack
 } // namespace protoc
 
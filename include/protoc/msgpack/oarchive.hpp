@@ -40,6 +40,12 @@ public:
     void save(const std::string&);
     void save(const unsigned char *, std::size_t);
 
+    // Arrays of numbers that are encoded in bulk
+    void save_array(const int *, std::size_t);
+    void save_array(const long long *, std::size_t);
+    void save_array(const float *, std::size_t);
+    void save_array(const double *, std::size_t);
+
     void save_record_begin();
     void save_record_end();
     void save_array_begin();
@@ -137,6 +143,26 @@ inline void oarchive::save(const unsigned char *data, std::size_t size)
     writer.write(data, size);
 }
 
+inline void oarchive::save_array(const int *data, std::size_t size)
+{
+    writer.write_array(data, size);
+}
+
+inline void oarchive::save_array(const long long *data, std::size_t size)
+{
+    writer.write_array(data, size);
+}
+
+inline void oarchive::save_array(const float *data, std::size_t size)
+{
+    writer.write_array(data, size);
+}
+
+inline void oarchive::save_array(const double *data, std::size_t size)
+{
+    writer.write_array(data, size);
+}
+
 inline void oarchive::save_array_begin()
 {
     writer.array_begin();
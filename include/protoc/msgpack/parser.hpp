@@ -0,0 +1,253 @@
+#ifndef PROTOC_MSGPACK_PARSER_HPP
+#define PROTOC_MSGPACK_PARSER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <limits>
+#include <sstream>
+#include <protoc/types.hpp>
+#include <protoc/parser.hpp>
+#include <protoc/nesting_stack.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/msgpack/detail/token.hpp>
+#include <protoc/msgpack/detail/decoder.hpp>
+
+namespace protoc
+{
+namespace msgpack
+{
+
+// Parses a single MessagePack value and pushes its content to the handler.
+// See protoc/parser.hpp for the handler interface.
+template <typename Handler>
+void parse(const unsigned char *begin, const unsigned char *end, Handler& handler);
+
+template <typename Container, typename Handler>
+void parse(const Container& buffer, Handler& handler);
+
+} // namespace msgpack
+} // namespace protoc
+
+namespace protoc
+{
+namespace msgpack
+{
+namespace detail
+{
+
+template <typename Handler>
+class push_parser
+{
+public:
+    push_parser(const unsigned char *begin, const unsigned char *end, Handler& handler)
+        : decoder(begin, end),
+          handler(handler)
+    {
+    }
+
+    void parse()
+    {
+        do
+        {
+            if (value(decoder.type()))
+            {
+                decoder.next();
+                // Close the containers that the element completes
+                while (!stack.empty())
+                {
+                    frame& top = stack.top();
+                    if (--top.count > 0)
+                        break;
+                    end(top.type);
+                    stack.pop();
+                }
+            }
+        } while (!stack.empty());
+
+        if (decoder.type() != token_eof)
+            unexpected(decoder.type());
+    }
+
+private:
+    // Returns false if a non-empty container has been entered
+    bool value(token type)
+    {
+        switch (type)
+        {
+        case token_null:
+            handler.on_null();
+            break;
+
+        case token_true:
+            handler.on_bool(true);
+            break;
+
+        case token_false:
+            handler.on_bool(false);
+            break;
+
+        case token_int8:
+            handler.on_int(decoder.get_int8());
+            break;
+
+        case token_int16:
+            handler.on_int(decoder.get_int16());
+            break;
+
+        case token_int32:
+            handler.on_int(decoder.get_int32());
+            break;
+
+        case token_int64:
+            handler.on_int(decoder.get_int64());
+            break;
+
+        case token_uint8:
+            handler.on_int(decoder.get_uint8());
+            break;
+
+        case token_uint16:
+            handler.on_int(decoder.get_uint16());
+            break;
+
+        case token_uint32:
+            handler.on_int(decoder.get_uint32());
+            break;
+
+        case token_uint64:
+            {
+                const protoc::uint64_t number = decoder.get_uint64();
+                if (number > protoc::uint64_t(std::numeric_limits<protoc::int64_t>::max()))
+                {
+                    std::ostringstream error;
+                    error << type;
+                    throw invalid_value(error.str());
+                }
+                handler.on_int(protoc::int64_t(number));
+            }
+            break;
+
+        case token_float32:
+            handler.on_double(decoder.get_float32());
+            break;
+
+        case token_float64:
+            handler.on_double(decoder.get_float64());
+            break;
+
+        case token_str8:
+        case token_str16:
+        case token_str32:
+            {
+                const decoder::input_range& view = decoder.get_string_view();
+                handler.on_string(protoc::string_view(reinterpret_cast<const char *>(view.begin()),
+                                                      reinterpret_cast<const char *>(view.end())));
+            }
+            break;
+
+        case token_bin8:
+        case token_bin16:
+        case token_bin32:
+            {
+                const decoder::input_range& view = decoder.get_range();
+                handler.on_binary(protoc::binary_view(view.begin(), view.end()));
+            }
+            break;
+
+        case token_array8:
+        case token_array16:
+        case token_array32:
+            return begin(token_array8, decoder.get_count());
+
+        case token_map8:
+        case token_map16:
+        case token_map32:
+            return begin(token_map8, 2 * std::size_t(decoder.get_count()));
+
+        default:
+            unexpected(type);
+        }
+        return true;
+    }
+
+    bool begin(token type, std::size_t count)
+    {
+        if (type == token_array8)
+            handler.on_array_begin();
+        else
+            handler.on_map_begin();
+        if (count == 0)
+        {
+            end(type);
+            return true;
+        }
+        stack.push(frame(type, count));
+        decoder.next();
+        return false;
+    }
+
+    void end(token type)
+    {
+        if (type == token_array8)
+            handler.on_array_end();
+        else
+            handler.on_map_end();
+    }
+
+    void unexpected(token type)
+    {
+        std::ostringstream error;
+        error << type;
+        throw unexpected_token(error.str());
+    }
+
+private:
+    detail::decoder decoder;
+    Handler& handler;
+
+    struct frame
+    {
+        frame(token type, std::size_t count) : type(type), count(count) {}
+
+        token type;
+        // Remaining elements
+        std::size_t count;
+    };
+    protoc::nesting_stack<frame> stack;
+};
+
+} // namespace detail
+
+template <typename Handler>
+void parse(const unsigned char *begin, const unsigned char *end, Handler& handler)
+{
+    detail::push_parser<Handler> parser(begin, end, handler);
+    parser.parse();
+}
+
+template <typename Container, typename Handler>
+void parse(const Container& buffer, Handler& handler)
+{
+    const unsigned char *begin = reinterpret_cast<const unsigned char *>(buffer.data());
+    msgpack::parse(begin, begin + buffer.size(), handler);
+}
+
+} // namespace msgpack
+} // namespace protoc
+
+#endif /* PROTOC_MSGPACK_PARSER_HPP */
@@ -13,9 +13,11 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
+#include <cstddef> // std::size_t
 #include <boost/optional.hpp>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/reader.hpp>
+#include <protoc/mapped_file.hpp>
 #include <protoc/token.hpp>
 #include <protoc/msgpack/detail/token.hpp>
 #include <protoc/msgpack/detail/decoder.hpp>
@@ -30,10 +32,14 @@ class reader : public protoc::reader
 public:
     template <typename ForwardIterator>
     reader(ForwardIterator begin, ForwardIterator end);
+    // Views refer directly to the mapping, which must outlive the reader
+    explicit reader(const protoc::mapped_file&);
     reader(const reader&);
 
     virtual protoc::token::value type() const;
     virtual size_type size() const;
+    // Input with deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     virtual bool next();
     virtual bool next(protoc::token::value);
@@ -44,8 +50,28 @@ public:
     virtual long long get_long_long() const;
     virtual double get_double() const;
     virtual std::string get_string() const;
+    virtual string_view_type get_string_view() const;
+    virtual bool has_escapes() const;
     virtual range_type get_range() const;
 
+    // Returns the number of elements of the array, or the number of
+    // key-value pairs of the map, at the current position.
+    size_type get_count() const;
+
+    // Reads consecutive numbers of the current array into the output and
+    // moves past them. Stops after size values, at the end of the array, or
+    // at the first element that the corresponding get function would reject.
+    // Returns the number of values read.
+    size_type read_values(int *, size_type size);
+    size_type read_values(long long *, size_type size);
+    size_type read_values(float *, size_type size);
+    size_type read_values(double *, size_type size);
+
+private:
+    bool next_element();
+    template <typename T>
+    size_type read_array_values(T *, size_type);
+
 private:
     msgpack::detail::decoder decoder;
     struct frame
@@ -55,7 +81,7 @@ private:
         protoc::token::value token;
         size_type count;
     };
-    typedef std::stack<frame> stack_type;
+    typedef protoc::nesting_stack<frame> stack_type;
     stack_type stack;
 };
 
@@ -73,7 +99,36 @@ reader::reader(ForwardIterator begin, ForwardIterator end)
 {
 }
 
+inline reader::reader(const protoc::mapped_file& file)
+    : decoder(reinterpret_cast<const unsigned char *>(file.data()),
+              reinterpret_cast<const unsigned char *>(file.data()) + file.size())
+{
+}
+
 } // namespace msgpack
 } // namespace protoc
 
+namespace protoc
+{
+
+// Declared here so that the specialization is visible wherever the reader
+// is, whether or not protoc/transcoder.hpp is included
+template <typename Reader>
+struct transcoder_reader_traits;
+
+// Arrays and maps are written with the element count from the input, so
+// writers that require the count in advance can be used as output.
+template <>
+struct transcoder_reader_traits<msgpack::reader>
+{
+    static bool container_begin(msgpack::reader& input, std::size_t& count)
+    {
+        count = input.get_count();
+        input.next();
+        return true;
+    }
+};
+
+} // namespace protoc
+
 #endif // PROTOC_MSGPACK_READER_HPP
@@ -0,0 +1,89 @@
+#ifndef PROTOC_MSGPACK_SPLIT_HPP
+#define PROTOC_MSGPACK_SPLIT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <sstream>
+#include <vector>
+#include <protoc/parser.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/msgpack/detail/token.hpp>
+#include <protoc/msgpack/detail/decoder.hpp>
+
+namespace protoc
+{
+namespace msgpack
+{
+
+// Splits back-to-back msgpack values into one record per value. The extent
+// of each value is found from the element counts of its containers, so
+// only the headers of the nested values are decoded. Truncated or invalid
+// input throws protoc::unexpected_token.
+inline void split(const unsigned char *begin, const unsigned char *end, std::vector<protoc::binary_view>& records)
+{
+    detail::decoder decoder(begin, end);
+    const unsigned char *first = begin;
+    while (first != end)
+    {
+        std::size_t pending = 1;
+        do
+        {
+            switch (decoder.type())
+            {
+            case detail::token_array8:
+            case detail::token_array16:
+            case detail::token_array32:
+                pending += decoder.get_count();
+                break;
+
+            case detail::token_map8:
+            case detail::token_map16:
+            case detail::token_map32:
+                pending += 2 * std::size_t(decoder.get_count());
+                break;
+
+            case detail::token_eof:
+                throw unexpected_token("truncated record");
+
+            case detail::token_error:
+                {
+                    std::ostringstream error;
+                    error << decoder.type();
+                    throw unexpected_token(error.str());
+                }
+
+            default:
+                break;
+            }
+            --pending;
+            if (pending == 0)
+            {
+                const unsigned char *last = decoder.remaining().begin();
+                records.push_back(protoc::binary_view(first, last));
+                first = last;
+            }
+            decoder.next();
+        } while (pending > 0);
+    }
+}
+
+} // namespace msgpack
+} // namespace protoc
+
+#endif /* PROTOC_MSGPACK_SPLIT_HPP */
@@ -34,6 +34,32 @@ struct save_functor< protoc::msgpack::oarchive, typename std::vector<unsigned ch
     }
 };
 
+// Specializations of std::vector of numbers, which are encoded in bulk
+
+template <typename Allocator>
+struct save_functor< protoc::msgpack::oarchive, typename std::vector<int, Allocator> >
+    : save_array_functor<protoc::msgpack::oarchive, int, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::msgpack::oarchive, typename std::vector<long long, Allocator> >
+    : save_array_functor<protoc::msgpack::oarchive, long long, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::msgpack::oarchive, typename std::vector<float, Allocator> >
+    : save_array_functor<protoc::msgpack::oarchive, float, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::msgpack::oarchive, typename std::vector<double, Allocator> >
+    : save_array_functor<protoc::msgpack::oarchive, double, Allocator>
+{
+};
+
 template <typename Allocator>
 struct load_functor< protoc::msgpack::iarchive, typename std::vector<unsigned char, Allocator> >
 {
@@ -54,6 +80,32 @@ struct load_functor< protoc::msgpack::iarchive, typename std::vector<unsigned ch
     }
 };
 
+// Specializations of std::vector of numbers, which are decoded in bulk
+
+template <typename Allocator>
+struct load_functor< protoc::msgpack::iarchive, typename std::vector<int, Allocator> >
+    : load_array_functor<protoc::msgpack::iarchive, int, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::msgpack::iarchive, typename std::vector<long long, Allocator> >
+    : load_array_functor<protoc::msgpack::iarchive, long long, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::msgpack::iarchive, typename std::vector<float, Allocator> >
+    : load_array_functor<protoc::msgpack::iarchive, float, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::msgpack::iarchive, typename std::vector<double, Allocator> >
+    : load_array_functor<protoc::msgpack::iarchive, double, Allocator>
+{
+};
+
 } // namespace serialization
 } // namespace boost
 
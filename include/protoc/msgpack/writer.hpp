@@ -13,8 +13,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
+#include <vector>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/writer.hpp>
+#include <protoc/output_container.hpp>
 #include <protoc/token.hpp>
 #include <protoc/msgpack/detail/encoder.hpp>
 
@@ -30,9 +32,22 @@ class writer : public protoc::writer
 public:
     typedef encoder_type::output_type output_type;
 
-    writer(output_type&);
+    // Handling of arrays and maps whose count is not given in advance
+    enum count_mode
+    {
+        // array_begin() and map_begin() without count are rejected
+        count_required,
+        // Containers get a 32-bit header that is patched when they end
+        count_deferred,
+        // As count_deferred, but headers are shrunk to the smallest form
+        count_deferred_compact
+    };
+
+    writer(output_type&, count_mode mode = count_required);
 
     virtual size_type size();
+    // Deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     virtual size_type write(); // Null
     virtual size_type write(bool);
@@ -42,11 +57,20 @@ public:
     virtual size_type write(double);
     virtual size_type write(const char *);
     virtual size_type write(const std::string&);
+    virtual size_type write(const char *, size_type);
     virtual size_type write(const value_type *, size_type);
 
     virtual size_type record_begin();
     virtual size_type record_end();
 
+    // Containers without a count are only available in the deferred modes.
+    // Their header is patched in place when the output can be rewritten
+    // (e.g. output_vector). Otherwise (e.g. streams) the encoding is
+    // collected internally until the outermost of them ends, at which point
+    // it is written to the output. array_begin() and map_begin() return the
+    // size of the 32-bit header and array_end() and map_end() return zero,
+    // so in count_deferred_compact mode the written data can be smaller
+    // than the sum of the returned sizes.
     virtual size_type array_begin();
     virtual size_type array_begin(size_type count);
     virtual size_type array_end();
@@ -55,19 +79,67 @@ public:
     virtual size_type map_begin(size_type count);
     virtual size_type map_end();
 
+    // Writes an array of numbers with the same encoding as writing each
+    // element individually, but in a single pass over the values. Returns
+    // zero if the output cannot hold all the values, in which case the array
+    // is left open with the values not written as its remaining count.
+    size_type write_array(const int *, size_type count);
+    size_type write_array(const long *, size_type count);
+    size_type write_array(const long long *, size_type count);
+    size_type write_array(const float *, size_type count);
+    size_type write_array(const double *, size_type count);
+
 private:
+    writer(const writer&);
+    writer& operator = (const writer&);
+
+    template <typename T>
+    size_type put_array(const T *, size_type count);
+    encoder_type& current();
+    output_type& deferred_output();
     size_type track(size_type);
+    size_type deferred_begin(protoc::token::value);
+    size_type end(protoc::token::value);
+    void flush();
+    bool is_complete() const;
 
 private:
+    count_mode mode;
+    output_type& output;
     encoder_type encoder;
+    // Encoding of the open deferred containers for outputs that cannot
+    // be rewritten
+    std::vector<value_type> buffer;
+    protoc::output_container<value_type, std::vector> buffer_output;
+    encoder_type buffer_encoder;
+    const bool in_place;
+
+    struct header
+    {
+        header(protoc::token::value token, size_type offset);
+
+        protoc::token::value token;
+        // Offset into the deferred output, unless the header did not fit
+        size_type offset;
+        size_type count;
+    };
+    std::vector<header> headers;
+    size_type deferred_depth;
+
     struct frame
     {
         frame(protoc::token::value token, size_type count);
+        frame(protoc::token::value token, size_type count, size_type header);
+
+        bool is_deferred() const;
 
         protoc::token::value token;
+        // Remaining elements, or written elements if deferred
         size_type count;
+        // Index into headers if deferred
+        size_type header;
     };
-    typedef std::stack<frame> stack_type;
+    typedef protoc::nesting_stack<frame> stack_type;
     stack_type stack;
 };
 
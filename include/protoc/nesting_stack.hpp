@@ -0,0 +1,85 @@
+#ifndef PROTOC_NESTING_STACK_HPP
+#define PROTOC_NESTING_STACK_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <vector>
+#include <boost/type_traits/aligned_storage.hpp>
+#include <boost/type_traits/alignment_of.hpp>
+
+namespace protoc
+{
+
+// Stack of the containers that are currently open in a reader or writer
+//
+// The first N frames are stored inside the object, so typical documents
+// are processed without heap allocations. Deeper frames are kept in a
+// vector. Pushing beyond the maximum depth throws protoc::invalid_scope,
+// which bounds the memory that deeply nested input can claim.
+//
+// The interface is a subset of std::stack.
+template <typename T, std::size_t N = 32>
+class nesting_stack
+{
+public:
+    typedef T value_type;
+    typedef std::size_t size_type;
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    static const size_type default_max_depth = 1024;
+
+    explicit nesting_stack(size_type max_depth = default_max_depth);
+    nesting_stack(const nesting_stack&);
+    ~nesting_stack();
+
+    bool empty() const;
+    size_type size() const;
+
+    size_type max_depth() const;
+    void max_depth(size_type);
+
+    reference top();
+    const_reference top() const;
+
+    void push(const value_type&);
+    void pop();
+    void clear();
+
+private:
+    // Not assignable, because the frames need not be
+    nesting_stack& operator = (const nesting_stack&);
+
+    value_type *local();
+    const value_type *local() const;
+
+private:
+    size_type count;
+    size_type limit;
+    typename boost::aligned_storage<sizeof(value_type) * N,
+                                    boost::alignment_of<value_type>::value>::type storage;
+    // Frames beyond the first N
+    std::vector<value_type> overflow;
+};
+
+} // namespace protoc
+
+#include <protoc/impl/nesting_stack.ipp>
+
+#endif /* PROTOC_NESTING_STACK_HPP */
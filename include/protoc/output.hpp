@@ -19,11 +19,33 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cstddef> // std::size_t
+#include <vector>
 
 namespace protoc
 {
 
 // Interface for encoder output
+//
+// Encoders write through a window of raw memory. reserve(n) returns a
+// pointer to at least n writable values (or null if the output is full),
+// and commit(position) hands everything up to position over to the output.
+// The window is managed with inline pointer arithmetic, so the virtual
+// functions are only called when the window is exhausted.
+//
+// Outputs that only implement grow() and write() still work, because the
+// default overflow() and sync() route the window through a scratch buffer.
+//
+// Binary payloads of at least reference_threshold() values are handed to
+// reference() by the binary encoders instead of being copied into the
+// window. The default threshold is never reached, and the default
+// reference() copies the payload with write().
+//
+// Outputs that keep the committed values in memory can be rewritten, so
+// that encoders can patch data they have already committed. position() is
+// the number of committed values, rewrite(offset) returns a pointer to the
+// committed values from offset onwards, and truncate(offset) discards them.
+// The pointer is invalidated by the next reserve(). The default output
+// cannot be rewritten and rewrite() returns null.
 template<typename Value>
 class output
 {
@@ -31,13 +53,52 @@ public:
     typedef Value value_type;
     typedef std::size_t size_type;
 
+    output();
     virtual ~output() {}
 
     virtual bool grow(size_type) = 0;
     virtual void write(value_type) = 0;
     virtual void write(const value_type*, size_type) = 0;
+
+    value_type *reserve(size_type);
+    void commit(value_type *);
+
+    bool by_reference(size_type) const;
+    size_type reference_threshold() const;
+    // Appends payload data that was committed to no window. Outputs that
+    // keep a reference to the data require it to outlive their content.
+    virtual void reference(const value_type *, size_type);
+
+    virtual bool rewritable() const;
+    virtual size_type position() const;
+    virtual value_type *rewrite(size_type offset);
+    virtual void truncate(size_type offset);
+
+protected:
+    // Called by reserve() when the window is too small
+    virtual bool overflow(size_type);
+    // Called by commit() for outputs that need to see every commit
+    virtual void sync();
+
+    void set_window(value_type *first, value_type *last, bool eager = false);
+    void clear_window();
+    void set_reference_threshold(size_type);
+
+protected:
+    struct
+    {
+        value_type *first;
+        value_type *last;
+        bool eager;
+    } window;
+
+private:
+    std::vector<value_type> scratch;
+    size_type threshold;
 };
 
-}
+} // namespace protoc
+
+#include <protoc/impl/output.ipp>
 
 #endif /* PROTOC_OUTPUT_HPP */
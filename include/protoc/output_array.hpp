@@ -18,6 +18,7 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
 #include <protoc/output.hpp>
 
@@ -37,8 +38,8 @@ public:
 
 public:
     output_array()
-        : current(content)
     {
+        this->set_window(content, content + N);
     }
 
     const_iterator begin() const
@@ -48,13 +49,13 @@ public:
 
     const_iterator end() const
     {
-        return current;
+        return this->window.first;
     }
 
     // Returns the number of elements that has been inserted into the array
     size_type size() const
     {
-        return (current - content);
+        return (this->window.first - content);
     }
 
     size_type capacity() const
@@ -79,23 +80,47 @@ private:
     virtual void write(value_type value)
     {
         assert(grow(sizeof(value_type)));
-        *current = value;
-        ++current;
+        *this->window.first = value;
+        ++this->window.first;
     }
 
     virtual void write(const value_type *values, size_type size)
     {
         assert(grow(size));
-        for (size_type i = 0; i < size; ++i)
-        {
-            current[i] = values[i];
-        }
-        current += size;
+        std::copy(values, values + size, this->window.first);
+        this->window.first += size;
+    }
+
+    // The window always covers the unused part of the array
+    virtual bool overflow(size_type)
+    {
+        return false;
+    }
+
+    virtual bool rewritable() const
+    {
+        return true;
+    }
+
+    virtual size_type position() const
+    {
+        return size();
+    }
+
+    virtual value_type *rewrite(size_type offset)
+    {
+        assert(offset <= size());
+        return content + offset;
+    }
+
+    virtual void truncate(size_type offset)
+    {
+        assert(offset <= size());
+        this->set_window(content + offset, content + N);
     }
 
 private:
     value_type content[N]; // Fixed-size array
-    iterator current;
 };
 
 
@@ -0,0 +1,79 @@
+#ifndef PROTOC_OUTPUT_BUFFERED_STREAM_HPP
+#define PROTOC_OUTPUT_BUFFERED_STREAM_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <ostream>
+#include <vector>
+#include <protoc/output.hpp>
+
+namespace protoc
+{
+
+// Stream output that collects data in a block before writing it
+//
+// The block is handed to the stream when it is full, when flush() is
+// called, and when the output is destroyed. Data written with flush()
+// pending is therefore not visible in the stream yet.
+//
+// Stream errors are reported by grow() and reserve() rather than asserted.
+template<typename Value>
+class output_buffered_stream : public output<Value>
+{
+public:
+    typedef typename output<Value>::value_type value_type;
+    typedef typename output<Value>::size_type size_type;
+
+    typedef value_type& reference;
+    typedef const value_type& const_reference;
+
+    static const size_type default_block_size = 64 * 1024;
+
+    output_buffered_stream(std::ostream& stream,
+                           size_type block_size = default_block_size);
+    output_buffered_stream(const output_buffered_stream&);
+    ~output_buffered_stream();
+
+    // Writes buffered data to the stream. Returns false on stream errors.
+    bool flush();
+
+    // Returns the number of buffered elements not yet written to the stream
+    size_type pending() const;
+
+private:
+    output_buffered_stream& operator = (const output_buffered_stream&);
+
+    void reset();
+
+    // Implementation of protoc::output interface
+    virtual bool grow(size_type delta);
+    virtual void write(value_type value);
+    virtual void write(const value_type *, size_type);
+    virtual bool overflow(size_type);
+
+private:
+    std::ostream& stream;
+    std::vector<value_type> block;
+};
+
+} // namespace protoc
+
+#include <protoc/impl/output_buffered_stream.ipp>
+
+#endif /* PROTOC_OUTPUT_BUFFERED_STREAM_HPP */
@@ -25,6 +25,11 @@
 namespace protoc
 {
 
+// Output to a user-supplied container
+//
+// The container must store its elements contiguously (e.g. std::vector)
+// because encoders write directly into its memory. The container always
+// holds exactly the committed output.
 template <typename Value, template <typename, typename = std::allocator<Value> > class Container>
 class output_container
     : public output<typename Container<Value>::value_type>
@@ -57,6 +62,12 @@ private:
     virtual bool grow(size_type delta);
     virtual void write(value_type value);
     virtual void write(const value_type *, size_type);
+    virtual bool overflow(size_type);
+    virtual void sync();
+    virtual bool rewritable() const;
+    virtual size_type position() const;
+    virtual value_type *rewrite(size_type offset);
+    virtual void truncate(size_type offset);
 
 private:
     Container<value_type>& buffer;
@@ -0,0 +1,73 @@
+#ifndef PROTOC_OUTPUT_COUNTER_HPP
+#define PROTOC_OUTPUT_COUNTER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <vector>
+#include <protoc/output.hpp>
+
+namespace protoc
+{
+
+// Output that discards the encoded data and only counts it
+//
+// Encoding into a counter gives the exact size of the encoded data, so the
+// real output can be sized once before encoding again:
+//
+//   protoc::output_counter<unsigned char> counter;
+//   protoc::msgpack::writer sizer(counter);
+//   ... encode into sizer ...
+//   buffer.reserve(counter.size());
+//   protoc::output_container<unsigned char, std::vector> output(buffer);
+//
+// The counter works with every writer and output archive. The encoders write
+// into a small internal window that is reused, so the counter never holds
+// more than the largest single value.
+template<typename Value>
+class output_counter : public output<Value>
+{
+public:
+    typedef typename output<Value>::value_type value_type;
+    typedef typename output<Value>::size_type size_type;
+
+public:
+    output_counter();
+
+    // Number of values written
+    size_type size() const;
+    void clear();
+
+private:
+    // Implementation of protoc::output interface
+    virtual bool grow(size_type delta);
+    virtual void write(value_type value);
+    virtual void write(const value_type*, size_type);
+    virtual bool overflow(size_type);
+
+private:
+    // Values written before the current window
+    size_type counted;
+    std::vector<value_type> scratch;
+};
+
+} // namespace protoc
+
+#include <protoc/impl/output_counter.ipp>
+
+#endif /* PROTOC_OUTPUT_COUNTER_HPP */
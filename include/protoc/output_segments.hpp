@@ -0,0 +1,106 @@
+#ifndef PROTOC_OUTPUT_SEGMENTS_HPP
+#define PROTOC_OUTPUT_SEGMENTS_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <vector>
+#include <protoc/output.hpp>
+
+namespace protoc
+{
+
+// Scatter-gather output
+//
+// Encoded data is collected as a list of segments. Binary payloads of at
+// least the threshold size are not copied, but become segments that refer
+// to the payload passed to the writer; everything else is copied into an
+// internal buffer. The segments can be handed to writev() or similar calls:
+//
+//   protoc::output_segments<unsigned char> output(64 * 1024);
+//   protoc::msgpack::writer writer(output);
+//   writer.write(image.data(), image.size());
+//   const std::vector<protoc::output_segments<unsigned char>::segment>& list = output.segments();
+//   std::vector<struct iovec> vector(list.size());
+//   for (std::size_t i = 0; i < list.size(); ++i)
+//   {
+//       vector[i].iov_base = const_cast<unsigned char *>(list[i].data);
+//       vector[i].iov_len = list[i].size;
+//   }
+//   ::writev(descriptor, vector.data(), vector.size());
+//
+// Referenced payloads must outlive the segments. Only the msgpack and
+// transenc binary encoders pass payloads by reference; strings are always
+// copied because writers are often given temporaries.
+template<typename Value>
+class output_segments : public output<Value>
+{
+public:
+    typedef typename output<Value>::value_type value_type;
+    typedef typename output<Value>::size_type size_type;
+
+    struct segment
+    {
+        const value_type *data;
+        size_type size;
+    };
+
+public:
+    // Payloads of at least threshold values are referenced
+    explicit output_segments(size_type threshold = 4096);
+
+    // Total number of values in all segments
+    size_type size() const;
+    void clear();
+
+    // Segments in output order. The list is valid until the next write.
+    const std::vector<segment>& segments();
+
+    virtual void reference(const value_type *, size_type);
+
+private:
+    // Implementation of protoc::output interface
+    virtual bool grow(size_type delta);
+    virtual void write(value_type value);
+    virtual void write(const value_type*, size_type);
+    virtual bool overflow(size_type);
+
+    size_type used() const;
+
+private:
+    // Parts of the output, where inline parts are stored as offsets into
+    // the buffer because the buffer moves when it grows
+    struct part
+    {
+        const value_type *external;
+        size_type offset;
+        size_type size;
+    };
+    std::vector<part> parts;
+    // Start of the inline data that is not yet in parts
+    size_type pending;
+    size_type referenced;
+    std::vector<value_type> buffer;
+    std::vector<segment> list;
+};
+
+} // namespace protoc
+
+#include <protoc/impl/output_segments.ipp>
+
+#endif /* PROTOC_OUTPUT_SEGMENTS_HPP */
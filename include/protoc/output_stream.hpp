@@ -54,11 +54,8 @@ private:
 
     virtual void write(const value_type *values, size_type size)
     {
-        for (size_type i = 0; i < size; ++i)
-        {
-            assert(grow(1));
-            write(values[i]);
-        }
+        stream.write(reinterpret_cast<const char *>(values),
+                     size * sizeof(value_type));
     }
 
 private:
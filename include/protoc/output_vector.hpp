@@ -43,6 +43,9 @@ public:
 
     size_type size() const;
     size_type capacity() const;
+    // Makes room for a total of the given number of values, so that
+    // encoding up to that size does not reallocate
+    void reserve_capacity(size_type);
 
     const_reference operator [] (size_type ix) const;
 
@@ -51,8 +54,15 @@ private:
     virtual bool grow(size_type delta);
     virtual void write(value_type value);
     virtual void write(const value_type*, size_type);
+    virtual bool overflow(size_type);
+    virtual bool rewritable() const;
+    virtual size_type position() const;
+    virtual value_type *rewrite(size_type offset);
+    virtual void truncate(size_type offset);
 
 private:
+    // The buffer is sized ahead of the inserted elements, and the window
+    // covers the part that has not been used yet.
     std::vector<value_type> buffer;
 };
 
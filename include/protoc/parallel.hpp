@@ -0,0 +1,118 @@
+#ifndef PROTOC_PARALLEL_HPP
+#define PROTOC_PARALLEL_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+#include <boost/thread/mutex.hpp>
+
+// Parallel decoding of record streams
+//
+// Streams of independent documents, such as newline-delimited JSON or
+// back-to-back msgpack or transenc messages, are first split into records
+// with the split() function of protoc/<codec>/split.hpp. The records are
+// then decoded concurrently with decode_parallel():
+//
+//   std::vector<protoc::string_view> records;
+//   protoc::json::split(input.data(), input.data() + input.size(), records);
+//   std::vector<message> results;
+//   protoc::decode_parallel(records, results, decode_message());
+//
+// The function object is called with a record and returns the decoded
+// result, typically by constructing a reader over the record. Each worker
+// thread uses its own copy of the function object.
+
+namespace protoc
+{
+
+// Calls function(records[i]) on a pool of worker threads and stores the
+// returned value in results[i], so the results are in the same order as
+// the records. Contiguous shards of records with similar byte sizes are
+// handed out to the workers as they become idle. If threads is zero, the
+// number of hardware threads is used. Result cannot be bool, because the
+// elements of std::vector<bool> cannot be assigned concurrently.
+//
+// If decoding throws, the exception of the first failing record is rethrown
+// once all workers have stopped. protoc::unexpected_token, invalid_value and
+// invalid_scope keep their type; other exceptions are rethrown as
+// std::runtime_error with the same message.
+template <typename Record, typename Result, typename Function>
+void decode_parallel(const std::vector<Record>& records,
+                     std::vector<Result>& results,
+                     Function function,
+                     std::size_t threads = 0);
+
+namespace detail
+{
+
+template <typename Record, typename Result, typename Function>
+class parallel_decoder
+{
+public:
+    parallel_decoder(const std::vector<Record>& records,
+                     std::vector<Result>& results,
+                     const Function& function,
+                     std::size_t shards);
+
+    void run(std::size_t threads);
+
+private:
+    void work();
+    void stop();
+    bool next_shard(std::size_t& first, std::size_t& last);
+    void fail(std::size_t index, int kind, const std::string& message);
+    void rethrow() const;
+
+private:
+    const std::vector<Record>& records;
+    std::vector<Result>& results;
+    const Function& function;
+    // Index of the first record of each shard, followed by the end
+    std::vector<std::size_t> boundaries;
+
+    boost::mutex mutex;
+    std::size_t next;
+
+    struct failure
+    {
+        enum kind
+        {
+            none,
+            unexpected_token,
+            invalid_value,
+            invalid_scope,
+            other
+        };
+
+        failure();
+
+        int kind;
+        std::size_t index;
+        std::string message;
+    };
+    failure error;
+};
+
+} // namespace detail
+} // namespace protoc
+
+#include <protoc/impl/parallel.ipp>
+
+#endif /* PROTOC_PARALLEL_HPP */
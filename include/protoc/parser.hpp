@@ -18,17 +18,42 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-namespace protoc
-{
+#include <boost/range/iterator_range.hpp>
 
-class parser
+// Push parsing
+//
+// The parse() functions in protoc/<codec>/parser.hpp decode a buffer in one
+// go and call the handler for every value. The handler is a template
+// parameter, so the calls are resolved at compile time and can be inlined.
+// It must provide the following member functions:
+//
+//   void on_null();
+//   void on_bool(bool);
+//   void on_int(protoc::int64_t);
+//   void on_double(protoc::float64_t);
+//   void on_string(const protoc::string_view&);
+//   void on_array_begin();
+//   void on_array_end();
+//   void on_map_begin(); // Followed by alternating keys and values
+//   void on_map_end();
+//
+// Codecs with binary data or records additionally call
+//
+//   void on_binary(const protoc::binary_view&);
+//   void on_record_begin();
+//   void on_record_end();
+//
+// Views refer to the input buffer, or to an internal buffer for strings
+// that must be unescaped, and are only valid during the call. Malformed
+// input is reported with protoc::unexpected_token or protoc::invalid_value
+// after the handler has seen the preceding values.
+
+namespace protoc
 {
-public:
-    bool parse(const std::string&);
 
-private:
-};
+typedef boost::iterator_range<const char *> string_view;
+typedef boost::iterator_range<const unsigned char *> binary_view;
 
-}
+} // namespace protoc
 
 #endif /* PROTOC_PARSER_HPP */
@@ -0,0 +1,101 @@
+#ifndef PROTOC_QUERY_HPP
+#define PROTOC_QUERY_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+#include <protoc/token.hpp>
+#include <protoc/transcoder.hpp>
+
+// Path queries
+//
+// A protoc::path is a compiled JSON Pointer (RFC 6901), such as "/user/id",
+// that selects a value within a document. The query() functions evaluate
+// paths against the value at the current position of a reader:
+//
+//   protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+//   if (protoc::query(reader, protoc::path("/user/id")))
+//   {
+//       long long id = reader.get_long_long();
+//   }
+//
+// The reader only descends into map entries with matching keys and array
+// elements with matching indices. All other subtrees are skipped with
+// next_sibling(), so their values are neither decoded nor copied. Several
+// paths can be evaluated in a single pass over the document, in which case
+// a visitor is called as each value is found.
+
+namespace protoc
+{
+
+class path
+{
+public:
+    typedef std::size_t size_type;
+
+    static const size_type npos = size_type(-1);
+
+    // The whole document
+    path();
+    // Compiles a JSON Pointer. Throws protoc::invalid_value if the pointer
+    // is not empty and does not start with '/', or if it contains an
+    // invalid escape sequence.
+    explicit path(const char *pointer);
+    explicit path(const std::string& pointer);
+
+    // Number of reference tokens
+    size_type size() const;
+    bool empty() const;
+
+    // Unescaped map key of token n
+    const std::string& key(size_type n) const;
+    // Array index of token n, or npos if the token is not an array index
+    size_type index(size_type n) const;
+
+private:
+    void compile(const char *first, const char *last);
+
+private:
+    struct segment
+    {
+        std::string key;
+        size_type index;
+    };
+    std::vector<segment> segments;
+};
+
+// Moves the reader to the value selected by the path. Returns false if the
+// document does not contain the value, in which case the reader is left
+// after the document.
+template <typename Reader>
+bool query(Reader& input, const path& where);
+
+// Evaluates all paths in a single pass over the document, and calls
+// visitor(n, input) when the value selected by paths[n] is found. The
+// visitor must not advance the reader. The pass stops as soon as all paths
+// have been found, and the number of paths found is returned.
+template <typename Reader, typename Visitor>
+std::size_t query(Reader& input, const std::vector<path>& paths, Visitor& visitor);
+
+} // namespace protoc
+
+#include <protoc/impl/query.ipp>
+
+#endif /* PROTOC_QUERY_HPP */
@@ -33,6 +33,7 @@ public:
     typedef value_type * pointer;
     typedef std::size_t size_type;
     typedef boost::iterator_range<pointer> range_type;
+    typedef boost::iterator_range<const char *> string_view_type;
 
     virtual ~reader() {}
 
@@ -48,6 +49,12 @@ public:
     virtual long long get_long_long() const = 0;
     virtual double get_double() const = 0;
     virtual std::string get_string() const = 0;
+    // Returns the string as it appears in the input without copying it.
+    // The view is only valid as long as the input buffer. If has_escapes()
+    // is true, the view contains escape sequences and get_string() must be
+    // used to obtain the decoded string.
+    virtual string_view_type get_string_view() const = 0;
+    virtual bool has_escapes() const = 0;
     virtual range_type get_range() const = 0;
 };
 
@@ -0,0 +1,203 @@
+#ifndef PROTOC_RECORD_INDEX_HPP
+#define PROTOC_RECORD_INDEX_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cassert>
+#include <cstddef> // std::size_t
+#include <string>
+#include <vector>
+#include <protoc/types.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/parser.hpp>
+
+// Sidecar index for random access into record streams
+//
+// Streams of back-to-back msgpack or transenc records are split with the
+// split() function of protoc/<codec>/split.hpp, and the index stores the
+// byte offset of each record, optionally together with a key. The index is
+// saved next to the stream, so a record can later be located without
+// decoding the records in front of it:
+//
+//   std::vector<protoc::binary_view> records;
+//   protoc::msgpack::split(first, last, records);
+//   protoc::record_index index(first, records);
+//   index.save(sidecar);
+//   ...
+//   protoc::record_index index(sidecar.data(), sidecar.data() + sidecar.size());
+//   protoc::binary_view record = index.record(first, last, 42);
+//   protoc::msgpack::reader reader(record.begin(), record.end());
+//
+// A range of records is also contiguous, so a single reader can decode the
+// view returned by range(). Offsets are relative to the start of the stream,
+// which is typically the data of a protoc::mapped_file. A loaded index may
+// be stale or corrupt, so the views are checked against the end of the
+// stream.
+//
+// The saved index is little-endian: a header with the magic "PRIX", a
+// version and flags byte, two reserved bytes and the 64-bit record count,
+// followed by the count + 1 64-bit offsets of the record boundaries. Keyed
+// indexes continue with the record numbers ordered by key and then the
+// 32-bit length and bytes of each key in record order.
+
+namespace protoc
+{
+
+class record_index
+{
+public:
+    typedef std::size_t size_type;
+    typedef protoc::uint64_t offset_type;
+
+    static const size_type npos = size_type(-1);
+
+    // Empty index of a stream that starts at offset 0
+    record_index();
+    // Index of the records produced by split(), relative to begin
+    record_index(const unsigned char *begin,
+                 const std::vector<protoc::binary_view>& records);
+    // As above, with the key of each record given by key(record), which
+    // must return a std::string
+    template <typename KeyFunction>
+    record_index(const unsigned char *begin,
+                 const std::vector<protoc::binary_view>& records,
+                 KeyFunction key);
+    // Loads a saved index. Malformed input throws protoc::invalid_value
+    record_index(const unsigned char *first, const unsigned char *last);
+
+    // Appends the record between the byte offsets first and last. Records
+    // must be contiguous, so first must equal the end of the previous
+    // record, or protoc::invalid_value is thrown. An index has either keys
+    // for all records or none.
+    void push_back(offset_type first, offset_type last);
+    void push_back(offset_type first, offset_type last, const std::string& key);
+
+    size_type size() const;
+    bool empty() const;
+    bool has_keys() const;
+
+    offset_type offset(size_type n) const;
+    offset_type length(size_type n) const;
+    const std::string& key(size_type n) const;
+
+    // Number of the first record with the given key, or npos if not found.
+    // The lookup is a binary search over the sorted keys.
+    size_type find(const std::string& key) const;
+
+    // View of record n, or of the records from first to last, in the
+    // stream between begin and end. Records beyond the end of the stream
+    // throw protoc::invalid_value
+    protoc::binary_view record(const unsigned char *begin,
+                               const unsigned char *end,
+                               size_type n) const;
+    protoc::binary_view range(const unsigned char *begin,
+                              const unsigned char *end,
+                              size_type first,
+                              size_type last) const;
+
+    // Appends the serialized index to output
+    void save(std::vector<unsigned char>& output) const;
+
+private:
+    void assign(const unsigned char *begin,
+                const std::vector<protoc::binary_view>& records);
+    void sort_keys();
+    void append_offsets(offset_type first, offset_type last);
+    void load(const unsigned char *first, const unsigned char *last);
+
+private:
+    // Boundaries of the records, so record n spans offsets n and n + 1
+    std::vector<offset_type> offsets;
+    // Keys in record order
+    std::vector<std::string> keys;
+    // Record numbers ordered by key, and by record number for equal keys
+    std::vector<size_type> order;
+};
+
+template <typename KeyFunction>
+record_index::record_index(const unsigned char *begin,
+                           const std::vector<protoc::binary_view>& records,
+                           KeyFunction key)
+{
+    assign(begin, records);
+    keys.reserve(records.size());
+    for (std::vector<protoc::binary_view>::const_iterator it = records.begin();
+         it != records.end();
+         ++it)
+    {
+        keys.push_back(key(*it));
+    }
+    sort_keys();
+}
+
+inline record_index::size_type record_index::size() const
+{
+    return offsets.size() - 1;
+}
+
+inline bool record_index::empty() const
+{
+    return (offsets.size() == 1);
+}
+
+inline bool record_index::has_keys() const
+{
+    return !order.empty();
+}
+
+inline record_index::offset_type record_index::offset(size_type n) const
+{
+    assert(n < size());
+    return offsets[n];
+}
+
+inline record_index::offset_type record_index::length(size_type n) const
+{
+    assert(n < size());
+    return offsets[n + 1] - offsets[n];
+}
+
+inline const std::string& record_index::key(size_type n) const
+{
+    assert(n < keys.size());
+    return keys[n];
+}
+
+inline protoc::binary_view record_index::record(const unsigned char *begin,
+                                                const unsigned char *end,
+                                                size_type n) const
+{
+    return range(begin, end, n, n + 1);
+}
+
+inline protoc::binary_view record_index::range(const unsigned char *begin,
+                                               const unsigned char *end,
+                                               size_type first,
+                                               size_type last) const
+{
+    assert(first <= last);
+    assert(last <= size());
+    assert(begin <= end);
+    if (offsets[last] > offset_type(end - begin))
+        throw invalid_value("record_index: record beyond end of stream");
+    return protoc::binary_view(begin + offsets[first], begin + offsets[last]);
+}
+
+} // namespace protoc
+
+#endif /* PROTOC_RECORD_INDEX_HPP */
@@ -19,7 +19,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <map>
+#include <utility> // std::swap
 #include <boost/serialization/split_free.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/serialization/serialization.hpp>
 #include <protoc/serialization/pair.hpp>
 
@@ -49,6 +51,9 @@ struct save_functor< Archive, typename std::map<Key, T, Compare, Allocator> >
 template <typename Archive, typename Key, typename T, typename Compare, typename Allocator>
 struct load_functor< Archive, typename std::map<Key, T, Compare, Allocator> >
 {
+    typedef typename std::map<Key, T, Compare, Allocator>::value_type value_type;
+    typedef typename std::map<Key, T, Compare, Allocator>::iterator iterator;
+
     void operator () (Archive& ar,
                       std::map<Key, T, Compare, Allocator>& data,
                       const unsigned int version)
@@ -57,14 +62,34 @@ struct load_functor< Archive, typename std::map<Key, T, Compare, Allocator> >
         while (!ar.at_map_end())
         {
             // We cannot use std::map<Key, T>::value_type because it has a const key
-            std::pair<Key, T> value;
+            std::pair<Key, T> value(construct_functor<Key>()(ar),
+                                    construct_functor<T>()(ar));
             ar.load_override(value, version);
-            data.insert(value);
+            // Only the key is copied. The mapped value is swapped in.
+            std::pair<iterator, bool> where
+                = data.insert(value_type(value.first, construct_functor<T>()(ar)));
+            if (where.second)
+            {
+                using std::swap;
+                swap(where.first->second, value.second);
+            }
         }
         ar.load_map_end();
     }
 };
 
+template <typename Key, typename T, typename Compare>
+struct construct_functor< typename std::map<Key, T, Compare, protoc::polymorphic_allocator<std::pair<const Key, T> > > >
+{
+    typedef std::map<Key, T, Compare, protoc::polymorphic_allocator<std::pair<const Key, T> > > value_type;
+
+    template <typename Archive>
+    value_type operator () (Archive& ar) const
+    {
+        return value_type(Compare(), typename value_type::allocator_type(&ar.resource()));
+    }
+};
+
 template <typename Key, typename T, typename Compare, typename Allocator>
 struct serialize_functor< typename std::map<Key, T, Compare, Allocator> >
 {
@@ -54,6 +54,20 @@ struct load_functor
     }
 };
 
+// Creates the elements of containers during loading.
+//
+// Specialized for allocator-aware types using protoc::polymorphic_allocator
+// so that elements obtain their memory from the resource of the archive.
+template <typename Value>
+struct construct_functor
+{
+    template <typename Archive>
+    Value operator () (Archive&) const
+    {
+        return Value();
+    }
+};
+
 template <typename Value>
 struct serialize_functor
 {
@@ -55,7 +55,9 @@ struct load_functor< Archive, typename std::set<Key, Compare, Allocator> >
         ar.load_array_begin();
         while (!ar.at_array_end())
         {
-            Key value;
+            // Set elements cannot be modified, so the key is loaded before
+            // being copied into the set
+            Key value = construct_functor<Key>()(ar);
             ar.load_override(value, version);
             data.insert(value);
         }
@@ -21,6 +21,7 @@
 #include <string>
 #include <boost/utility/enable_if.hpp>
 #include <boost/serialization/split_free.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/serialization/serialization.hpp>
 
 namespace boost
@@ -50,6 +51,18 @@ struct load_functor< Archive, typename std::basic_string<CharT, Traits, Allocato
     }
 };
 
+template <typename CharT, typename Traits>
+struct construct_functor< typename std::basic_string<CharT, Traits, protoc::polymorphic_allocator<CharT> > >
+{
+    typedef std::basic_string<CharT, Traits, protoc::polymorphic_allocator<CharT> > value_type;
+
+    template <typename Archive>
+    value_type operator () (Archive& ar) const
+    {
+        return value_type(typename value_type::allocator_type(&ar.resource()));
+    }
+};
+
 template <typename CharT, typename Traits, typename Allocator>
 struct serialize_functor< typename std::basic_string<CharT, Traits, Allocator> >
 {
@@ -18,10 +18,28 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <vector>
 #include <boost/serialization/split_free.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/serialization/serialization.hpp>
 
+namespace protoc
+{
+namespace detail
+{
+
+// The element count of an array is read from the input, so only a bounded
+// part of it is allocated before the elements have been loaded
+inline std::size_t initial_count(std::size_t count)
+{
+    const std::size_t max_initial_count = 4 * 1024;
+    return std::min(count, max_initial_count);
+}
+
+} // namespace detail
+} // namespace protoc
+
 namespace boost
 {
 namespace serialization
@@ -45,6 +63,20 @@ struct save_functor< Archive, typename std::vector<T, Allocator> >
     }
 };
 
+// Saves a vector of numbers with a single call to save_array(). Archives
+// that encode such arrays in bulk specialize save_functor for the element
+// types they support by deriving from this functor.
+template <typename Archive, typename T, typename Allocator>
+struct save_array_functor
+{
+    void operator () (Archive& ar,
+                      const std::vector<T, Allocator>& data,
+                      const unsigned int /* version */)
+    {
+        ar.save_array(data.empty() ? 0 : &data[0], data.size());
+    }
+};
+
 template <typename Archive, typename T, typename Allocator>
 struct load_functor< Archive, typename std::vector<T, Allocator> >
 {
@@ -56,11 +88,35 @@ struct load_functor< Archive, typename std::vector<T, Allocator> >
         boost::optional<std::size_t> count = ar.load_array_begin();
         if (count)
         {
-            data.reserve(*count);
+            data.reserve(protoc::detail::initial_count(*count));
         }
         while (!ar.at_array_end())
         {
-            T value;
+            // The element is loaded in place to avoid copying its content
+            data.push_back(construct_functor<T>()(ar));
+            ar.load_override(data.back(), version);
+        }
+        ar.load_array_end();
+    }
+};
+
+// Elements of std::vector<bool> cannot be referenced, so they are loaded
+// through a temporary
+template <typename Archive, typename Allocator>
+struct load_functor< Archive, typename std::vector<bool, Allocator> >
+{
+    void operator () (Archive& ar,
+                      std::vector<bool, Allocator>& data,
+                      const unsigned int version)
+    {
+        boost::optional<std::size_t> count = ar.load_array_begin();
+        if (count)
+        {
+            data.reserve(protoc::detail::initial_count(*count));
+        }
+        while (!ar.at_array_end())
+        {
+            bool value = false;
             ar.load_override(value, version);
             data.push_back(value);
         }
@@ -68,6 +124,65 @@ struct load_functor< Archive, typename std::vector<T, Allocator> >
     }
 };
 
+// Loads a vector of numbers with load_array(), which decodes a run of
+// elements of the expected type in one call. The element count, when the
+// archive provides one, sizes the vector up front within a bound, because
+// the input may overstate it. Any element that breaks the run is loaded on
+// its own before bulk loading resumes.
+template <typename Archive, typename T, typename Allocator>
+struct load_array_functor
+{
+    void operator () (Archive& ar,
+                      std::vector<T, Allocator>& data,
+                      const unsigned int version)
+    {
+        typedef typename std::vector<T, Allocator>::size_type size_type;
+        boost::optional<std::size_t> count = ar.load_array_begin();
+        const size_type first = data.size();
+        size_type size = first;
+        if (count)
+        {
+            data.resize(size + protoc::detail::initial_count(*count));
+        }
+        while (!ar.at_array_end())
+        {
+            if (size == data.size())
+            {
+                // Unknown or wrong count, or more elements than allocated
+                // up front. Growth stops at the count while it holds.
+                size_type grown = std::max<size_type>(2 * size, 16);
+                const size_type done = size - first;
+                if (count && (done < *count))
+                {
+                    grown = std::min<size_type>(grown, size + (*count - done));
+                }
+                data.resize(grown);
+            }
+            const size_type loaded = ar.load_array(&data[size], data.size() - size);
+            size += loaded;
+            if ((loaded == 0) && !ar.at_array_end())
+            {
+                ar.load_override(data[size], version);
+                ++size;
+            }
+        }
+        data.resize(size);
+        ar.load_array_end();
+    }
+};
+
+template <typename T>
+struct construct_functor< typename std::vector<T, protoc::polymorphic_allocator<T> > >
+{
+    typedef std::vector<T, protoc::polymorphic_allocator<T> > value_type;
+
+    template <typename Archive>
+    value_type operator () (Archive& ar) const
+    {
+        return value_type(typename value_type::allocator_type(&ar.resource()));
+    }
+};
+
 template <typename T, typename Allocator>
 struct serialize_functor< typename std::vector<T, Allocator> >
 {
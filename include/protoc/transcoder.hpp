@@ -0,0 +1,224 @@
+#ifndef PROTOC_TRANSCODER_HPP
+#define PROTOC_TRANSCODER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <string>
+#include <protoc/token.hpp>
+#include <protoc/exceptions.hpp>
+
+// Transcoding
+//
+// The transcode() functions convert the input of a reader directly into the
+// output of a writer, token by token, without building an intermediate
+// representation. Any reader with the protoc::reader interface can be used
+// as input, and any writer with the protoc::writer interface as output.
+//
+//   protoc::json::reader reader(input.begin(), input.end());
+//   protoc::msgpack::writer writer(output, protoc::msgpack::writer::count_deferred);
+//   protoc::transcode(reader, writer);
+//
+// Strings that need no unescaping and binary data are passed from the input
+// buffer to the writer without being copied into temporaries.
+//
+// Readers and writers with other interfaces are supported by specializing
+// transcoder_reader_traits and transcoder_writer_traits. Reader traits are
+// specialized next to the reader, so that they are always in effect; the
+// msgpack reader forwards the element counts of its containers, and the
+// transenc reader consumes the size that follows a container begin. The
+// JSON writer maps the tokens to its own interface in
+// protoc/json/transcoder.hpp.
+
+namespace protoc
+{
+
+// Converts the current value, including nested containers, and advances
+// the reader past it.
+template <typename Reader, typename Writer>
+void transcode_value(Reader& input, Writer& output);
+
+// Converts values until the end of the input.
+template <typename Reader, typename Writer>
+void transcode(Reader& input, Writer& output);
+
+template <typename Reader>
+struct transcoder_reader_traits
+{
+    // Advances past the array or map begin at the current position and
+    // any header that belongs to it. Returns true if the number of elements
+    // of the array, or the number of key-value pairs of the map, is known.
+    static bool container_begin(Reader& input, std::size_t&)
+    {
+        input.next();
+        return false;
+    }
+};
+
+template <typename Writer>
+struct transcoder_writer_traits
+{
+    static void write_null(Writer& output) { output.write(); }
+    static void write_bool(Writer& output, bool value) { output.write(value); }
+    static void write_integer(Writer& output, long long value) { output.write(value); }
+    static void write_floating(Writer& output, double value) { output.write(value); }
+
+    static void write_string(Writer& output, const char *data, std::size_t size)
+    {
+        output.write(data, size);
+    }
+
+    static void write_binary(Writer& output, const unsigned char *data, std::size_t size)
+    {
+        output.write(data, size);
+    }
+
+    static void record_begin(Writer& output) { output.record_begin(); }
+    static void record_end(Writer& output) { output.record_end(); }
+    static void array_begin(Writer& output) { output.array_begin(); }
+    static void array_begin(Writer& output, std::size_t count) { output.array_begin(count); }
+    static void array_end(Writer& output) { output.array_end(); }
+    static void map_begin(Writer& output) { output.map_begin(); }
+    static void map_begin(Writer& output, std::size_t count) { output.map_begin(count); }
+    static void map_end(Writer& output) { output.map_end(); }
+};
+
+} // namespace protoc
+
+namespace protoc
+{
+namespace detail
+{
+
+// Converts the token at the current position and advances past it
+template <typename Reader, typename Writer>
+void transcode_token(Reader& input, Writer& output)
+{
+    typedef transcoder_reader_traits<Reader> reader_traits;
+    typedef transcoder_writer_traits<Writer> writer_traits;
+
+    std::size_t count;
+
+    switch (input.type())
+    {
+    case token::token_null:
+        writer_traits::write_null(output);
+        break;
+
+    case token::token_boolean:
+        writer_traits::write_bool(output, input.get_bool());
+        break;
+
+    case token::token_integer:
+        writer_traits::write_integer(output, input.get_long_long());
+        break;
+
+    case token::token_floating:
+        writer_traits::write_floating(output, input.get_double());
+        break;
+
+    case token::token_string:
+        if (input.has_escapes())
+        {
+            const std::string value = input.get_string();
+            writer_traits::write_string(output, value.data(), value.size());
+        }
+        else
+        {
+            typename Reader::string_view_type value = input.get_string_view();
+            writer_traits::write_string(output, value.begin(), value.size());
+        }
+        break;
+
+    case token::token_binary:
+        {
+            typename Reader::range_type value = input.get_range();
+            writer_traits::write_binary(output, value.begin(), value.size());
+        }
+        break;
+
+    case token::token_record_begin:
+        writer_traits::record_begin(output);
+        break;
+
+    case token::token_record_end:
+        writer_traits::record_end(output);
+        break;
+
+    case token::token_array_begin:
+        if (reader_traits::container_begin(input, count))
+        {
+            writer_traits::array_begin(output, count);
+        }
+        else
+        {
+            writer_traits::array_begin(output);
+        }
+        return;
+
+    case token::token_array_end:
+        writer_traits::array_end(output);
+        break;
+
+    case token::token_map_begin:
+        if (reader_traits::container_begin(input, count))
+        {
+            writer_traits::map_begin(output, count);
+        }
+        else
+        {
+            writer_traits::map_begin(output);
+        }
+        return;
+
+    case token::token_map_end:
+        writer_traits::map_end(output);
+        break;
+
+    case token::token_eof:
+        throw unexpected_token("unexpected end of input");
+    }
+    input.next();
+}
+
+} // namespace detail
+
+template <typename Reader, typename Writer>
+void transcode_value(Reader& input, Writer& output)
+{
+    // The nesting depth returns to its initial value once the end of the
+    // outermost container has been passed
+    const std::size_t depth = input.size();
+    do
+    {
+        detail::transcode_token(input, output);
+    } while (input.size() > depth);
+}
+
+template <typename Reader, typename Writer>
+void transcode(Reader& input, Writer& output)
+{
+    while (input.type() != token::token_eof)
+    {
+        transcode_value(input, output);
+    }
+}
+
+} // namespace protoc
+
+#endif /* PROTOC_TRANSCODER_HPP */
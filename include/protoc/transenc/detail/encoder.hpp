@@ -43,8 +43,19 @@ public:
     std::size_t put(protoc::float64_t);
     std::size_t put(const char *);
     std::size_t put(const std::string&);
+    std::size_t put(const char *, std::size_t);
     std::size_t put(const unsigned char *, std::size_t);
 
+    // Encodes consecutive values as individual put() calls would, but with
+    // one reservation of the output per block of values. Stops at the first
+    // value that does not fit in the output, and stores the number of values
+    // written in the optional last argument.
+    std::size_t put_values(const int *, std::size_t, std::size_t * = 0);
+    std::size_t put_values(const long *, std::size_t, std::size_t * = 0);
+    std::size_t put_values(const long long *, std::size_t, std::size_t * = 0);
+    std::size_t put_values(const float *, std::size_t, std::size_t * = 0);
+    std::size_t put_values(const double *, std::size_t, std::size_t * = 0);
+
     std::size_t put_record_begin();
     std::size_t put_record_end();
     std::size_t put_array_begin();
@@ -62,13 +73,27 @@ private:
     std::size_t put_token(value_type);
     std::size_t put_size_t(std::size_t);
 
-    std::size_t write(protoc::int8_t);
-    std::size_t write(protoc::uint8_t);
-    std::size_t write(protoc::int16_t);
-    std::size_t write(protoc::uint16_t);
-    std::size_t write(protoc::int32_t);
-    std::size_t write(protoc::uint32_t);
-    std::size_t write(protoc::int64_t);
+    template <typename T>
+    std::size_t put_payload(value_type, T, const value_type *, std::size_t);
+    template <typename T>
+    std::size_t put_binary(value_type, T, const value_type *, std::size_t);
+    template <typename T>
+    std::size_t put_integers(const T *, std::size_t, std::size_t *);
+    template <typename T>
+    std::size_t put_floats(value_type, const T *, std::size_t, std::size_t *);
+
+    value_type *write_integer(value_type *, protoc::int64_t);
+
+    value_type *write(value_type *, protoc::int8_t);
+    value_type *write(value_type *, protoc::uint8_t);
+    value_type *write(value_type *, protoc::int16_t);
+    value_type *write(value_type *, protoc::uint16_t);
+    value_type *write(value_type *, protoc::int32_t);
+    value_type *write(value_type *, protoc::uint32_t);
+    value_type *write(value_type *, protoc::int64_t);
+    value_type *write(value_type *, protoc::uint64_t);
+    value_type *write(value_type *, protoc::float32_t);
+    value_type *write(value_type *, protoc::float64_t);
 
 private:
     output_type& buffer;
@@ -22,6 +22,7 @@
 #include <boost/optional.hpp>
 #include <boost/archive/detail/common_iarchive.hpp>
 #include <boost/archive/detail/register_archive.hpp>
+#include <protoc/memory_resource.hpp>
 #include <protoc/transenc/reader.hpp>
 
 namespace protoc
@@ -38,8 +39,16 @@ public:
     typedef transenc::reader::value_type value_type;
 
     iarchive(const transenc::reader&);
+    iarchive(const transenc::reader&, protoc::memory_resource&);
     template <typename Iterator>
     iarchive(Iterator begin, Iterator end);
+    // Allocator-aware values created during loading, such as strings and
+    // containers using protoc::polymorphic_allocator, obtain their memory
+    // from the resource.
+    template <typename Iterator>
+    iarchive(Iterator begin, Iterator end, protoc::memory_resource&);
+    explicit iarchive(const protoc::mapped_file&);
+    iarchive(const protoc::mapped_file&, protoc::memory_resource&);
 
     template<typename value_type>
     void load_override(value_type& data, long /*version*/)
@@ -54,10 +63,19 @@ public:
     void load(float&);
     void load(double&);
     void load(std::string&);
+    template <typename Traits, typename Allocator>
+    void load(std::basic_string<char, Traits, Allocator>&);
 
     std::size_t load_binary_begin();
     void load(void *, std::size_t);
 
+    // Arrays of numbers that are decoded in bulk. Loads up to size
+    // consecutive elements and returns how many were loaded.
+    std::size_t load_array(int *, std::size_t);
+    std::size_t load_array(long long *, std::size_t);
+    std::size_t load_array(float *, std::size_t);
+    std::size_t load_array(double *, std::size_t);
+
     void load_record_begin();
     void load_record_end();
 
@@ -81,8 +99,11 @@ public:
     void load(boost::archive::tracking_type) {}
     void load(boost::archive::class_name_type&) {}
 
+    protoc::memory_resource& resource() const;
+
 private:
     transenc::reader reader;
+    protoc::memory_resource *memory;
 };
 
 } // namespace transenc
@@ -100,13 +121,43 @@ namespace transenc
 {
 
 inline iarchive::iarchive(const transenc::reader& reader)
-    : reader(reader)
+    : reader(reader),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const transenc::reader& reader,
+                          protoc::memory_resource& resource)
+    : reader(reader),
+      memory(&resource)
 {
 }
 
 template <typename Iterator>
 inline iarchive::iarchive(Iterator begin, Iterator end)
-    : reader(begin, end)
+    : reader(begin, end),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+template <typename Iterator>
+inline iarchive::iarchive(Iterator begin, Iterator end,
+                          protoc::memory_resource& resource)
+    : reader(begin, end),
+      memory(&resource)
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file)
+    : reader(file),
+      memory(&protoc::new_delete_resource())
+{
+}
+
+inline iarchive::iarchive(const protoc::mapped_file& file,
+                          protoc::memory_resource& resource)
+    : reader(file),
+      memory(&resource)
 {
 }
 
@@ -155,6 +206,15 @@ inline void iarchive::load(std::string& value)
     reader.next();
 }
 
+template <typename Traits, typename Allocator>
+void iarchive::load(std::basic_string<char, Traits, Allocator>& value)
+{
+    // Copy from the input to avoid a temporary std::string
+    const protoc::reader::string_view_type view = reader.get_string_view();
+    value.assign(view.begin(), view.end());
+    reader.next();
+}
+
 inline std::size_t iarchive::load_binary_begin()
 {
     reader::range_type range = reader.get_range();
@@ -169,6 +229,26 @@ inline void iarchive::load(void *destination, std::size_t size)
     reader.next(protoc::token::token_binary);
 }
 
+inline std::size_t iarchive::load_array(int *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(long long *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(float *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
+inline std::size_t iarchive::load_array(double *data, std::size_t size)
+{
+    return reader.read_values(data, size);
+}
+
 inline void iarchive::load_record_begin()
 {
     reader.next(protoc::token::token_record_begin);
@@ -244,6 +324,11 @@ inline protoc::token::value iarchive::type() const
     return reader.type();
 }
 
+inline protoc::memory_resource& iarchive::resource() const
+{
+    return *memory;
+}
+
 } // namespace transenc
 } // namespace protoc
 
@@ -0,0 +1,204 @@
+#ifndef PROTOC_TRANSENC_PARSER_HPP
+#define PROTOC_TRANSENC_PARSER_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sstream>
+#include <protoc/types.hpp>
+#include <protoc/parser.hpp>
+#include <protoc/nesting_stack.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/transenc/detail/token.hpp>
+#include <protoc/transenc/detail/decoder.hpp>
+
+namespace protoc
+{
+namespace transenc
+{
+
+// Parses a single Transenc value and pushes its content to the handler.
+// See protoc/parser.hpp for the handler interface. The element count that
+// the writers place after an array or map begin is passed on as an ordinary
+// value, just as the reader reports it.
+template <typename Handler>
+void parse(const unsigned char *begin, const unsigned char *end, Handler& handler);
+
+template <typename Container, typename Handler>
+void parse(const Container& buffer, Handler& handler);
+
+} // namespace transenc
+} // namespace protoc
+
+namespace protoc
+{
+namespace transenc
+{
+namespace detail
+{
+
+template <typename Handler>
+class push_parser
+{
+public:
+    push_parser(const unsigned char *begin, const unsigned char *end, Handler& handler)
+        : decoder(begin, end),
+          handler(handler)
+    {
+    }
+
+    void parse()
+    {
+        do
+        {
+            const token type = decoder.type();
+            switch (type)
+            {
+            case token_null:
+                handler.on_null();
+                break;
+
+            case token_true:
+                handler.on_bool(true);
+                break;
+
+            case token_false:
+                handler.on_bool(false);
+                break;
+
+            case token_int8:
+                handler.on_int(decoder.get_int8());
+                break;
+
+            case token_int16:
+                handler.on_int(decoder.get_int16());
+                break;
+
+            case token_int32:
+                handler.on_int(decoder.get_int32());
+                break;
+
+            case token_int64:
+                handler.on_int(decoder.get_int64());
+                break;
+
+            case token_float32:
+                handler.on_double(decoder.get_float32());
+                break;
+
+            case token_float64:
+                handler.on_double(decoder.get_float64());
+                break;
+
+            case token_string:
+                {
+                    const decoder_type::input_range view = decoder.get_string_view();
+                    handler.on_string(protoc::string_view(reinterpret_cast<const char *>(view.begin()),
+                                                          reinterpret_cast<const char *>(view.end())));
+                }
+                break;
+
+            case token_binary:
+                {
+                    const decoder_type::input_range view = decoder.get_range();
+                    handler.on_binary(protoc::binary_view(view.begin(), view.end()));
+                }
+                break;
+
+            case token_record_begin:
+                stack.push(token_record_end);
+                handler.on_record_begin();
+                break;
+
+            case token_array_begin:
+                stack.push(token_array_end);
+                handler.on_array_begin();
+                break;
+
+            case token_map_begin:
+                stack.push(token_map_end);
+                handler.on_map_begin();
+                break;
+
+            case token_record_end:
+                end(type, "expected record end");
+                handler.on_record_end();
+                break;
+
+            case token_array_end:
+                end(type, "expected array end");
+                handler.on_array_end();
+                break;
+
+            case token_map_end:
+                end(type, "expected map end");
+                handler.on_map_end();
+                break;
+
+            default:
+                unexpected(type);
+            }
+            decoder.next();
+        } while (!stack.empty());
+
+        if (decoder.type() != token_eof)
+            unexpected(decoder.type());
+    }
+
+private:
+    void end(token type, const char *message)
+    {
+        if (stack.empty() || stack.top() != type)
+            throw unexpected_token(message);
+        stack.pop();
+    }
+
+    void unexpected(token type)
+    {
+        std::ostringstream error;
+        error << type;
+        throw unexpected_token(error.str());
+    }
+
+private:
+    typedef detail::decoder decoder_type;
+    decoder_type decoder;
+    Handler& handler;
+    // Expected end tokens of the open containers
+    protoc::nesting_stack<token> stack;
+};
+
+} // namespace detail
+
+template <typename Handler>
+void parse(const unsigned char *begin, const unsigned char *end, Handler& handler)
+{
+    detail::push_parser<Handler> parser(begin, end, handler);
+    parser.parse();
+}
+
+template <typename Container, typename Handler>
+void parse(const Container& buffer, Handler& handler)
+{
+    const unsigned char *begin = reinterpret_cast<const unsigned char *>(buffer.data());
+    transenc::parse(begin, begin + buffer.size(), handler);
+}
+
+} // namespace transenc
+} // namespace protoc
+
+#endif /* PROTOC_TRANSENC_PARSER_HPP */
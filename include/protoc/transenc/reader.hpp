@@ -18,8 +18,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
+#include <cstddef> // std::size_t
+#include <protoc/nesting_stack.hpp>
 #include <protoc/reader.hpp>
+#include <protoc/mapped_file.hpp>
 #include <protoc/token.hpp>
 #include <protoc/transenc/detail/token.hpp>
 #include <protoc/transenc/detail/decoder.hpp>
@@ -36,10 +38,14 @@ class reader : public protoc::reader
 public:
     template <typename ForwardIterator>
     reader(ForwardIterator begin, ForwardIterator end);
+    // Views refer directly to the mapping, which must outlive the reader
+    explicit reader(const protoc::mapped_file&);
     reader(const reader&);
 
     virtual protoc::token::value type() const;
     virtual size_type size() const;
+    // Input with deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     virtual bool next();
     virtual bool next(protoc::token::value);
@@ -50,11 +56,30 @@ public:
     virtual long long get_long_long() const;
     virtual double get_double() const;
     virtual std::string get_string() const;
+    virtual string_view_type get_string_view() const;
+    virtual bool has_escapes() const;
     virtual range_type get_range() const;
 
+    // Reads consecutive numbers of the current array into the output and
+    // moves past them. Stops after size values, at the end of the array, or
+    // at the first element that the corresponding get function would reject.
+    // Returns the number of values read.
+    size_type read_values(int *, size_type size);
+    size_type read_values(long long *, size_type size);
+    size_type read_values(float *, size_type size);
+    size_type read_values(double *, size_type size);
+
+private:
+    template <typename T>
+    size_type read_array_values(T *, size_type);
+    bool decode_value(int&) const;
+    bool decode_value(long long&) const;
+    bool decode_value(float&) const;
+    bool decode_value(double&) const;
+
 private:
     decoder_type decoder;
-    std::stack<transenc::detail::token> stack;
+    protoc::nesting_stack<transenc::detail::token> stack;
 };
 
 } // namespace transenc
@@ -74,6 +99,12 @@ reader::reader(ForwardIterator begin, ForwardIterator end)
 {
 }
 
+inline reader::reader(const protoc::mapped_file& file)
+    : decoder(reinterpret_cast<const unsigned char *>(file.data()),
+              reinterpret_cast<const unsigned char *>(file.data()) + file.size())
+{
+}
+
 inline reader::reader(const reader& other)
     : decoder(other.decoder),
       stack(other.stack)
@@ -144,6 +175,11 @@ inline reader::size_type reader::size() const
     return stack.size();
 }
 
+inline void reader::max_depth(size_type depth)
+{
+    stack.max_depth(depth);
+}
+
 inline bool reader::next()
 {
     const transenc::detail::token current = decoder.type();
@@ -214,8 +250,56 @@ inline bool reader::next(protoc::token::value expect)
 
 inline void reader::next_sibling()
 {
-    // FIXME: Skip over children
-    throw unexpected_token("not implemented");
+    const transenc::detail::token current = decoder.type();
+    switch (current)
+    {
+    case transenc::detail::token_record_begin:
+    case transenc::detail::token_array_begin:
+    case transenc::detail::token_map_begin:
+        {
+            // Strings and binaries are skipped via their length prefix by
+            // the decoder, so only the brackets need to be counted
+            std::size_t depth = 1;
+            while (depth > 0)
+            {
+                decoder.next();
+                switch (decoder.type())
+                {
+                case transenc::detail::token_record_begin:
+                case transenc::detail::token_array_begin:
+                case transenc::detail::token_map_begin:
+                    ++depth;
+                    break;
+
+                case transenc::detail::token_record_end:
+                case transenc::detail::token_array_end:
+                case transenc::detail::token_map_end:
+                    --depth;
+                    break;
+
+                case transenc::detail::token_eof:
+                case transenc::detail::token_error:
+                    // Leave eof and error for type()
+                    return;
+
+                default:
+                    break;
+                }
+            }
+            // Continue from the end token as if the children had been
+            // traversed. next() verifies that the end token matches.
+            stack.push((current == transenc::detail::token_record_begin)
+                       ? transenc::detail::token_record_end
+                       : (current == transenc::detail::token_array_begin)
+                       ? transenc::detail::token_array_end
+                       : transenc::detail::token_map_end);
+        }
+        break;
+
+    default:
+        break;
+    }
+    next();
 }
 
 inline bool reader::get_bool() const
@@ -318,13 +402,187 @@ inline std::string reader::get_string() const
     }
 }
 
+inline reader::string_view_type reader::get_string_view() const
+{
+    const transenc::detail::token current = decoder.type();
+    switch (current)
+    {
+    case transenc::detail::token_string:
+        {
+            const transenc::detail::decoder::input_range range = decoder.get_string_view();
+            return string_view_type(reinterpret_cast<const char *>(range.begin()),
+                                    reinterpret_cast<const char *>(range.end()));
+        }
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
+inline bool reader::has_escapes() const
+{
+    // Strings are stored verbatim
+    (void)get_string_view();
+    return false;
+}
+
 inline reader::range_type reader::get_range() const
 {
     transenc::detail::decoder::input_range range = decoder.get_range();
     return boost::make_iterator_range(range.begin(), range.end());
 }
 
+inline reader::size_type reader::read_values(int *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+inline reader::size_type reader::read_values(long long *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+inline reader::size_type reader::read_values(float *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+inline reader::size_type reader::read_values(double *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+template <typename T>
+reader::size_type reader::read_array_values(T *output, size_type size)
+{
+    if (stack.empty() || (stack.top() != transenc::detail::token_array_end))
+        return 0;
+
+    // Scalars never change the nesting, so the stack is left alone and the
+    // array end token stops the loop as a mismatch
+    size_type result = 0;
+    while ((result < size) && decode_value(output[result]))
+    {
+        ++result;
+        decoder.next();
+    }
+    return result;
+}
+
+// Mirror the get functions, but report a mismatch instead of throwing so
+// that bulk reads can stop there
+
+inline bool reader::decode_value(int& value) const
+{
+    switch (decoder.type())
+    {
+    case transenc::detail::token_int8:
+        value = decoder.get_int8();
+        return true;
+
+    case transenc::detail::token_int16:
+        value = decoder.get_int16();
+        return true;
+
+    case transenc::detail::token_int32:
+        value = decoder.get_int32();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+inline bool reader::decode_value(long long& value) const
+{
+    switch (decoder.type())
+    {
+    case transenc::detail::token_int8:
+        value = decoder.get_int8();
+        return true;
+
+    case transenc::detail::token_int16:
+        value = decoder.get_int16();
+        return true;
+
+    case transenc::detail::token_int32:
+        value = decoder.get_int32();
+        return true;
+
+    case transenc::detail::token_int64:
+        value = decoder.get_int64();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+inline bool reader::decode_value(float& value) const
+{
+    double result;
+    if (!decode_value(result))
+        return false;
+    value = result;
+    return true;
+}
+
+inline bool reader::decode_value(double& value) const
+{
+    switch (decoder.type())
+    {
+    case transenc::detail::token_float32:
+        value = decoder.get_float32();
+        return true;
+
+    case transenc::detail::token_float64:
+        value = decoder.get_float64();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
 } // namespace transenc
 } // namespace protoc
 
+namespace protoc
+{
+
+// Declared here so that the specialization is visible wherever the reader
+// is, whether or not protoc/transcoder.hpp is included
+template <typename Reader>
+struct transcoder_reader_traits;
+
+// The writers place the element count, or null if the count is unknown,
+// after an array or map begin. The reader reports it as an ordinary value,
+// so it is consumed here and passed on as the count of the container.
+template <>
+struct transcoder_reader_traits<transenc::reader>
+{
+    static bool container_begin(transenc::reader& input, std::size_t& count)
+    {
+        input.next();
+        switch (input.type())
+        {
+        case token::token_null:
+            input.next();
+            return false;
+
+        case token::token_integer:
+            count = static_cast<std::size_t>(input.get_long_long());
+            input.next();
+            return true;
+
+        default:
+            return false;
+        }
+    }
+};
+
+} // namespace protoc
+
 #endif // PROTOC_TRANSENC_READER_HPP
@@ -0,0 +1,92 @@
+#ifndef PROTOC_TRANSENC_SPLIT_HPP
+#define PROTOC_TRANSENC_SPLIT_HPP
+
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstddef> // std::size_t
+#include <sstream>
+#include <vector>
+#include <protoc/parser.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/transenc/detail/token.hpp>
+#include <protoc/transenc/detail/decoder.hpp>
+
+namespace protoc
+{
+namespace transenc
+{
+
+// Splits back-to-back transenc values into one record per value. The
+// extent of each value is found by tracking the nesting of its containers;
+// strings and binary data are skipped without being decoded. Truncated or
+// invalid input throws protoc::unexpected_token.
+inline void split(const unsigned char *begin, const unsigned char *end, std::vector<protoc::binary_view>& records)
+{
+    detail::decoder decoder(begin, end);
+    const unsigned char *first = begin;
+    while (first != end)
+    {
+        std::size_t depth = 0;
+        do
+        {
+            switch (decoder.type())
+            {
+            case detail::token_record_begin:
+            case detail::token_array_begin:
+            case detail::token_map_begin:
+                ++depth;
+                break;
+
+            case detail::token_record_end:
+            case detail::token_array_end:
+            case detail::token_map_end:
+                if (depth == 0)
+                {
+                    throw unexpected_token("unbalanced container end");
+                }
+                --depth;
+                break;
+
+            case detail::token_eof:
+                throw unexpected_token("truncated record");
+
+            case detail::token_error:
+                {
+                    std::ostringstream error;
+                    error << decoder.type();
+                    throw unexpected_token(error.str());
+                }
+
+            default:
+                break;
+            }
+            if (depth == 0)
+            {
+                const unsigned char *last = decoder.remaining().begin();
+                records.push_back(protoc::binary_view(first, last));
+                first = last;
+            }
+            decoder.next();
+        } while (depth > 0);
+    }
+}
+
+} // namespace transenc
+} // namespace protoc
+
+#endif /* PROTOC_TRANSENC_SPLIT_HPP */
@@ -14,8 +14,9 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <ostream>
+#include <boost/ref.hpp>
 #include <boost/utility/base_from_member.hpp>
-#include <protoc/output_stream.hpp>
+#include <protoc/output_buffered_stream.hpp>
 #include <protoc/transenc/oarchive.hpp>
 
 namespace protoc
@@ -27,21 +28,28 @@ namespace transenc
 // initialized before oarchive because it is passed as an argument to its
 // constructor
 class stream_oarchive
-    : private boost::base_from_member< protoc::output_stream<transenc::writer::value_type> >,
+    : private boost::base_from_member< protoc::output_buffered_stream<transenc::writer::value_type> >,
       private boost::base_from_member<transenc::writer>,
       public oarchive
 {
-    typedef protoc::output_stream<transenc::writer::value_type> member1_type;
+    typedef protoc::output_buffered_stream<transenc::writer::value_type> member1_type;
     typedef transenc::writer member2_type;
     typedef boost::base_from_member<member1_type> base_member1_type;
     typedef boost::base_from_member<member2_type> base_member2_type;
 
 public:
-    stream_oarchive(std::ostream& stream)
-        : base_member1_type(member1_type(stream)),
+    stream_oarchive(std::ostream& stream,
+                    std::size_t block_size = member1_type::default_block_size)
+        : base_member1_type(boost::ref(stream), block_size),
           base_member2_type(boost::ref(base_member1_type::member)),
           oarchive(base_member2_type::member)
     {}
+
+    // Writes buffered output to the stream
+    bool flush()
+    {
+        return base_member1_type::member.flush();
+    }
 };
 
 } // namespace transenc
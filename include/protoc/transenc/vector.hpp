@@ -39,6 +39,32 @@ struct save_functor< protoc::transenc::oarchive, typename std::vector<unsigned c
     }
 };
 
+// Specializations of std::vector of numbers, which are encoded in bulk
+
+template <typename Allocator>
+struct save_functor< protoc::transenc::oarchive, typename std::vector<int, Allocator> >
+    : save_array_functor<protoc::transenc::oarchive, int, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::transenc::oarchive, typename std::vector<long long, Allocator> >
+    : save_array_functor<protoc::transenc::oarchive, long long, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::transenc::oarchive, typename std::vector<float, Allocator> >
+    : save_array_functor<protoc::transenc::oarchive, float, Allocator>
+{
+};
+
+template <typename Allocator>
+struct save_functor< protoc::transenc::oarchive, typename std::vector<double, Allocator> >
+    : save_array_functor<protoc::transenc::oarchive, double, Allocator>
+{
+};
+
 template <typename Allocator>
 struct load_functor< protoc::transenc::iarchive, typename std::vector<unsigned char, Allocator> >
 {
@@ -59,6 +85,32 @@ struct load_functor< protoc::transenc::iarchive, typename std::vector<unsigned c
     }
 };
 
+// Specializations of std::vector of numbers, which are decoded in bulk
+
+template <typename Allocator>
+struct load_functor< protoc::transenc::iarchive, typename std::vector<int, Allocator> >
+    : load_array_functor<protoc::transenc::iarchive, int, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::transenc::iarchive, typename std::vector<long long, Allocator> >
+    : load_array_functor<protoc::transenc::iarchive, long long, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::transenc::iarchive, typename std::vector<float, Allocator> >
+    : load_array_functor<protoc::transenc::iarchive, float, Allocator>
+{
+};
+
+template <typename Allocator>
+struct load_functor< protoc::transenc::iarchive, typename std::vector<double, Allocator> >
+    : load_array_functor<protoc::transenc::iarchive, double, Allocator>
+{
+};
+
 } // namespace serialization
 } // namespace boost
 
@@ -13,8 +13,8 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#include <stack>
 #include <boost/optional.hpp>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/writer.hpp>
 #include <protoc/token.hpp>
 #include <protoc/transenc/detail/encoder.hpp>
@@ -34,6 +34,8 @@ public:
     writer(output_type&);
 
     virtual size_type size();
+    // Deeper nesting of containers throws protoc::invalid_scope
+    void max_depth(size_type);
 
     virtual size_type write(); // Null
     virtual size_type write(bool);
@@ -43,6 +45,7 @@ public:
     virtual size_type write(double);
     virtual size_type write(const char *);
     virtual size_type write(const std::string&);
+    virtual size_type write(const char *, size_type);
     virtual size_type write(const value_type *, size_type);
 
     virtual size_type record_begin();
@@ -56,8 +59,20 @@ public:
     virtual size_type map_begin(size_type count);
     virtual size_type map_end();
 
+    // Writes an array of numbers with the same encoding as writing each
+    // element individually, but in a single pass over the values. Returns
+    // zero if the output cannot hold all the values, in which case the array
+    // is left open with the values not written as its remaining count.
+    size_type write_array(const int *, size_type count);
+    size_type write_array(const long *, size_type count);
+    size_type write_array(const long long *, size_type count);
+    size_type write_array(const float *, size_type count);
+    size_type write_array(const double *, size_type count);
+
 private:
     size_type track(size_type);
+    template <typename T>
+    size_type put_array(const T *, size_type count);
 
 private:
     encoder_type encoder;
@@ -72,7 +87,7 @@ private:
         protoc::token::value token;
         boost::optional<size_type> count;
     };
-    typedef std::stack<element> stack_type;
+    typedef protoc::nesting_stack<element> stack_type;
     stack_type stack;
 };
 
@@ -97,6 +112,11 @@ inline writer::size_type writer::size()
     return stack.size();
 }
 
+inline void writer::max_depth(size_type depth)
+{
+    stack.max_depth(depth);
+}
+
 inline writer::size_type writer::write()
 {
     return track(encoder.put());
@@ -137,6 +157,11 @@ inline writer::size_type writer::write(const std::string& value)
     return track(encoder.put(value));
 }
 
+inline writer::size_type writer::write(const char *value, size_type size)
+{
+    return track(encoder.put(value, size));
+}
+
 inline writer::size_type writer::write(const value_type *data, size_type size)
 {
     return track(encoder.put(data, size));
@@ -214,6 +239,46 @@ inline writer::size_type writer::map_end()
     return track(encoder.put_map_end());
 }
 
+inline writer::size_type writer::write_array(const int *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+inline writer::size_type writer::write_array(const long *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+inline writer::size_type writer::write_array(const long long *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+inline writer::size_type writer::write_array(const float *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+inline writer::size_type writer::write_array(const double *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+template <typename T>
+writer::size_type writer::put_array(const T *values, size_type count)
+{
+    size_type size = array_begin(count);
+    size_type written = 0;
+    size += encoder.put_values(values, count, &written);
+    *stack.top().count -= written;
+    if (written < count)
+    {
+        // The output is full, so the array is left open
+        return 0;
+    }
+    return size + array_end();
+}
+
 inline writer::size_type writer::track(size_type size)
 {
     if (stack.empty())
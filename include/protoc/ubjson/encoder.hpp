@@ -52,6 +52,15 @@ public:
 
 private:
     std::size_t put_token(output::value_type);
+    template <typename T>
+    std::size_t put_string(output::value_type, T, const std::string&);
+
+    output::value_type *write(output::value_type *, protoc::int8_t);
+    output::value_type *write(output::value_type *, protoc::int16_t);
+    output::value_type *write(output::value_type *, protoc::int32_t);
+    output::value_type *write(output::value_type *, protoc::int64_t);
+    output::value_type *write(output::value_type *, protoc::float32_t);
+    output::value_type *write(output::value_type *, protoc::float64_t);
 
 private:
     output& buffer;
@@ -21,11 +21,11 @@
 #include <string>
 #include <vector>
 #include <map>
-#include <stack>
 #include <sstream>
 #include <boost/serialization/nvp.hpp>
 #include <boost/archive/detail/common_iarchive.hpp>
 #include <boost/archive/detail/register_archive.hpp>
+#include <protoc/nesting_stack.hpp>
 #include <protoc/types.hpp>
 #include <protoc/exceptions.hpp>
 #include <protoc/ubjson/decoder.hpp>
@@ -163,7 +163,7 @@ public:
 
 private:
     decoder input;
-    std::stack<scope> scope_stack;
+    protoc::nesting_stack<scope> scope_stack;
 };
 
 }
@@ -38,6 +38,8 @@ public:
     virtual size_type write(double) = 0;
     virtual size_type write(const char *) = 0;
     virtual size_type write(const std::string&) = 0;
+    // String of the given length, which need not be null-terminated
+    virtual size_type write(const char *, size_type) = 0;
     virtual size_type write(const value_type *, size_type) = 0;
 
     virtual size_type record_begin() = 0;
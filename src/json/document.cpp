@@ -0,0 +1,714 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cstring> // std::memcmp, std::strlen
+#include <limits>
+#include <protoc/exceptions.hpp>
+#include <protoc/json/decoder.hpp>
+#include <protoc/json/document.hpp>
+
+namespace protoc
+{
+namespace json
+{
+
+namespace
+{
+
+inline bool is_whitespace(char value)
+{
+    return ((value == ' ') || (value == '\t') || (value == '\r') || (value == '\n'));
+}
+
+const char *skip_whitespaces(const char *it, const char *end)
+{
+    while ((it != end) && is_whitespace(*it))
+    {
+        ++it;
+    }
+    return it;
+}
+
+// Checks the literal and returns the position after it
+const char *scan_literal(const char *it, const char *end, const char *literal)
+{
+    const std::size_t length = std::strlen(literal);
+    if ((std::size_t(end - it) < length) || (std::memcmp(it, literal, length) != 0))
+    {
+        throw unexpected_token("invalid literal");
+    }
+    return it + length;
+}
+
+inline bool is_digit(char value)
+{
+    return ((value >= '0') && (value <= '9'));
+}
+
+const char *skip_digits(const char *it, const char *end)
+{
+    while ((it != end) && is_digit(*it))
+    {
+        ++it;
+    }
+    return it;
+}
+
+// Checks the number syntax and returns the position after the number
+const char *scan_number(const char *it, const char *end, detail::token& type)
+{
+    type = detail::token_integer;
+    if (*it == '-')
+    {
+        ++it;
+    }
+    if ((it == end) || !is_digit(*it))
+        throw unexpected_token("invalid number");
+    // No leading zeros
+    it = (*it == '0') ? it + 1 : skip_digits(it, end);
+
+    if ((it != end) && (*it == '.'))
+    {
+        type = detail::token_float;
+        ++it;
+        if ((it == end) || !is_digit(*it))
+            throw unexpected_token("invalid number");
+        it = skip_digits(it, end);
+    }
+    if ((it != end) && ((*it == 'e') || (*it == 'E')))
+    {
+        type = detail::token_float;
+        ++it;
+        if ((it != end) && ((*it == '+') || (*it == '-')))
+        {
+            ++it;
+        }
+        if ((it == end) || !is_digit(*it))
+            throw unexpected_token("invalid number");
+        it = skip_digits(it, end);
+    }
+    return it;
+}
+
+// The token type and the escape flag occupy the lowest byte of
+// entry::position
+const protoc::uint64_t type_mask = 0x7F;
+const protoc::uint64_t escaped_flag = 0x80;
+const unsigned int offset_shift = 8;
+
+enum state
+{
+    state_value,
+    state_array_first,
+    state_object_first,
+    state_key,
+    state_colon,
+    state_separator,
+    state_done
+};
+
+} // anonymous namespace
+
+//-----------------------------------------------------------------------------
+// document
+//-----------------------------------------------------------------------------
+
+document::document(const char *begin, const char *end)
+    : begin(begin),
+      end(end)
+{
+    if (protoc::uint64_t(end - begin) > std::numeric_limits<protoc::uint32_t>::max())
+        throw invalid_value("document too large");
+    scan();
+}
+
+document::value document::root() const
+{
+    return value(this, 0);
+}
+
+document::size_type document::size() const
+{
+    return tape.size();
+}
+
+document::entry::entry(detail::token type, size_type offset)
+    : position((protoc::uint64_t(offset) << offset_shift) | protoc::uint64_t(type)),
+      length(0),
+      span(0),
+      count(0)
+{
+}
+
+detail::token document::entry::type() const
+{
+    return detail::token(position & type_mask);
+}
+
+bool document::entry::escaped() const
+{
+    return ((position & escaped_flag) != 0);
+}
+
+document::size_type document::entry::offset() const
+{
+    return size_type(position >> offset_shift);
+}
+
+void document::entry::set_escaped()
+{
+    position |= escaped_flag;
+}
+
+void document::scan()
+{
+    // Typical documents have a value per eight characters or more, so
+    // dense documents grow the tape at most once
+    tape.reserve((end - begin) / 8 + 1);
+
+    // Tape indices of the open containers
+    stack_type stack;
+    state current = state_value;
+    const char *it = begin;
+
+    for (;;)
+    {
+        it = skip_whitespaces(it, end);
+        if (it == end)
+            break;
+
+        switch (current)
+        {
+        case state_done:
+            throw unexpected_token("unexpected content after value");
+
+        case state_colon:
+            if (*it != ':')
+                throw unexpected_token("expected colon");
+            ++it;
+            current = state_value;
+            continue;
+
+        case state_separator:
+            if (*it == ',')
+            {
+                ++it;
+                current = (tape[stack.top()].type() == detail::token_object_begin)
+                    ? state_key
+                    : state_value;
+                continue;
+            }
+            break;
+
+        case state_array_first:
+            if (*it != ']')
+            {
+                current = state_value;
+            }
+            break;
+
+        case state_object_first:
+            if (*it != '}')
+            {
+                current = state_key;
+            }
+            break;
+
+        default:
+            break;
+        }
+
+        switch (current)
+        {
+        case state_value:
+            {
+                const std::size_t before = tape.size();
+                it = scan_value(it, stack);
+                const detail::token type = tape[before].type();
+                if (type == detail::token_array_begin)
+                    current = state_array_first;
+                else if (type == detail::token_object_begin)
+                    current = state_object_first;
+                else
+                    current = stack.empty() ? state_done : state_separator;
+            }
+            break;
+
+        case state_key:
+            if (*it != '"')
+                throw unexpected_token("expected key");
+            ++tape[stack.top()].count;
+            it = scan_string(it);
+            current = state_colon;
+            break;
+
+        case state_array_first:
+        case state_object_first:
+        case state_separator:
+            if (*it == ']')
+            {
+                it = scan_close(it, detail::token_array_begin, stack);
+            }
+            else if (*it == '}')
+            {
+                it = scan_close(it, detail::token_object_begin, stack);
+            }
+            else
+            {
+                throw unexpected_token("expected comma");
+            }
+            current = stack.empty() ? state_done : state_separator;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (current != state_done)
+    {
+        throw unexpected_token("unexpected end of input");
+    }
+}
+
+const char *document::scan_value(const char *it, stack_type& stack)
+{
+    if (!stack.empty())
+    {
+        entry& parent = tape[stack.top()];
+        if (parent.type() == detail::token_array_begin)
+        {
+            ++parent.count;
+        }
+    }
+
+    const char *first = it;
+    switch (*it)
+    {
+    case '"':
+        return scan_string(it);
+
+    case '[':
+        push(detail::token_array_begin, it);
+        stack.push(tape.size() - 1);
+        return it + 1;
+
+    case '{':
+        push(detail::token_object_begin, it);
+        stack.push(tape.size() - 1);
+        return it + 1;
+
+    case 't':
+        it = scan_literal(it, end, "true");
+        push(detail::token_true, first);
+        break;
+
+    case 'f':
+        it = scan_literal(it, end, "false");
+        push(detail::token_false, first);
+        break;
+
+    case 'n':
+        it = scan_literal(it, end, "null");
+        push(detail::token_null, first);
+        break;
+
+    case '-':
+    case '0': case '1': case '2': case '3': case '4':
+    case '5': case '6': case '7': case '8': case '9':
+        {
+            // The number is converted by the decoder when it is requested
+            detail::token type = detail::token_integer;
+            it = scan_number(it, end, type);
+            push(type, first);
+        }
+        break;
+
+    default:
+        throw unexpected_token("expected value");
+    }
+
+    tape.back().length = protoc::uint32_t(it - first);
+    return it;
+}
+
+const char *document::scan_string(const char *it)
+{
+    tape.push_back(entry(detail::token_string, it + 1 - begin));
+    entry& result = tape.back();
+
+    // Escape sequences are only skipped here and decoded on request
+    for (++it; it != end; ++it)
+    {
+        if (*it == '"')
+        {
+            result.length = protoc::uint32_t(it - begin - result.offset());
+            return it + 1;
+        }
+        if (*it == '\\')
+        {
+            result.set_escaped();
+            if (++it == end)
+                break;
+        }
+    }
+    throw unexpected_token("unterminated string");
+}
+
+const char *document::scan_close(const char *it, detail::token type, stack_type& stack)
+{
+    if (stack.empty())
+        throw unexpected_token("unbalanced container end");
+
+    const size_type index = stack.top();
+    entry& container = tape[index];
+    if (container.type() != type)
+    {
+        throw unexpected_token((type == detail::token_array_begin)
+                               ? "expected array end"
+                               : "expected object end");
+    }
+    container.length = protoc::uint32_t(it + 1 - begin - container.offset());
+    container.span = protoc::uint32_t(tape.size() - index - 1);
+    stack.pop();
+    return it + 1;
+}
+
+void document::push(detail::token type, const char *position)
+{
+    tape.push_back(entry(type, position - begin));
+}
+
+//-----------------------------------------------------------------------------
+// value
+//-----------------------------------------------------------------------------
+
+document::value::value()
+    : owner(0),
+      index(0)
+{
+}
+
+document::value::value(const document *owner, size_type index)
+    : owner(owner),
+      index(index)
+{
+}
+
+const document::entry& document::value::current() const
+{
+    return owner->tape[index];
+}
+
+void document::value::expect(detail::token type, const char *message) const
+{
+    if (current().type() != type)
+        throw invalid_value(message);
+}
+
+// Index of the entry after the value at the given index
+document::size_type document::value::next(size_type position) const
+{
+    return position + owner->tape[position].span + 1;
+}
+
+protoc::token::value document::value::type() const
+{
+    switch (current().type())
+    {
+    case detail::token_null:
+        return protoc::token::token_null;
+
+    case detail::token_true:
+    case detail::token_false:
+        return protoc::token::token_boolean;
+
+    case detail::token_integer:
+        return protoc::token::token_integer;
+
+    case detail::token_float:
+        return protoc::token::token_floating;
+
+    case detail::token_string:
+        return protoc::token::token_string;
+
+    case detail::token_array_begin:
+        return protoc::token::token_array_begin;
+
+    case detail::token_object_begin:
+        return protoc::token::token_map_begin;
+
+    default:
+        return protoc::token::token_eof;
+    }
+}
+
+bool document::value::is_null() const
+{
+    return (current().type() == detail::token_null);
+}
+
+document::size_type document::value::size() const
+{
+    const entry& self = current();
+    switch (self.type())
+    {
+    case detail::token_array_begin:
+    case detail::token_object_begin:
+        return self.count;
+
+    default:
+        throw invalid_value("expected array or object");
+    }
+}
+
+document::value document::value::operator [] (size_type position) const
+{
+    expect(detail::token_array_begin, "expected array");
+    if (position >= current().count)
+        throw invalid_value("index out of range");
+
+    size_type result = index + 1;
+    for (size_type i = 0; i < position; ++i)
+    {
+        result = next(result);
+    }
+    return value(owner, result);
+}
+
+document::value document::value::operator [] (int position) const
+{
+    if (position < 0)
+        throw invalid_value("index out of range");
+    return operator [] (size_type(position));
+}
+
+document::value document::value::operator [] (const std::string& key) const
+{
+    value result;
+    if (!find(key.data(), key.size(), result))
+        throw invalid_value("key not found");
+    return result;
+}
+
+document::value document::value::operator [] (const char *key) const
+{
+    value result;
+    if (!find(key, std::strlen(key), result))
+        throw invalid_value("key not found");
+    return result;
+}
+
+bool document::value::find(const std::string& key, value& result) const
+{
+    return find(key.data(), key.size(), result);
+}
+
+bool document::value::find(const char *key, size_type length, value& result) const
+{
+    expect(detail::token_object_begin, "expected object");
+
+    const size_type last = next(index);
+    for (size_type position = index + 1; position < last; )
+    {
+        // Member key followed by its value
+        const size_type member = position + 1;
+        if (key_equal(position, key, length))
+        {
+            result = value(owner, member);
+            return true;
+        }
+        position = next(member);
+    }
+    return false;
+}
+
+bool document::value::key_equal(size_type position, const char *key, size_type length) const
+{
+    const entry& candidate = owner->tape[position];
+    const char *data = owner->begin + candidate.offset();
+    if (!candidate.escaped())
+    {
+        return ((candidate.length == length) && (std::memcmp(data, key, length) == 0));
+    }
+    // An escaped key is never shorter than its decoded form
+    if (candidate.length < length)
+        return false;
+    const std::string decoded = value(owner, position).get_string();
+    return ((decoded.size() == length) && (std::memcmp(decoded.data(), key, length) == 0));
+}
+
+document::value::const_iterator document::value::begin() const
+{
+    const detail::token type = current().type();
+    if ((type != detail::token_array_begin) && (type != detail::token_object_begin))
+        throw invalid_value("expected array or object");
+    return const_iterator(owner, index + 1, type == detail::token_object_begin);
+}
+
+document::value::const_iterator document::value::end() const
+{
+    const detail::token type = current().type();
+    if ((type != detail::token_array_begin) && (type != detail::token_object_begin))
+        throw invalid_value("expected array or object");
+    return const_iterator(owner, next(index), type == detail::token_object_begin);
+}
+
+bool document::value::get_bool() const
+{
+    switch (current().type())
+    {
+    case detail::token_true:
+        return true;
+
+    case detail::token_false:
+        return false;
+
+    default:
+        throw invalid_value("expected boolean");
+    }
+}
+
+protoc::int64_t document::value::get_integer() const
+{
+    expect(detail::token_integer, "expected integer");
+    const protoc::string_view range = get_range();
+    detail::decoder decoder(range.begin(), range.end());
+    // The number must span the whole range found by the structural pass
+    if ((decoder.type() != detail::token_integer) || !decoder.remaining().empty())
+        throw invalid_value("invalid integer");
+    return decoder.get_integer();
+}
+
+protoc::float64_t document::value::get_double() const
+{
+    const detail::token type = current().type();
+    if ((type != detail::token_float) && (type != detail::token_integer))
+        throw invalid_value("expected number");
+    const protoc::string_view range = get_range();
+    detail::decoder decoder(range.begin(), range.end());
+    if (!decoder.remaining().empty())
+        throw invalid_value("invalid number");
+    switch (decoder.type())
+    {
+    case detail::token_float:
+        return decoder.get_float();
+
+    case detail::token_integer:
+        return static_cast<protoc::float64_t>(decoder.get_integer());
+
+    default:
+        throw invalid_value("invalid number");
+    }
+}
+
+std::string document::value::get_string() const
+{
+    expect(detail::token_string, "expected string");
+    const entry& self = current();
+    // Include the quotes so that the decoder sees a complete string
+    const char *first = owner->begin + self.offset() - 1;
+    detail::decoder decoder(first, first + self.length + 2);
+    if (decoder.type() != detail::token_string)
+        throw invalid_value("invalid string");
+    if (!self.escaped())
+        return std::string(first + 1, first + 1 + self.length);
+    return decoder.get_string();
+}
+
+protoc::string_view document::value::get_string_view() const
+{
+    expect(detail::token_string, "expected string");
+    const entry& self = current();
+    const char *first = owner->begin + self.offset() - 1;
+    detail::decoder decoder(first, first + self.length + 2);
+    if (decoder.type() != detail::token_string)
+        throw invalid_value("invalid string");
+    return get_range();
+}
+
+bool document::value::has_escapes() const
+{
+    expect(detail::token_string, "expected string");
+    return current().escaped();
+}
+
+protoc::string_view document::value::get_range() const
+{
+    const entry& self = current();
+    const char *data = owner->begin + self.offset();
+    return protoc::string_view(data, data + self.length);
+}
+
+//-----------------------------------------------------------------------------
+// const_iterator
+//-----------------------------------------------------------------------------
+
+document::value::const_iterator::const_iterator()
+    : owner(0),
+      index(0),
+      members(false)
+{
+}
+
+document::value::const_iterator::const_iterator(const document *owner,
+                                                size_type index,
+                                                bool members)
+    : owner(owner),
+      index(index),
+      members(members)
+{
+}
+
+document::value document::value::const_iterator::operator * () const
+{
+    return value(owner, members ? index + 1 : index);
+}
+
+document::value::const_iterator& document::value::const_iterator::operator ++ ()
+{
+    const size_type element = members ? index + 1 : index;
+    index = element + owner->tape[element].span + 1;
+    return *this;
+}
+
+document::value::const_iterator document::value::const_iterator::operator ++ (int)
+{
+    const_iterator result(*this);
+    ++(*this);
+    return result;
+}
+
+bool document::value::const_iterator::operator == (const const_iterator& other) const
+{
+    return ((owner == other.owner) && (index == other.index));
+}
+
+bool document::value::const_iterator::operator != (const const_iterator& other) const
+{
+    return !(*this == other);
+}
+
+std::string document::value::const_iterator::key() const
+{
+    if (!members)
+        throw invalid_value("expected object");
+    return value(owner, index).get_string();
+}
+
+} // namespace json
+} // namespace protoc
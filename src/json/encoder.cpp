@@ -15,8 +15,11 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
-#define BOOST_LEXICAL_CAST_ASSUME_C_LOCALE 1
-#include <boost/lexical_cast.hpp>
+#include <algorithm> // std::copy
+#include <cassert>
+#include <cstring> // std::memcpy, std::strlen
+#include <boost/cstdint.hpp> // UINT64_C
+#include <boost/math/special_functions/sign.hpp>
 #include <boost/math/special_functions/fpclassify.hpp>
 #include <protoc/json/encoder.hpp>
 
@@ -27,6 +30,431 @@ char null_text[] = { 'n', 'u', 'l', 'l' };
 char true_text[] = { 't', 'r', 'u', 'e' };
 char false_text[] = { 'f', 'a', 'l', 's', 'e' };
 
+// Returns the character that follows the backslash, or zero if the
+// character is written as-is.
+inline char escape_character(char value)
+{
+    switch (value)
+    {
+    case '"':
+    case '\\':
+    case '/':
+        return value;
+    case '\b':
+        return 'b';
+    case '\f':
+        return 'f';
+    case '\n':
+        return 'n';
+    case '\r':
+        return 'r';
+    case '\t':
+        return 't';
+    default:
+        return 0;
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Integer formatting
+//-----------------------------------------------------------------------------
+
+const char digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+inline int count_digits(protoc::uint64_t value)
+{
+    int result = 1;
+    for (;;)
+    {
+        if (value < 10) return result;
+        if (value < 100) return result + 1;
+        if (value < 1000) return result + 2;
+        if (value < 10000) return result + 3;
+        value /= 10000;
+        result += 4;
+    }
+}
+
+// Writes the digits of value backwards from last and returns the first digit
+char *format_digits(protoc::uint64_t value, char *last)
+{
+    while (value >= 100)
+    {
+        const unsigned int index = static_cast<unsigned int>(value % 100) * 2;
+        value /= 100;
+        *--last = digit_pairs[index + 1];
+        *--last = digit_pairs[index];
+    }
+    if (value >= 10)
+    {
+        const unsigned int index = static_cast<unsigned int>(value) * 2;
+        *--last = digit_pairs[index + 1];
+        *--last = digit_pairs[index];
+    }
+    else
+    {
+        *--last = static_cast<char>('0' + value);
+    }
+    return last;
+}
+
+//-----------------------------------------------------------------------------
+// Floating-point formatting
+//
+// Grisu2 by Florian Loitsch, "Printing Floating-Point Numbers Quickly and
+// Accurately with Integers", PLDI 2010. The generated digits always parse
+// back to the same double, and are the shortest such digits in almost all
+// cases.
+//-----------------------------------------------------------------------------
+
+struct diy_fp
+{
+    diy_fp() : f(0), e(0) {}
+    diy_fp(protoc::uint64_t f, int e) : f(f), e(e) {}
+
+    explicit diy_fp(double value)
+    {
+        protoc::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        const int biased_exponent = static_cast<int>((bits & exponent_mask) >> 52);
+        const protoc::uint64_t significand = bits & significand_mask;
+        if (biased_exponent != 0)
+        {
+            f = significand + hidden_bit;
+            e = biased_exponent - exponent_bias;
+        }
+        else
+        {
+            f = significand;
+            e = 1 - exponent_bias;
+        }
+    }
+
+    diy_fp operator - (const diy_fp& other) const
+    {
+        assert(e == other.e);
+        assert(f >= other.f);
+        return diy_fp(f - other.f, e);
+    }
+
+    diy_fp operator * (const diy_fp& other) const
+    {
+        const protoc::uint64_t mask = 0xFFFFFFFF;
+        const protoc::uint64_t a = f >> 32;
+        const protoc::uint64_t b = f & mask;
+        const protoc::uint64_t c = other.f >> 32;
+        const protoc::uint64_t d = other.f & mask;
+        const protoc::uint64_t ac = a * c;
+        const protoc::uint64_t bc = b * c;
+        const protoc::uint64_t ad = a * d;
+        const protoc::uint64_t bd = b * d;
+        protoc::uint64_t tmp = (bd >> 32) + (ad & mask) + (bc & mask);
+        tmp += protoc::uint64_t(1) << 31; // Round
+        return diy_fp(ac + (ad >> 32) + (bc >> 32) + (tmp >> 32), e + other.e + 64);
+    }
+
+    diy_fp normalize() const
+    {
+        diy_fp result(*this);
+        while (!(result.f & (protoc::uint64_t(1) << 63)))
+        {
+            result.f <<= 1;
+            result.e--;
+        }
+        return result;
+    }
+
+    // Boundaries m- and m+ of the rounding interval, sharing the exponent
+    void normalized_boundaries(diy_fp& minus, diy_fp& plus) const
+    {
+        diy_fp upper((f << 1) + 1, e - 1);
+        while (!(upper.f & (hidden_bit << 1)))
+        {
+            upper.f <<= 1;
+            upper.e--;
+        }
+        upper.f <<= 10;
+        upper.e -= 10;
+        diy_fp lower = (f == hidden_bit)
+            ? diy_fp((f << 2) - 1, e - 2)
+            : diy_fp((f << 1) - 1, e - 1);
+        lower.f <<= lower.e - upper.e;
+        lower.e = upper.e;
+        minus = lower;
+        plus = upper;
+    }
+
+    static const protoc::uint64_t exponent_mask = UINT64_C(0x7FF0000000000000);
+    static const protoc::uint64_t significand_mask = UINT64_C(0x000FFFFFFFFFFFFF);
+    static const protoc::uint64_t hidden_bit = UINT64_C(0x0010000000000000);
+    static const int exponent_bias = 0x3FF + 52;
+
+    protoc::uint64_t f;
+    int e;
+};
+
+// Normalized powers of ten from 10^-348 to 10^340 in steps of 8
+const protoc::uint64_t cached_powers_f[] =
+{
+    UINT64_C(0xfa8fd5a0081c0288), UINT64_C(0xbaaee17fa23ebf76), UINT64_C(0x8b16fb203055ac76),
+    UINT64_C(0xcf42894a5dce35ea), UINT64_C(0x9a6bb0aa55653b2d), UINT64_C(0xe61acf033d1a45df),
+    UINT64_C(0xab70fe17c79ac6ca), UINT64_C(0xff77b1fcbebcdc4f), UINT64_C(0xbe5691ef416bd60c),
+    UINT64_C(0x8dd01fad907ffc3c), UINT64_C(0xd3515c2831559a83), UINT64_C(0x9d71ac8fada6c9b5),
+    UINT64_C(0xea9c227723ee8bcb), UINT64_C(0xaecc49914078536d), UINT64_C(0x823c12795db6ce57),
+    UINT64_C(0xc21094364dfb5637), UINT64_C(0x9096ea6f3848984f), UINT64_C(0xd77485cb25823ac7),
+    UINT64_C(0xa086cfcd97bf97f4), UINT64_C(0xef340a98172aace5), UINT64_C(0xb23867fb2a35b28e),
+    UINT64_C(0x84c8d4dfd2c63f3b), UINT64_C(0xc5dd44271ad3cdba), UINT64_C(0x936b9fcebb25c996),
+    UINT64_C(0xdbac6c247d62a584), UINT64_C(0xa3ab66580d5fdaf6), UINT64_C(0xf3e2f893dec3f126),
+    UINT64_C(0xb5b5ada8aaff80b8), UINT64_C(0x87625f056c7c4a8b), UINT64_C(0xc9bcff6034c13053),
+    UINT64_C(0x964e858c91ba2655), UINT64_C(0xdff9772470297ebd), UINT64_C(0xa6dfbd9fb8e5b88f),
+    UINT64_C(0xf8a95fcf88747d94), UINT64_C(0xb94470938fa89bcf), UINT64_C(0x8a08f0f8bf0f156b),
+    UINT64_C(0xcdb02555653131b6), UINT64_C(0x993fe2c6d07b7fac), UINT64_C(0xe45c10c42a2b3b06),
+    UINT64_C(0xaa242499697392d3), UINT64_C(0xfd87b5f28300ca0e), UINT64_C(0xbce5086492111aeb),
+    UINT64_C(0x8cbccc096f5088cc), UINT64_C(0xd1b71758e219652c), UINT64_C(0x9c40000000000000),
+    UINT64_C(0xe8d4a51000000000), UINT64_C(0xad78ebc5ac620000), UINT64_C(0x813f3978f8940984),
+    UINT64_C(0xc097ce7bc90715b3), UINT64_C(0x8f7e32ce7bea5c70), UINT64_C(0xd5d238a4abe98068),
+    UINT64_C(0x9f4f2726179a2245), UINT64_C(0xed63a231d4c4fb27), UINT64_C(0xb0de65388cc8ada8),
+    UINT64_C(0x83c7088e1aab65db), UINT64_C(0xc45d1df942711d9a), UINT64_C(0x924d692ca61be758),
+    UINT64_C(0xda01ee641a708dea), UINT64_C(0xa26da3999aef774a), UINT64_C(0xf209787bb47d6b85),
+    UINT64_C(0xb454e4a179dd1877), UINT64_C(0x865b86925b9bc5c2), UINT64_C(0xc83553c5c8965d3d),
+    UINT64_C(0x952ab45cfa97a0b3), UINT64_C(0xde469fbd99a05fe3), UINT64_C(0xa59bc234db398c25),
+    UINT64_C(0xf6c69a72a3989f5c), UINT64_C(0xb7dcbf5354e9bece), UINT64_C(0x88fcf317f22241e2),
+    UINT64_C(0xcc20ce9bd35c78a5), UINT64_C(0x98165af37b2153df), UINT64_C(0xe2a0b5dc971f303a),
+    UINT64_C(0xa8d9d1535ce3b396), UINT64_C(0xfb9b7cd9a4a7443c), UINT64_C(0xbb764c4ca7a44410),
+    UINT64_C(0x8bab8eefb6409c1a), UINT64_C(0xd01fef10a657842c), UINT64_C(0x9b10a4e5e9913129),
+    UINT64_C(0xe7109bfba19c0c9d), UINT64_C(0xac2820d9623bf429), UINT64_C(0x80444b5e7aa7cf85),
+    UINT64_C(0xbf21e44003acdd2d), UINT64_C(0x8e679c2f5e44ff8f), UINT64_C(0xd433179d9c8cb841),
+    UINT64_C(0x9e19db92b4e31ba9), UINT64_C(0xeb96bf6ebadf77d9), UINT64_C(0xaf87023b9bf0ee6b)
+};
+
+const short cached_powers_e[] =
+{
+    -1220, -1193, -1166, -1140, -1113, -1087, -1060, -1034, -1007, -980,
+    -954, -927, -901, -874, -847, -821, -794, -768, -741, -715,
+    -688, -661, -635, -608, -582, -555, -529, -502, -475, -449,
+    -422, -396, -369, -343, -316, -289, -263, -236, -210, -183,
+    -157, -130, -103, -77, -50, -24, 3, 30, 56, 83,
+    109, 136, 162, 189, 216, 242, 269, 295, 322, 348,
+    375, 402, 428, 455, 481, 508, 534, 561, 588, 614,
+    641, 667, 694, 720, 747, 774, 800, 827, 853, 880,
+    907, 933, 960, 986, 1013, 1039, 1066
+};
+
+const protoc::uint64_t powers_of_ten[] =
+{
+    UINT64_C(1),
+    UINT64_C(10),
+    UINT64_C(100),
+    UINT64_C(1000),
+    UINT64_C(10000),
+    UINT64_C(100000),
+    UINT64_C(1000000),
+    UINT64_C(10000000),
+    UINT64_C(100000000),
+    UINT64_C(1000000000),
+    UINT64_C(10000000000),
+    UINT64_C(100000000000),
+    UINT64_C(1000000000000),
+    UINT64_C(10000000000000),
+    UINT64_C(100000000000000),
+    UINT64_C(1000000000000000),
+    UINT64_C(10000000000000000),
+    UINT64_C(100000000000000000),
+    UINT64_C(1000000000000000000),
+    UINT64_C(10000000000000000000)
+};
+
+// Returns c = 10^-k such that the product with a number of binary exponent
+// e has an exponent in [-60, -32]
+diy_fp cached_power(int e, int& k)
+{
+    const double dk = (-61 - e) * 0.30102999566398114 + 347;
+    int ik = static_cast<int>(dk);
+    if (dk - ik > 0.0)
+        ++ik;
+    const unsigned int index = static_cast<unsigned int>((ik >> 3) + 1);
+    k = -(-348 + static_cast<int>(index << 3));
+    return diy_fp(cached_powers_f[index], cached_powers_e[index]);
+}
+
+void grisu_round(char *buffer,
+                 int length,
+                 protoc::uint64_t delta,
+                 protoc::uint64_t rest,
+                 protoc::uint64_t ten_kappa,
+                 protoc::uint64_t wp_w)
+{
+    while ((rest < wp_w) &&
+           (delta - rest >= ten_kappa) &&
+           ((rest + ten_kappa < wp_w) || (wp_w - rest > rest + ten_kappa - wp_w)))
+    {
+        buffer[length - 1]--;
+        rest += ten_kappa;
+    }
+}
+
+void digit_gen(const diy_fp& w,
+               const diy_fp& mp,
+               protoc::uint64_t delta,
+               char *buffer,
+               int& length,
+               int& k)
+{
+    const diy_fp one(protoc::uint64_t(1) << -mp.e, mp.e);
+    const diy_fp wp_w = mp - w;
+    protoc::uint32_t p1 = static_cast<protoc::uint32_t>(mp.f >> -one.e);
+    protoc::uint64_t p2 = mp.f & (one.f - 1);
+    int kappa = count_digits(p1);
+    length = 0;
+
+    while (kappa > 0)
+    {
+        const protoc::uint32_t divisor = static_cast<protoc::uint32_t>(powers_of_ten[kappa - 1]);
+        const protoc::uint32_t digit = p1 / divisor;
+        p1 %= divisor;
+        if (digit || length)
+            buffer[length++] = static_cast<char>('0' + digit);
+        --kappa;
+        const protoc::uint64_t rest = (static_cast<protoc::uint64_t>(p1) << -one.e) + p2;
+        if (rest <= delta)
+        {
+            k += kappa;
+            grisu_round(buffer, length, delta, rest, powers_of_ten[kappa] << -one.e, wp_w.f);
+            return;
+        }
+    }
+
+    for (;;)
+    {
+        p2 *= 10;
+        delta *= 10;
+        const char digit = static_cast<char>(p2 >> -one.e);
+        if (digit || length)
+            buffer[length++] = static_cast<char>('0' + digit);
+        p2 &= one.f - 1;
+        --kappa;
+        if (p2 < delta)
+        {
+            k += kappa;
+            const int index = -kappa;
+            grisu_round(buffer, length, delta, p2, one.f, wp_w.f * (index < 20 ? powers_of_ten[index] : 0));
+            return;
+        }
+    }
+}
+
+// Generates the decimal digits of a positive value = digits * 10^k
+void grisu2(double value, char *buffer, int& length, int& k)
+{
+    const diy_fp v(value);
+    diy_fp minus;
+    diy_fp plus;
+    v.normalized_boundaries(minus, plus);
+
+    const diy_fp c_mk = cached_power(plus.e, k);
+    const diy_fp w = v.normalize() * c_mk;
+    diy_fp wp = plus * c_mk;
+    diy_fp wm = minus * c_mk;
+    ++wm.f;
+    --wp.f;
+    digit_gen(w, wp, wp.f - wm.f, buffer, length, k);
+}
+
+// Longest output of format_double: sign, 17 digits, point, and exponent
+const std::size_t max_double_length = 1 + 17 + 1 + 5;
+
+// Writes a finite value in the same notation as printf("%.17g") but with
+// the shortest digits. Returns the end of the output.
+char *format_double(double value, char *output)
+{
+    if (boost::math::signbit(value))
+    {
+        *output++ = '-';
+        value = -value;
+    }
+    if (value == 0.0)
+    {
+        *output++ = '0';
+        return output;
+    }
+
+    char digits[20];
+    int length = 0;
+    int k = 0;
+    grisu2(value, digits, length, k);
+
+    // Position of the decimal point relative to the first digit
+    const int point = length + k;
+    if ((point >= -3) && (point <= 17))
+    {
+        if (point >= length)
+        {
+            // Integer
+            std::memcpy(output, digits, length);
+            output += length;
+            for (int i = length; i < point; ++i)
+                *output++ = '0';
+        }
+        else if (point > 0)
+        {
+            std::memcpy(output, digits, point);
+            output += point;
+            *output++ = '.';
+            std::memcpy(output, digits + point, length - point);
+            output += length - point;
+        }
+        else
+        {
+            *output++ = '0';
+            *output++ = '.';
+            for (int i = point; i < 0; ++i)
+                *output++ = '0';
+            std::memcpy(output, digits, length);
+            output += length;
+        }
+    }
+    else
+    {
+        // Scientific notation
+        *output++ = digits[0];
+        if (length > 1)
+        {
+            *output++ = '.';
+            std::memcpy(output, digits + 1, length - 1);
+            output += length - 1;
+        }
+        *output++ = 'e';
+        int exponent = point - 1;
+        if (exponent < 0)
+        {
+            *output++ = '-';
+            exponent = -exponent;
+        }
+        else
+        {
+            *output++ = '+';
+        }
+        if (exponent >= 100)
+        {
+            *output++ = static_cast<char>('0' + exponent / 100);
+            exponent %= 100;
+        }
+        *output++ = digit_pairs[exponent * 2];
+        *output++ = digit_pairs[exponent * 2 + 1];
+    }
+    return output;
+}
+
 } // anonymous namespace
 
 namespace protoc
@@ -60,40 +488,29 @@ std::size_t encoder::put(bool value)
 
 std::size_t encoder::put(protoc::int32_t value)
 {
-    std::string work = boost::lexical_cast<std::string>(value);
-    const std::string::size_type size = work.size();
-
-    if (!buffer.grow(size))
-    {
-        return 0;
-    }
-
-    for (std::string::const_iterator it = work.begin();
-         it != work.end();
-         ++it)
-    {
-        buffer.write(*it);
-    }
-
-    return size;
+    return put(protoc::int64_t(value));
 }
 
 std::size_t encoder::put(protoc::int64_t value)
 {
-    std::string work = boost::lexical_cast<std::string>(value);
-    const std::string::size_type size = work.size();
-
-    if (!buffer.grow(size))
+    // Negate as unsigned to handle the minimum value
+    const protoc::uint64_t magnitude = (value < 0)
+        ? protoc::uint64_t(0) - static_cast<protoc::uint64_t>(value)
+        : static_cast<protoc::uint64_t>(value);
+    const std::size_t size = count_digits(magnitude) + ((value < 0) ? 1 : 0);
+
+    output_type::value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    for (std::string::const_iterator it = work.begin();
-         it != work.end();
-         ++it)
+    format_digits(magnitude, output + size);
+    if (value < 0)
     {
-        buffer.write(*it);
+        *output = '-';
     }
+    buffer.commit(output + size);
 
     return size;
 }
@@ -112,111 +529,57 @@ std::size_t encoder::put(protoc::float64_t value)
         return put();
     }
 
-    std::string work = boost::lexical_cast<std::string>(value);
-    const std::string::size_type size = work.size();
-
-    if (!buffer.grow(size))
-    {
-        return 0;
-    }
-
-    for (std::string::const_iterator it = work.begin();
-         it != work.end();
-         ++it)
-    {
-        buffer.write(*it);
-    }
-
-    return size;
+    char work[max_double_length];
+    const char *end = format_double(value, work);
+    return put_text(work, end - work);
 }
 
 std::size_t encoder::put(const char *value)
 {
-    return put(std::string(value));
+    return put(value, std::strlen(value));
 }
 
 std::size_t encoder::put(const std::string& value)
 {
-    std::size_t size = sizeof('"') + value.size() + sizeof('"');
+    return put(value.data(), value.size());
+}
 
-    if (!buffer.grow(size))
+std::size_t encoder::put(const char *value, std::size_t length)
+{
+    const char *end = value + length;
+
+    // Count escapes first so that the exact size can be reserved
+    std::size_t size = sizeof('"') + length + sizeof('"');
+    for (const char *it = value; it != end; ++it)
+    {
+        if (escape_character(*it) != 0)
+        {
+            ++size;
+        }
+    }
+
+    output_type::value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    put_value('"');
-    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    *output++ = '"';
+    for (const char *it = value; it != end; ++it)
     {
-        switch (*it)
+        const char escape = escape_character(*it);
+        if (escape != 0)
         {
-        case '"':
-        case '\\':
-        case '/':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write(*it);
-            break;
-
-        case '\b':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write('b');
-            break;
-
-        case '\f':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write('f');
-            break;
-
-        case '\n':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write('n');
-            break;
-
-        case '\r':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write('r');
-            break;
-
-        case '\t':
-            if (!buffer.grow(1))
-            {
-                return 0;
-            }
-            ++size;
-            buffer.write('\\');
-            buffer.write('t');
-            break;
-
-        default:
-            buffer.write(*it);
-            break;
+            *output++ = '\\';
+            *output++ = escape;
+        }
+        else
+        {
+            *output++ = *it;
         }
     }
-    put_value('"');
+    *output++ = '"';
+    buffer.commit(output);
 
     return size;
 }
@@ -273,15 +636,13 @@ std::size_t encoder::put_colon()
 
 std::size_t encoder::put_text(const char *value, std::size_t size)
 {
-    if (!buffer.grow(size))
+    output_type::value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    for (std::size_t i = 0; i < size; ++i)
-    {
-        buffer.write(value[i]);
-    }
+    buffer.commit(std::copy(value, value + size, output));
 
     return size;
 }
@@ -290,12 +651,14 @@ std::size_t encoder::put_value(output_type::value_type value)
 {
     const std::size_t size = sizeof(value);
 
-    if (!buffer.grow(size))
+    output_type::value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(value);
+    *output++ = value;
+    buffer.commit(output);
 
     return size;
 }
@@ -0,0 +1,161 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <cerrno>
+#include <cstring> // std::strerror
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <protoc/mapped_file.hpp>
+
+#if defined(__unix__) || defined(__APPLE__)
+# include <unistd.h>
+# if defined(_POSIX_MAPPED_FILES) && (_POSIX_MAPPED_FILES > 0)
+#  define PROTOC_HAS_MMAP 1
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+# endif
+#endif
+
+namespace protoc
+{
+
+namespace
+{
+
+void throw_error(const char *path, const char *what, int error)
+{
+    std::string message("mapped_file: ");
+    message += path;
+    message += ": ";
+    message += what;
+    if (error != 0)
+    {
+        message += ": ";
+        message += std::strerror(error);
+    }
+    throw std::runtime_error(message);
+}
+
+#if defined(PROTOC_HAS_MMAP)
+
+// Closes the descriptor when the scope is left
+class scoped_descriptor
+{
+public:
+    explicit scoped_descriptor(int descriptor) : descriptor(descriptor) {}
+    ~scoped_descriptor() { ::close(descriptor); }
+
+private:
+    int descriptor;
+};
+
+#endif
+
+} // anonymous namespace
+
+mapped_file::mapped_file(const char *path, access pattern)
+    : address(0),
+      length(0),
+      mapped(false)
+{
+    open(path, pattern);
+}
+
+mapped_file::mapped_file(const std::string& path, access pattern)
+    : address(0),
+      length(0),
+      mapped(false)
+{
+    open(path.c_str(), pattern);
+}
+
+mapped_file::~mapped_file()
+{
+#if defined(PROTOC_HAS_MMAP)
+    if (mapped)
+    {
+        ::munmap(const_cast<char *>(address), length);
+    }
+#endif
+}
+
+#if defined(PROTOC_HAS_MMAP)
+
+void mapped_file::open(const char *path, access pattern)
+{
+    const int descriptor = ::open(path, O_RDONLY);
+    if (descriptor == -1)
+        throw_error(path, "cannot open", errno);
+    scoped_descriptor guard(descriptor);
+
+    struct stat status;
+    if (::fstat(descriptor, &status) == -1)
+        throw_error(path, "cannot stat", errno);
+    if (!S_ISREG(status.st_mode))
+        throw_error(path, "not a regular file", 0);
+    if (status.st_size == 0)
+        return; // Zero-length mappings are not allowed
+
+    void *memory = ::mmap(0, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    if (memory == MAP_FAILED)
+        throw_error(path, "cannot map", errno);
+
+    address = static_cast<const char *>(memory);
+    length = status.st_size;
+    mapped = true;
+
+    // The hints are advisory, so failures are ignored
+#if defined(MADV_SEQUENTIAL) && defined(MADV_WILLNEED) && defined(MADV_RANDOM)
+    switch (pattern)
+    {
+    case sequential:
+        ::madvise(memory, length, MADV_SEQUENTIAL);
+        ::madvise(memory, length, MADV_WILLNEED);
+        break;
+
+    case random:
+        ::madvise(memory, length, MADV_RANDOM);
+        break;
+    }
+#else
+    (void)pattern;
+#endif
+}
+
+#else
+
+void mapped_file::open(const char *path, access)
+{
+    std::ifstream file(path, std::ios_base::in | std::ios_base::binary);
+    if (!file)
+        throw_error(path, "cannot open", errno);
+    fallback.assign(std::istreambuf_iterator<char>(file),
+                    std::istreambuf_iterator<char>());
+    if (file.bad())
+        throw_error(path, "cannot read", errno);
+    if (!fallback.empty())
+    {
+        address = &fallback[0];
+        length = fallback.size();
+    }
+}
+
+#endif
+
+} // namespace protoc
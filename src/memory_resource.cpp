@@ -0,0 +1,147 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cassert>
+#include <protoc/memory_resource.hpp>
+
+namespace protoc
+{
+
+const std::size_t memory_resource::default_alignment;
+const std::size_t monotonic_buffer_resource::default_block_size;
+
+bool memory_resource::do_is_equal(const memory_resource& other) const
+{
+    return (this == &other);
+}
+
+//-----------------------------------------------------------------------------
+// new_delete_resource
+//-----------------------------------------------------------------------------
+
+namespace
+{
+
+class new_delete_memory_resource : public memory_resource
+{
+protected:
+    virtual void *do_allocate(std::size_t size, std::size_t alignment)
+    {
+        // Operator new only guarantees fundamental alignments
+        assert(alignment <= default_alignment);
+        (void)alignment;
+        return ::operator new(size);
+    }
+
+    virtual void do_deallocate(void *pointer, std::size_t, std::size_t)
+    {
+        ::operator delete(pointer);
+    }
+};
+
+} // anonymous namespace
+
+memory_resource& new_delete_resource()
+{
+    static new_delete_memory_resource resource;
+    return resource;
+}
+
+//-----------------------------------------------------------------------------
+// monotonic_buffer_resource
+//-----------------------------------------------------------------------------
+
+monotonic_buffer_resource::monotonic_buffer_resource(std::size_t block_size,
+                                                     memory_resource& upstream)
+    : upstream(upstream),
+      blocks(0),
+      initial_buffer(0),
+      initial_size(0),
+      current(0),
+      available(0),
+      next_size(std::max(block_size, sizeof(block_header)))
+{
+}
+
+monotonic_buffer_resource::monotonic_buffer_resource(void *buffer,
+                                                     std::size_t size,
+                                                     memory_resource& upstream)
+    : upstream(upstream),
+      blocks(0),
+      initial_buffer(buffer),
+      initial_size(size),
+      current(static_cast<char *>(buffer)),
+      available(size),
+      next_size(std::max(size, std::size_t(default_block_size)))
+{
+}
+
+monotonic_buffer_resource::~monotonic_buffer_resource()
+{
+    release();
+}
+
+void monotonic_buffer_resource::release()
+{
+    while (blocks)
+    {
+        block_header *next = blocks->next;
+        upstream.deallocate(blocks, blocks->size);
+        blocks = next;
+    }
+    current = static_cast<char *>(initial_buffer);
+    available = initial_size;
+}
+
+void *monotonic_buffer_resource::do_allocate(std::size_t size, std::size_t alignment)
+{
+    assert(alignment != 0 && (alignment & (alignment - 1)) == 0);
+
+    std::size_t padding = (alignment - reinterpret_cast<std::size_t>(current) % alignment) % alignment;
+    if ((current == 0) || (padding + size > available))
+    {
+        next_block(size, alignment);
+        padding = (alignment - reinterpret_cast<std::size_t>(current) % alignment) % alignment;
+    }
+    char *result = current + padding;
+    current = result + size;
+    available -= padding + size;
+    return result;
+}
+
+void monotonic_buffer_resource::do_deallocate(void *, std::size_t, std::size_t)
+{
+    // Memory is reclaimed by release()
+}
+
+// Allocates a block that is large enough for the request and grows the size
+// of subsequent blocks geometrically.
+void monotonic_buffer_resource::next_block(std::size_t size, std::size_t alignment)
+{
+    const std::size_t needed = sizeof(block_header) + alignment + size;
+    const std::size_t block_size = std::max(next_size, needed);
+    block_header *block = static_cast<block_header *>(upstream.allocate(block_size));
+    block->next = blocks;
+    block->size = block_size;
+    blocks = block;
+    current = reinterpret_cast<char *>(block + 1);
+    available = block_size - sizeof(block_header);
+    next_size = block_size + block_size / 2;
+}
+
+} // namespace protoc
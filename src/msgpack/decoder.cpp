@@ -10,7 +10,9 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <protoc/endian.hpp>
 #include <protoc/msgpack/detail/codes.hpp>
 #include <protoc/msgpack/detail/decoder.hpp>
 
@@ -23,6 +25,76 @@ namespace msgpack
 namespace detail
 {
 
+namespace
+{
+
+// Size of the token that starts with the given header, or zero if the
+// header is too short to tell. Invalid codes count as a single value,
+// because the decoder reports them as soon as it sees them.
+std::size_t token_size(const unsigned char *header, std::size_t size)
+{
+    assert(size > 0);
+
+    const unsigned char code = header[0];
+    if (((code & 0x80) == 0x00) || ((code & 0xE0) == 0xE0))
+    {
+        // Positive and negative fixnum
+        return 1;
+    }
+    if ((code & 0xE0) == code_fixstr_0)
+    {
+        return 1 + (code & 0x1F);
+    }
+
+    switch (code)
+    {
+    case code_uint8:
+    case code_int8:
+        return 1 + sizeof(protoc::uint8_t);
+
+    case code_uint16:
+    case code_int16:
+    case code_array16:
+    case code_map16:
+        return 1 + sizeof(protoc::uint16_t);
+
+    case code_uint32:
+    case code_int32:
+    case code_float32:
+    case code_array32:
+    case code_map32:
+        return 1 + sizeof(protoc::uint32_t);
+
+    case code_uint64:
+    case code_int64:
+    case code_float64:
+        return 1 + sizeof(protoc::uint64_t);
+
+    case code_str8:
+    case code_bin8:
+        if (size < 1 + sizeof(protoc::uint8_t))
+            return 0;
+        return 1 + sizeof(protoc::uint8_t) + header[1];
+
+    case code_str16:
+    case code_bin16:
+        if (size < 1 + sizeof(protoc::uint16_t))
+            return 0;
+        return 1 + sizeof(protoc::uint16_t) + protoc::endian::load_big<protoc::uint16_t>(header + 1);
+
+    case code_str32:
+    case code_bin32:
+        if (size < 1 + sizeof(protoc::uint32_t))
+            return 0;
+        return 1 + sizeof(protoc::uint32_t) + protoc::endian::load_big<protoc::uint32_t>(header + 1);
+
+    default:
+        return 1;
+    }
+}
+
+} // anonymous namespace
+
 decoder::decoder(input_range::const_iterator begin,
                  input_range::const_iterator end)
     : input(begin, end)
@@ -38,11 +110,29 @@ decoder::decoder(const decoder& other)
     current.range = other.current.range;
 }
 
+void decoder::reset(input_range::const_iterator begin,
+                    input_range::const_iterator end)
+{
+    input = input_range(begin, end);
+    current.type = token_eof;
+    next();
+}
+
 token decoder::type() const
 {
     return current.type;
 }
 
+const decoder::input_range& decoder::remaining() const
+{
+    return input;
+}
+
+bool decoder::is_truncated() const
+{
+    return (current.type == token_eof);
+}
+
 void decoder::next()
 {
     if (current.type == token_error)
@@ -262,12 +352,7 @@ protoc::int16_t decoder::get_int16() const
     assert(current.type == token_int16);
     assert(current.range.size() == sizeof(protoc::int16_t));
 
-    const protoc::int16_t endian = 0x0001;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int16_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    return result;
+    return protoc::endian::load_big<protoc::int16_t>(current.range.begin());
 }
 
 protoc::int32_t decoder::get_int32() const
@@ -275,14 +360,7 @@ protoc::int32_t decoder::get_int32() const
     assert(current.type == token_int32);
     assert(current.range.size() == sizeof(protoc::int32_t));
 
-    const protoc::int32_t endian = 0x00010203;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_big<protoc::int32_t>(current.range.begin());
 }
 
 protoc::int64_t decoder::get_int64() const
@@ -290,18 +368,7 @@ protoc::int64_t decoder::get_int64() const
     assert(current.type == token_int64);
     assert(current.range.size() == sizeof(protoc::int64_t));
 
-    const protoc::int64_t endian = 0x0001020304050607;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_big<protoc::int64_t>(current.range.begin());
 }
 
 protoc::uint8_t decoder::get_uint8() const
@@ -321,12 +388,7 @@ protoc::uint16_t decoder::get_uint16() const
            (current.type == token_map16));
     assert(current.range.size() == sizeof(protoc::uint16_t));
 
-    const protoc::uint16_t endian = 0x0001;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::uint16_t result;
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[0]] = static_cast<protoc::uint8_t>(data[0]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[1]] = static_cast<protoc::uint8_t>(data[1]);
-    return result;
+    return protoc::endian::load_big<protoc::uint16_t>(current.range.begin());
 }
 
 protoc::uint32_t decoder::get_uint32() const
@@ -336,14 +398,7 @@ protoc::uint32_t decoder::get_uint32() const
            (current.type == token_map32));
     assert(current.range.size() == sizeof(protoc::uint32_t));
 
-    const protoc::uint32_t endian = 0x00010203;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::uint32_t result;
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[0]] = static_cast<protoc::uint8_t>(data[0]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[1]] = static_cast<protoc::uint8_t>(data[1]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[2]] = static_cast<protoc::uint8_t>(data[2]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[3]] = static_cast<protoc::uint8_t>(data[3]);
-    return result;
+    return protoc::endian::load_big<protoc::uint32_t>(current.range.begin());
 }
 
 protoc::uint64_t decoder::get_uint64() const
@@ -351,18 +406,7 @@ protoc::uint64_t decoder::get_uint64() const
     assert(current.type == token_uint64);
     assert(current.range.size() == sizeof(protoc::uint64_t));
 
-    const protoc::uint64_t endian = 0x0001020304050607;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::uint64_t result;
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[0]] = static_cast<protoc::uint8_t>(data[0]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[1]] = static_cast<protoc::uint8_t>(data[1]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[2]] = static_cast<protoc::uint8_t>(data[2]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[3]] = static_cast<protoc::uint8_t>(data[3]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[4]] = static_cast<protoc::uint8_t>(data[4]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[5]] = static_cast<protoc::uint8_t>(data[5]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[6]] = static_cast<protoc::uint8_t>(data[6]);
-    ((volatile protoc::uint8_t *)&result)[((protoc::uint8_t *)&endian)[7]] = static_cast<protoc::uint8_t>(data[7]);
-    return result;
+    return protoc::endian::load_big<protoc::uint64_t>(current.range.begin());
 }
 
 protoc::float32_t decoder::get_float32() const
@@ -371,14 +415,7 @@ protoc::float32_t decoder::get_float32() const
     assert(current.range.size() == sizeof(protoc::float32_t));
 
     // IEEE 754 single precision
-    const protoc::int32_t endian = 0x00010203;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_big<protoc::float32_t>(current.range.begin());
 }
 
 protoc::float64_t decoder::get_float64() const
@@ -387,18 +424,7 @@ protoc::float64_t decoder::get_float64() const
     assert(current.range.size() == sizeof(protoc::float64_t));
 
     // IEEE 754 double precision
-    const protoc::int64_t endian = 0x0001020304050607;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_big<protoc::float64_t>(current.range.begin());
 }
 
 std::string decoder::get_string() const
@@ -411,6 +437,15 @@ std::string decoder::get_string() const
                        current.range.size());
 }
 
+const decoder::input_range& decoder::get_string_view() const
+{
+    assert((current.type == token_str8) ||
+           (current.type == token_str16) ||
+           (current.type == token_str32));
+
+    return current.range;
+}
+
 protoc::uint32_t decoder::get_count() const
 {
     assert((current.type == token_array8) ||
@@ -806,6 +841,38 @@ token decoder::next_map32()
     return token_map32;
 }
 
+decoder::token_scanner::token_scanner()
+    : header_size(0),
+      size(0),
+      scanned(0)
+{
+}
+
+std::size_t decoder::token_scanner::scan(input_range::const_iterator first,
+                                         input_range::const_iterator last)
+{
+    input_range::const_iterator position = first;
+    while ((size == 0) && (position != last))
+    {
+        assert(header_size < sizeof(header));
+        header[header_size++] = *position++;
+        ++scanned;
+        size = token_size(header, header_size);
+    }
+    if (size > 0)
+    {
+        const std::size_t amount = std::min(size - scanned, std::size_t(last - position));
+        position += amount;
+        scanned += amount;
+    }
+    return position - first;
+}
+
+bool decoder::token_scanner::done() const
+{
+    return (size > 0) && (scanned == size);
+}
+
 } // namespace detail
 } // namespace msgpack
 } // namespace protoc
@@ -10,7 +10,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cstring> // std::strlen
 #include <limits>
+#include <protoc/endian.hpp>
 #include <protoc/msgpack/detail/codes.hpp>
 #include <protoc/msgpack/detail/encoder.hpp>
 
@@ -21,6 +24,14 @@ namespace msgpack
 namespace detail
 {
 
+namespace
+{
+
+// Number of values encoded per reservation by put_values()
+const std::size_t values_per_block = 256;
+
+} // anonymous namespace
+
 encoder::encoder(output_type& buffer)
     : buffer(buffer)
 {
@@ -133,13 +144,15 @@ std::size_t encoder::put(protoc::float32_t value)
     const value_type type(code_float32);
     const std::size_t size = sizeof(type) + sizeof(protoc::float32_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -148,118 +161,100 @@ std::size_t encoder::put(protoc::float64_t value)
     const value_type type(code_float64);
     const std::size_t size = sizeof(type) + sizeof(protoc::float64_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
 std::size_t encoder::put(const char *value)
 {
-    return put(std::string(value));
+    return put(value, std::strlen(value));
 }
 
 std::size_t encoder::put(const std::string& value)
 {
-    const std::string::size_type length = value.size();
+    return put(value.data(), value.size());
+}
 
-    std::size_t size = 0;
+std::size_t encoder::put(const char *value, std::size_t length)
+{
+    const value_type *data = reinterpret_cast<const value_type *>(value);
 
-    if (length <= (code_fixstr_31 - code_fixstr_0))
-    {
-        if (!buffer.grow(sizeof(value_type)))
-        {
-            return 0;
-        }
-        buffer.write(code_fixstr_0 | length);
-        size = 0;
-    }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint8_t>::max()))
-    {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint8_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_str8);
-        size = write(static_cast<uint8_t>(length));
-    }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint16_t>::max()))
+    if (length <= std::size_t(code_fixstr_31 - code_fixstr_0))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint16_t) + length))
+        const std::size_t size = sizeof(value_type) + length;
+        value_type *output = buffer.reserve(size);
+        if (!output)
         {
             return 0;
         }
-        buffer.write(code_str16);
-        size = write(static_cast<uint16_t>(length));
+        *output++ = code_fixstr_0 | length;
+        output = std::copy(data, data + length, output);
+        buffer.commit(output);
+        return size;
     }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint32_t>::max()))
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint8_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint32_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_str32);
-        size = write(static_cast<uint32_t>(length));
+        return put_payload(code_str8, protoc::uint8_t(length), data, length);
     }
-    else
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint16_t>::max()))
     {
-        return 0;
+        return put_payload(code_str16, protoc::uint16_t(length), data, length);
     }
-
-    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint32_t>::max()))
     {
-        buffer.write(*it);
+        return put_payload(code_str32, protoc::uint32_t(length), data, length);
     }
-
-    return sizeof(value_type) + size + length;
+    return 0;
 }
 
 std::size_t encoder::put(const unsigned char * value, std::size_t length)
 {
-    std::size_t size = 0;
-
     if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint8_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint8_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_bin8);
-        size = write(static_cast<uint8_t>(length));
+        return put_binary(code_bin8, protoc::uint8_t(length), value, length);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint16_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint16_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_bin16);
-        size = write(static_cast<uint16_t>(length));
+        return put_binary(code_bin16, protoc::uint16_t(length), value, length);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint32_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint32_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_bin32);
-        size = write(static_cast<uint32_t>(length));
-    }
-    else
-    {
-        return 0;
+        return put_binary(code_bin32, protoc::uint32_t(length), value, length);
     }
+    return 0;
+}
 
-    for (std::size_t i = 0; i < length; ++i)
-    {
-        buffer.write(value[i]);
-    }
+std::size_t encoder::put_values(const int *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
 
-    return sizeof(value_type) + size + length;
+std::size_t encoder::put_values(const long *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
+
+std::size_t encoder::put_values(const long long *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
+
+std::size_t encoder::put_values(const float *values, std::size_t count, std::size_t *written)
+{
+    return put_floats(code_float32, values, count, written);
+}
+
+std::size_t encoder::put_values(const double *values, std::size_t count, std::size_t *written)
+{
+    return put_floats(code_float64, values, count, written);
 }
 
 std::size_t encoder::put_array_begin(std::size_t count)
@@ -318,23 +313,27 @@ std::size_t encoder::put_array_begin(std::size_t count)
         if (count <= 0xFFFF)
         {
             const std::size_t size = sizeof(value_type) + sizeof(protoc::uint16_t);
-            if (!buffer.grow(size))
+            value_type *output = buffer.reserve(size);
+            if (!output)
             {
                 return 0;
             }
-            buffer.write(code_array16);
-            write(protoc::uint16_t(count));
+            *output++ = code_array16;
+            output = write(output, protoc::uint16_t(count));
+            buffer.commit(output);
             return size;
         }
         else
         {
             const std::size_t size = sizeof(value_type) + sizeof(protoc::uint32_t);
-            if (!buffer.grow(size))
+            value_type *output = buffer.reserve(size);
+            if (!output)
             {
                 return 0;
             }
-            buffer.write(code_array32);
-            write(protoc::uint32_t(count));
+            *output++ = code_array32;
+            output = write(output, protoc::uint32_t(count));
+            buffer.commit(output);
             return size;
         }
     }
@@ -398,23 +397,27 @@ std::size_t encoder::put_map_begin(std::size_t count)
         if (count <= 0xFFFF)
         {
             const std::size_t size = sizeof(value_type) + sizeof(protoc::uint16_t);
-            if (!buffer.grow(size))
+            value_type *output = buffer.reserve(size);
+            if (!output)
             {
                 return 0;
             }
-            buffer.write(code_map16);
-            write(protoc::uint16_t(count));
+            *output++ = code_map16;
+            output = write(output, protoc::uint16_t(count));
+            buffer.commit(output);
             return size;
         }
         else
         {
             const std::size_t size = sizeof(value_type) + sizeof(protoc::uint32_t);
-            if (!buffer.grow(size))
+            value_type *output = buffer.reserve(size);
+            if (!output)
             {
                 return 0;
             }
-            buffer.write(code_map32);
-            write(protoc::uint32_t(count));
+            *output++ = code_map32;
+            output = write(output, protoc::uint32_t(count));
+            buffer.commit(output);
             return size;
         }
     }
@@ -426,13 +429,14 @@ std::size_t encoder::put_token(value_type value)
 {
     const std::size_t size = sizeof(value);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(value);
-
+    *output++ = value;
+    buffer.commit(output);
     return size;
 }
 
@@ -440,28 +444,22 @@ std::size_t encoder::put_int8(protoc::int8_t value)
 {
     if (value >= -32)
     {
-        const std::size_t size = sizeof(value_type);
-
-        if (!buffer.grow(size))
-        {
-            return 0;
-        }
-
-        write(value);
-        return size;
+        return put_token(static_cast<value_type>(value));
     }
     else
     {
         const value_type type(code_int8);
         const std::size_t size = sizeof(type) + sizeof(protoc::int8_t);
 
-        if (!buffer.grow(size))
+        value_type *output = buffer.reserve(size);
+        if (!output)
         {
             return 0;
         }
 
-        buffer.write(type);
-        write(value);
+        *output++ = type;
+        output = write(output, value);
+        buffer.commit(output);
         return size;
     }
 }
@@ -470,28 +468,22 @@ std::size_t encoder::put_uint8(protoc::uint8_t value)
 {
     if (value <= 127)
     {
-        const std::size_t size = sizeof(value_type);
-
-        if (!buffer.grow(size))
-        {
-            return 0;
-        }
-
-        write(value);
-        return size;
+        return put_token(static_cast<value_type>(value));
     }
     else
     {
         const value_type type(code_uint8);
         const std::size_t size = sizeof(type) + sizeof(protoc::uint8_t);
 
-        if (!buffer.grow(size))
+        value_type *output = buffer.reserve(size);
+        if (!output)
         {
             return 0;
         }
 
-        buffer.write(type);
-        write(value);
+        *output++ = type;
+        output = write(output, value);
+        buffer.commit(output);
         return size;
     }
 }
@@ -501,13 +493,15 @@ std::size_t encoder::put_int16(protoc::int16_t value)
     const value_type type(code_int16);
     const std::size_t size = sizeof(type) + sizeof(protoc::int16_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -516,13 +510,15 @@ std::size_t encoder::put_uint16(protoc::uint16_t value)
     const value_type type(code_uint16);
     const std::size_t size = sizeof(type) + sizeof(protoc::uint16_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -531,13 +527,15 @@ std::size_t encoder::put_int32(protoc::int32_t value)
     const value_type type(code_int32);
     const std::size_t size = sizeof(type) + sizeof(protoc::int32_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -546,13 +544,15 @@ std::size_t encoder::put_uint32(protoc::uint32_t value)
     const value_type type(code_uint32);
     const std::size_t size = sizeof(type) + sizeof(protoc::uint32_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -561,13 +561,15 @@ std::size_t encoder::put_int64(protoc::int64_t value)
     const value_type type(code_int64);
     const std::size_t size = sizeof(type) + sizeof(protoc::int64_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
@@ -576,113 +578,235 @@ std::size_t encoder::put_uint64(protoc::uint64_t value)
     const value_type type(code_uint64);
     const std::size_t size = sizeof(type) + sizeof(protoc::uint64_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
     return size;
 }
 
-std::size_t encoder::write(protoc::int8_t value)
+template <typename T>
+std::size_t encoder::put_payload(value_type type,
+                                 T length,
+                                 const value_type *data,
+                                 std::size_t size)
 {
-    buffer.write(static_cast<value_type>(value));
-    return sizeof(protoc::int8_t);
+    const std::size_t total = sizeof(type) + sizeof(T) + size;
+
+    value_type *output = buffer.reserve(total);
+    if (!output)
+    {
+        return 0;
+    }
+
+    *output++ = type;
+    output = write(output, length);
+    output = std::copy(data, data + size, output);
+    buffer.commit(output);
+    return total;
 }
 
-std::size_t encoder::write(protoc::uint8_t value)
+template <typename T>
+std::size_t encoder::put_binary(value_type type,
+                                T length,
+                                const value_type *data,
+                                std::size_t size)
 {
-    buffer.write(static_cast<value_type>(value));
-    return sizeof(protoc::uint8_t);
+    if (!buffer.by_reference(size))
+    {
+        return put_payload(type, length, data, size);
+    }
+
+    // Only the header is copied, and the output refers to the data
+    const std::size_t header = sizeof(type) + sizeof(T);
+
+    value_type *output = buffer.reserve(header);
+    if (!output)
+    {
+        return 0;
+    }
+
+    *output++ = type;
+    output = write(output, length);
+    buffer.commit(output);
+    buffer.reference(data, size);
+    return header + size;
 }
 
-std::size_t encoder::write(protoc::int16_t value)
+template <typename T>
+std::size_t encoder::put_integers(const T *values,
+                                  std::size_t count,
+                                  std::size_t *written)
 {
-    // Big-endian
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::int16_t);
+    // The largest encoding of T is a type code followed by the value
+    const std::size_t largest = sizeof(value_type) + sizeof(T);
+
+    const T * const begin = values;
+    std::size_t total = 0;
+    while (count > 0)
+    {
+        const std::size_t block = std::min(count, values_per_block);
+        value_type *output = buffer.reserve(block * largest);
+        if (!output)
+        {
+            // A bounded output may not hold the worst case of the block,
+            // so the next value is written on its own if it fits
+            const std::size_t size = put(protoc::int64_t(*values));
+            if (size == 0)
+                break;
+            total += size;
+            ++values;
+            --count;
+            continue;
+        }
+
+        value_type * const first = output;
+        for (std::size_t i = 0; i < block; ++i)
+        {
+            output = write_integer(output, protoc::int64_t(values[i]));
+        }
+        buffer.commit(output);
+        total += output - first;
+        values += block;
+        count -= block;
+    }
+    if (written)
+    {
+        *written = values - begin;
+    }
+    return total;
 }
 
-std::size_t encoder::write(protoc::uint16_t value)
+template <typename T>
+std::size_t encoder::put_floats(value_type type,
+                                const T *values,
+                                std::size_t count,
+                                std::size_t *written)
 {
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::uint16_t);
+    const std::size_t size = sizeof(type) + sizeof(T);
+
+    const T * const begin = values;
+    std::size_t total = 0;
+    while (count > 0)
+    {
+        const std::size_t block = std::min(count, values_per_block);
+        value_type *output = buffer.reserve(block * size);
+        if (!output)
+        {
+            // Written on its own as in put_integers()
+            if (put(*values) == 0)
+                break;
+            total += size;
+            ++values;
+            --count;
+            continue;
+        }
+
+        for (std::size_t i = 0; i < block; ++i)
+        {
+            *output++ = type;
+            output = write(output, values[i]);
+        }
+        buffer.commit(output);
+        total += block * size;
+        values += block;
+        count -= block;
+    }
+    if (written)
+    {
+        *written = values - begin;
+    }
+    return total;
+}
+
+// Same encoding as put(protoc::int64_t)
+encoder::value_type *encoder::write_integer(value_type *output, protoc::int64_t value)
+{
+    if ((value <= std::numeric_limits<protoc::int8_t>::max()) &&
+        (value >= std::numeric_limits<protoc::int8_t>::min()))
+    {
+        if (value >= -32)
+        {
+            *output++ = static_cast<value_type>(value);
+            return output;
+        }
+        *output++ = code_int8;
+        return write(output, protoc::int8_t(value));
+    }
+    else if ((value <= std::numeric_limits<protoc::int16_t>::max()) &&
+             (value >= std::numeric_limits<protoc::int16_t>::min()))
+    {
+        *output++ = code_int16;
+        return write(output, protoc::int16_t(value));
+    }
+    else if ((value <= std::numeric_limits<protoc::int32_t>::max()) &&
+             (value >= std::numeric_limits<protoc::int32_t>::min()))
+    {
+        *output++ = code_int32;
+        return write(output, protoc::int32_t(value));
+    }
+    *output++ = code_int64;
+    return write(output, value);
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::int8_t value)
+{
+    *output++ = static_cast<value_type>(value);
+    return output;
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::uint8_t value)
+{
+    *output++ = static_cast<value_type>(value);
+    return output;
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::int16_t value)
+{
+    return write(output, static_cast<protoc::uint16_t>(value));
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::uint16_t value)
+{
+    // Big-endian
+    return protoc::endian::store_big(output, value);
 }
 
-std::size_t encoder::write(protoc::int32_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::int32_t value)
 {
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::int32_t);
+    return write(output, static_cast<protoc::uint32_t>(value));
 }
 
-std::size_t encoder::write(protoc::uint32_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint32_t value)
 {
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::uint32_t);
+    return protoc::endian::store_big(output, value);
 }
 
-std::size_t encoder::write(protoc::int64_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::int64_t value)
 {
-    buffer.write(static_cast<value_type>((value >> 56) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 48) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 40) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 32) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::int64_t);
+    return write(output, static_cast<protoc::uint64_t>(value));
 }
 
-std::size_t encoder::write(protoc::uint64_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint64_t value)
 {
-    buffer.write(static_cast<value_type>((value >> 56) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 48) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 40) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 32) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    return sizeof(protoc::uint64_t);
+    return protoc::endian::store_big(output, value);
 }
 
-std::size_t encoder::write(protoc::float32_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::float32_t value)
 {
     // Big-endian IEEE 754 single precision
-    const protoc::int32_t endian = 0x00010203;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[0]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[1]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[2]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[3]]));
-    return sizeof(protoc::float32_t);
+    return protoc::endian::store_big(output, value);
 }
 
-std::size_t encoder::write(protoc::float64_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::float64_t value)
 {
     // Big-endian IEEE 754 double precision
-    const protoc::int64_t endian = 0x0001020304050607;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[0]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[1]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[2]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[3]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[4]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[5]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[6]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[7]]));
-    return sizeof(protoc::float64_t);
+    return protoc::endian::store_big(output, value);
 }
 
 } // namespace detail
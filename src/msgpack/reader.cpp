@@ -21,6 +21,114 @@ namespace protoc
 namespace msgpack
 {
 
+namespace
+{
+
+// Mirror the get functions of the reader, but report a mismatch instead of
+// throwing so that bulk reads can stop there
+
+bool decode_value(const detail::decoder& decoder, int& value)
+{
+    switch (decoder.type())
+    {
+    case detail::token_int8:
+        value = decoder.get_int8();
+        return true;
+
+    case detail::token_uint8:
+        value = decoder.get_uint8();
+        return true;
+
+    case detail::token_int16:
+        value = decoder.get_int16();
+        return true;
+
+    case detail::token_uint16:
+        value = decoder.get_uint16();
+        return true;
+
+    case detail::token_int32:
+        value = decoder.get_int32();
+        return true;
+
+    case detail::token_uint32:
+        value = decoder.get_uint32();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool decode_value(const detail::decoder& decoder, long long& value)
+{
+    switch (decoder.type())
+    {
+    case detail::token_int8:
+        value = decoder.get_int8();
+        return true;
+
+    case detail::token_uint8:
+        value = decoder.get_uint8();
+        return true;
+
+    case detail::token_int16:
+        value = decoder.get_int16();
+        return true;
+
+    case detail::token_uint16:
+        value = decoder.get_uint16();
+        return true;
+
+    case detail::token_int32:
+        value = decoder.get_int32();
+        return true;
+
+    case detail::token_uint32:
+        value = decoder.get_uint32();
+        return true;
+
+    case detail::token_int64:
+        value = decoder.get_int64();
+        return true;
+
+    case detail::token_uint64:
+        value = decoder.get_uint64();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool decode_value(const detail::decoder& decoder, double& value)
+{
+    switch (decoder.type())
+    {
+    case detail::token_float32:
+        value = decoder.get_float32();
+        return true;
+
+    case detail::token_float64:
+        value = decoder.get_float64();
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+bool decode_value(const detail::decoder& decoder, float& value)
+{
+    double result;
+    if (!decode_value(decoder, result))
+        return false;
+    value = result;
+    return true;
+}
+
+} // anonymous namespace
+
 reader::reader(const reader& other)
     : decoder(other.decoder)
 {
@@ -78,6 +186,11 @@ protoc::token::value reader::type() const
     case detail::token_str32:
         return protoc::token::token_string;
 
+    case detail::token_bin8:
+    case detail::token_bin16:
+    case detail::token_bin32:
+        return protoc::token::token_binary;
+
     case detail::token_array8:
     case detail::token_array16:
     case detail::token_array32:
@@ -100,8 +213,30 @@ reader::size_type reader::size() const
     return stack.size();
 }
 
+void reader::max_depth(size_type depth)
+{
+    stack.max_depth(depth);
+}
+
 bool reader::next()
 {
+    if (!stack.empty())
+    {
+        stack_type::const_reference top = stack.top();
+        switch (top.token)
+        {
+        case protoc::token::token_array_end:
+        case protoc::token::token_map_end:
+            // Leave the container. It has already been counted as an element
+            // of its parent.
+            stack.pop();
+            return next_element();
+
+        default:
+            break;
+        }
+    }
+
     const detail::token current = decoder.type();
     switch (current)
     {
@@ -123,61 +258,7 @@ bool reader::next()
 
     decoder.next();
 
-    if (!stack.empty())
-    {
-        stack_type::reference top = stack.top();
-        switch (top.token)
-        {
-        case protoc::token::token_array_begin:
-            if (top.count == 0)
-            {
-                top.token = protoc::token::token_array_end;
-                return true;
-            }
-            else
-            {
-                --(top.count);
-            }
-            break;
-
-        case protoc::token::token_array_end:
-            stack.pop();
-            if (!stack.empty())
-            {
-                stack_type::reference parent = stack.top();
-                parent.token = protoc::token::token_array_end;
-                return true;
-            }
-            break;
-
-        case protoc::token::token_map_begin:
-            if (top.count == 0)
-            {
-                top.token = protoc::token::token_map_end;
-                return true;
-            }
-            else
-            {
-                --(top.count);
-            }
-            break;
-
-        case protoc::token::token_map_end:
-            stack.pop();
-            if (!stack.empty())
-            {
-                stack_type::reference parent = stack.top();
-                parent.token = protoc::token::token_map_end;
-                return true;
-            }
-            break;
-
-        default:
-            break;
-        }
-    }
-
-    return (type() != protoc::token::token_eof);
+    return next_element();
 }
 
 bool reader::next(protoc::token::value expect)
@@ -194,7 +275,50 @@ bool reader::next(protoc::token::value expect)
 
 void reader::next_sibling()
 {
-    throw unexpected_token("FIXME");
+    if (!stack.empty())
+    {
+        switch (stack.top().token)
+        {
+        case protoc::token::token_array_end:
+        case protoc::token::token_map_end:
+            next();
+            return;
+
+        default:
+            break;
+        }
+    }
+
+    // The element counts determine the extent of the subtree, so the skipped
+    // elements are never interpreted
+    size_type pending = 1;
+    do
+    {
+        switch (decoder.type())
+        {
+        case detail::token_array8:
+        case detail::token_array16:
+        case detail::token_array32:
+            pending += decoder.get_count();
+            break;
+
+        case detail::token_map8:
+        case detail::token_map16:
+        case detail::token_map32:
+            pending += 2 * size_type(decoder.get_count());
+            break;
+
+        case detail::token_eof:
+        case detail::token_error:
+            return;
+
+        default:
+            break;
+        }
+        decoder.next();
+    } while (--pending > 0);
+
+    next_element();
 }
 
 bool reader::get_bool() const
@@ -320,12 +444,140 @@ std::string reader::get_string() const
     }
 }
 
+reader::string_view_type reader::get_string_view() const
+{
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_str8:
+    case detail::token_str16:
+    case detail::token_str32:
+        {
+            const detail::decoder::input_range& range = decoder.get_string_view();
+            return string_view_type(reinterpret_cast<const char *>(range.begin()),
+                                    reinterpret_cast<const char *>(range.end()));
+        }
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
+bool reader::has_escapes() const
+{
+    // Strings are stored verbatim
+    (void)get_string_view();
+    return false;
+}
+
 reader::range_type reader::get_range() const
 {
     detail::decoder::input_range range = decoder.get_range();
     return boost::make_iterator_range(range.begin(), range.end());
 }
 
+reader::size_type reader::get_count() const
+{
+    const detail::token current = decoder.type();
+    switch (current)
+    {
+    case detail::token_array8:
+    case detail::token_array16:
+    case detail::token_array32:
+    case detail::token_map8:
+    case detail::token_map16:
+    case detail::token_map32:
+        return decoder.get_count();
+
+    default:
+        std::ostringstream error;
+        error << current;
+        throw invalid_value(error.str());
+    }
+}
+
+template <typename T>
+reader::size_type reader::read_array_values(T *output, size_type size)
+{
+    if (stack.empty())
+        return 0;
+    stack_type::reference top = stack.top();
+    if (top.token != protoc::token::token_array_begin)
+        return 0;
+
+    // Scalars never change the nesting, so the elements are accounted for
+    // directly on the array frame instead of through next()
+    size_type result = 0;
+    while (result < size)
+    {
+        if (!decode_value(decoder, output[result]))
+            break;
+        ++result;
+        decoder.next();
+        if (top.count == 0)
+        {
+            top.token = protoc::token::token_array_end;
+            break;
+        }
+        --(top.count);
+    }
+    return result;
+}
+
+reader::size_type reader::read_values(int *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+reader::size_type reader::read_values(long long *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+reader::size_type reader::read_values(float *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+reader::size_type reader::read_values(double *output, size_type size)
+{
+    return read_array_values(output, size);
+}
+
+// Accounts for the element that the decoder has moved to
+bool reader::next_element()
+{
+    if (!stack.empty())
+    {
+        stack_type::reference top = stack.top();
+        if (top.count == 0)
+        {
+            // All elements have been read
+            switch (top.token)
+            {
+            case protoc::token::token_array_begin:
+                top.token = protoc::token::token_array_end;
+                return true;
+
+            case protoc::token::token_map_begin:
+                top.token = protoc::token::token_map_end;
+                return true;
+
+            default:
+                break;
+            }
+        }
+        else
+        {
+            --(top.count);
+        }
+    }
+
+    return (type() != protoc::token::token_eof);
+}
+
 reader::frame::frame(protoc::token::value token, size_type count)
     : token(token),
       count(count)
@@ -12,16 +12,68 @@
 
 #include <protoc/msgpack/writer.hpp>
 
+#include <algorithm>
 #include <cassert>
+#include <cstring> // std::memmove
+#include <limits>
 #include <protoc/exceptions.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
 
 namespace protoc
 {
 namespace msgpack
 {
 
-writer::writer(output_type& out)
-    : encoder(out)
+namespace
+{
+
+const writer::size_type no_header = std::numeric_limits<writer::size_type>::max();
+const writer::size_type deferred_header_size = 1 + sizeof(protoc::uint32_t);
+
+writer::value_type *put_count(writer::value_type *position,
+                              protoc::uint32_t count,
+                              std::size_t size)
+{
+    for (std::size_t i = size; i > 0; --i)
+    {
+        position[i - 1] = writer::value_type(count & 0xFF);
+        count >>= 8;
+    }
+    return position + size;
+}
+
+// Writes the smallest header for the container. The header is never larger
+// than the deferred header, so compaction can be done in place.
+writer::value_type *put_header(writer::value_type *position,
+                               protoc::token::value token,
+                               protoc::uint32_t count)
+{
+    namespace detail = msgpack::detail;
+    const bool is_array = (token == protoc::token::token_array_begin);
+    if (count < 16)
+    {
+        *position++ = (is_array ? detail::code_fixarray_0 : detail::code_fixmap_0) + count;
+        return position;
+    }
+    else if (count <= 0xFFFF)
+    {
+        *position++ = is_array ? detail::code_array16 : detail::code_map16;
+        return put_count(position, count, sizeof(protoc::uint16_t));
+    }
+    *position++ = is_array ? detail::code_array32 : detail::code_map32;
+    return put_count(position, count, sizeof(protoc::uint32_t));
+}
+
+} // anonymous namespace
+
+writer::writer(output_type& out, count_mode mode)
+    : mode(mode),
+      output(out),
+      encoder(out),
+      buffer_output(buffer),
+      buffer_encoder(buffer_output),
+      in_place(out.rewritable()),
+      deferred_depth(0)
 {
 }
 
@@ -30,49 +82,59 @@ writer::size_type writer::size()
     return stack.size();
 }
 
+void writer::max_depth(size_type depth)
+{
+    stack.max_depth(depth);
+}
+
 writer::size_type writer::write()
 {
-    return track(encoder.put());
+    return track(current().put());
 }
 
 writer::size_type writer::write(bool value)
 {
-    return track(encoder.put(value));
+    return track(current().put(value));
 }
 
 writer::size_type writer::write(int value)
 {
-    return track(encoder.put(value));
+    return track(current().put(value));
 }
 
 writer::size_type writer::write(long long value)
 {
-    return track(encoder.put(protoc::int64_t(value)));
+    return track(current().put(protoc::int64_t(value)));
 }
 
 writer::size_type writer::write(float value)
 {
-    return track(encoder.put(protoc::float32_t(value)));
+    return track(current().put(protoc::float32_t(value)));
 }
 
 writer::size_type writer::write(double value)
 {
-    return track(encoder.put(protoc::float64_t(value)));
+    return track(current().put(protoc::float64_t(value)));
 }
 
 writer::size_type writer::write(const char *value)
 {
-    return track(encoder.put(value));
+    return track(current().put(value));
 }
 
 writer::size_type writer::write(const std::string& value)
 {
-    return track(encoder.put(value));
+    return track(current().put(value));
+}
+
+writer::size_type writer::write(const char *value, size_type size)
+{
+    return track(current().put(value, size));
 }
 
 writer::size_type writer::write(const value_type *data, size_type size)
 {
-    return track(encoder.put(data, size));
+    return track(current().put(data, size));
 }
 
 writer::size_type writer::record_begin()
@@ -87,54 +149,91 @@ writer::size_type writer::record_end()
 
 writer::size_type writer::array_begin()
 {
-    throw invalid_value("Array count must be specified");
+    if (mode == count_required)
+        throw invalid_value("Array count must be specified");
+    return deferred_begin(protoc::token::token_array_begin);
 }
 
 writer::size_type writer::array_begin(size_type count)
 {
+    // The container is an element of the enclosing container
+    const size_type size = track(current().put_array_begin(count));
     stack.push(frame(protoc::token::token_array_begin, count));
-    return encoder.put_array_begin(count);
+    return size;
 }
 
 writer::size_type writer::array_end()
 {
-    assert(!stack.empty());
-    if (stack.empty())
-        throw invalid_scope("Stack empty");
-
-    frame& top = stack.top();
-    if (top.count != 0)
-        throw invalid_scope("Writing too few elements");
-
-    stack.pop();
-
-    return 0;
+    return end(protoc::token::token_array_begin);
 }
 
 writer::size_type writer::map_begin()
 {
-    throw invalid_value("Map count must be specified");
+    if (mode == count_required)
+        throw invalid_value("Map count must be specified");
+    return deferred_begin(protoc::token::token_map_begin);
 }
 
 writer::size_type writer::map_begin(size_type count)
 {
+    const size_type size = track(current().put_map_begin(count));
     stack.push(frame(protoc::token::token_map_begin, 2 * count));
-    return encoder.put_map_begin(count);
+    return size;
 }
 
 writer::size_type writer::map_end()
 {
-    assert(!stack.empty());
-    if (stack.empty())
-        throw invalid_scope("Stack empty");
+    return end(protoc::token::token_map_begin);
+}
 
-    frame& top = stack.top();
-    if (top.count != 0)
-        throw invalid_scope("Writing too few elements");
+writer::size_type writer::write_array(const int *values, size_type count)
+{
+    return put_array(values, count);
+}
 
-    stack.pop();
+writer::size_type writer::write_array(const long *values, size_type count)
+{
+    return put_array(values, count);
+}
 
-    return 0;
+writer::size_type writer::write_array(const long long *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+writer::size_type writer::write_array(const float *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+writer::size_type writer::write_array(const double *values, size_type count)
+{
+    return put_array(values, count);
+}
+
+template <typename T>
+writer::size_type writer::put_array(const T *values, size_type count)
+{
+    size_type size = array_begin(count);
+    size_type written = 0;
+    size += current().put_values(values, count, &written);
+    stack.top().count -= written;
+    if (written < count)
+    {
+        // The output is full, so the array is left open
+        return 0;
+    }
+    return size + array_end();
+}
+
+writer::encoder_type& writer::current()
+{
+    return (deferred_depth > 0 && !in_place) ? buffer_encoder : encoder;
+}
+
+writer::output_type& writer::deferred_output()
+{
+    return in_place ? output : buffer_output;
 }
 
 writer::size_type writer::track(size_type size)
@@ -143,17 +242,160 @@ writer::size_type writer::track(size_type size)
         return size;
 
     frame& top = stack.top();
+    if (top.is_deferred())
+    {
+        ++top.count;
+        return size;
+    }
     if (top.count == 0)
         throw invalid_scope("Writing too many elements");
     --top.count;
     return size;
 }
 
+writer::size_type writer::deferred_begin(protoc::token::value token)
+{
+    track(deferred_header_size);
+
+    // The header is patched when the container ends, so its content is
+    // irrelevant until then
+    output_type& target = deferred_output();
+    size_type offset = target.position();
+    value_type *position = target.reserve(deferred_header_size);
+    if (position == 0)
+    {
+        offset = no_header;
+    }
+    else
+    {
+        std::fill(position, position + deferred_header_size, value_type(0));
+        target.commit(position + deferred_header_size);
+    }
+    headers.push_back(header(token, offset));
+    ++deferred_depth;
+    stack.push(frame(token, 0, headers.size() - 1));
+    return (offset == no_header) ? 0 : deferred_header_size;
+}
+
+writer::size_type writer::end(protoc::token::value token)
+{
+    assert(!stack.empty());
+    if (stack.empty())
+        throw invalid_scope("Stack empty");
+
+    const frame top = stack.top();
+    if (top.token != token)
+        throw invalid_scope("Unexpected container end");
+    if (!top.is_deferred())
+    {
+        if (top.count != 0)
+            throw invalid_scope("Writing too few elements");
+        stack.pop();
+        return 0;
+    }
+
+    if ((token == protoc::token::token_map_begin) && (top.count % 2 != 0))
+        throw invalid_scope("Writing key without value");
+    const size_type count = (token == protoc::token::token_map_begin) ? top.count / 2 : top.count;
+    if (count > std::numeric_limits<protoc::uint32_t>::max())
+        throw invalid_scope("Writing too many elements");
+
+    stack.pop();
+    header& deferred = headers[top.header];
+    deferred.count = count;
+    if (deferred.offset != no_header)
+    {
+        value_type *position = deferred_output().rewrite(deferred.offset);
+        *position++ = (token == protoc::token::token_array_begin)
+            ? detail::code_array32
+            : detail::code_map32;
+        put_count(position, protoc::uint32_t(count), sizeof(protoc::uint32_t));
+    }
+
+    --deferred_depth;
+    if (deferred_depth == 0)
+    {
+        flush();
+    }
+    return 0;
+}
+
+// Completes the outermost deferred container. Headers are optionally
+// shrunk, and the buffered encoding is written to outputs that could not
+// be patched in place.
+void writer::flush()
+{
+    output_type& target = deferred_output();
+    if ((mode == count_deferred_compact) && is_complete())
+    {
+        // Headers are ordered by offset, so data only moves towards the front
+        const size_type origin = headers.front().offset;
+        value_type *base = target.rewrite(origin) - origin;
+        value_type *position = base + origin;
+        for (std::vector<header>::const_iterator it = headers.begin();
+             it != headers.end();
+             ++it)
+        {
+            position = put_header(position, it->token, protoc::uint32_t(it->count));
+            const size_type first = it->offset + deferred_header_size;
+            const size_type last = (it + 1 == headers.end()) ? target.position() : (it + 1)->offset;
+            std::memmove(position, base + first, last - first);
+            position += last - first;
+        }
+        target.truncate(position - base);
+    }
+    headers.clear();
+
+    if (!in_place)
+    {
+        if (!buffer.empty() && output.grow(buffer.size()))
+        {
+            output.write(&buffer[0], buffer.size());
+        }
+        buffer.clear();
+    }
+}
+
+bool writer::is_complete() const
+{
+    for (std::vector<header>::const_iterator it = headers.begin();
+         it != headers.end();
+         ++it)
+    {
+        if (it->offset == no_header)
+            return false;
+    }
+    return true;
+}
+
+writer::header::header(protoc::token::value token,
+                       size_type offset)
+    : token(token),
+      offset(offset),
+      count(0)
+{
+}
+
 writer::frame::frame(protoc::token::value token,
                      size_type count)
     : token(token),
-      count(count)
+      count(count),
+      header(no_header)
+{
+}
+
+writer::frame::frame(protoc::token::value token,
+                     size_type count,
+                     size_type header)
+    : token(token),
+      count(count),
+      header(header)
+{
+}
+
+bool writer::frame::is_deferred() const
 {
+    return (header != no_header);
 }
 
 } // namespace msgpack
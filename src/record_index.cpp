@@ -0,0 +1,270 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iterator>
+#include <protoc/endian.hpp>
+#include <protoc/exceptions.hpp>
+#include <protoc/record_index.hpp>
+
+namespace protoc
+{
+
+namespace
+{
+
+const unsigned char magic[] = { 'P', 'R', 'I', 'X' };
+const unsigned char version = 1;
+const unsigned char flag_keys = 0x01;
+const std::size_t header_size = 16;
+
+// Orders record numbers by their keys
+class key_less
+{
+public:
+    key_less(const std::vector<std::string>& keys) : keys(keys) {}
+
+    bool operator () (std::size_t lhs, std::size_t rhs) const
+    {
+        return keys[lhs] < keys[rhs];
+    }
+    bool operator () (std::size_t lhs, const std::string& rhs) const
+    {
+        return keys[lhs] < rhs;
+    }
+    bool operator () (const std::string& lhs, std::size_t rhs) const
+    {
+        return lhs < keys[rhs];
+    }
+
+private:
+    const std::vector<std::string>& keys;
+};
+
+template <typename T>
+void append(std::vector<unsigned char>& output, T value)
+{
+    unsigned char buffer[sizeof(T)];
+    endian::store_little(buffer, value);
+    output.insert(output.end(), buffer, buffer + sizeof(T));
+}
+
+// Reads little-endian values from a saved index and checks the bounds
+class loader
+{
+public:
+    loader(const unsigned char *first, const unsigned char *last)
+        : current(first),
+          last(last)
+    {
+    }
+
+    const unsigned char *take(std::size_t size)
+    {
+        if (std::size_t(last - current) < size)
+            throw invalid_value("record_index: truncated index");
+        const unsigned char *result = current;
+        current += size;
+        return result;
+    }
+
+    template <typename T>
+    T get()
+    {
+        return endian::load_little<T>(take(sizeof(T)));
+    }
+
+    bool at_end() const
+    {
+        return current == last;
+    }
+
+private:
+    const unsigned char *current;
+    const unsigned char *last;
+};
+
+} // anonymous namespace
+
+const record_index::size_type record_index::npos;
+
+record_index::record_index()
+    : offsets(1, 0)
+{
+}
+
+record_index::record_index(const unsigned char *begin,
+                           const std::vector<protoc::binary_view>& records)
+{
+    assign(begin, records);
+}
+
+record_index::record_index(const unsigned char *first, const unsigned char *last)
+{
+    load(first, last);
+}
+
+void record_index::assign(const unsigned char *begin,
+                          const std::vector<protoc::binary_view>& records)
+{
+    offsets.reserve(records.size() + 1);
+    offsets.push_back(records.empty() ? 0 : records.front().begin() - begin);
+    for (std::vector<protoc::binary_view>::const_iterator it = records.begin();
+         it != records.end();
+         ++it)
+    {
+        if (it->begin() != begin + offsets.back())
+            throw invalid_value("record_index: records are not contiguous");
+        offsets.push_back(it->end() - begin);
+    }
+}
+
+void record_index::sort_keys()
+{
+    order.resize(keys.size());
+    for (size_type i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::stable_sort(order.begin(), order.end(), key_less(keys));
+}
+
+void record_index::push_back(offset_type first, offset_type last)
+{
+    if (has_keys())
+        throw invalid_value("record_index: missing key");
+    append_offsets(first, last);
+}
+
+void record_index::push_back(offset_type first, offset_type last, const std::string& key)
+{
+    if (!has_keys() && !empty())
+        throw invalid_value("record_index: unexpected key");
+    append_offsets(first, last);
+
+    // Keys usually arrive in order, which makes the insertion an append
+    keys.push_back(key);
+    const size_type n = keys.size() - 1;
+    order.insert(std::upper_bound(order.begin(), order.end(), key, key_less(keys)), n);
+}
+
+void record_index::append_offsets(offset_type first, offset_type last)
+{
+    // The first record sets the start of the stream
+    if ((first != offsets.back()) && !empty())
+        throw invalid_value("record_index: records are not contiguous");
+    if (last < first)
+        throw invalid_value("record_index: negative record length");
+    offsets.back() = first;
+    offsets.push_back(last);
+}
+
+record_index::size_type record_index::find(const std::string& key) const
+{
+    std::vector<size_type>::const_iterator where
+        = std::lower_bound(order.begin(), order.end(), key, key_less(keys));
+    if ((where == order.end()) || (keys[*where] != key))
+        return npos;
+    return *where;
+}
+
+void record_index::save(std::vector<unsigned char>& output) const
+{
+    output.insert(output.end(), magic, magic + sizeof(magic));
+    output.push_back(version);
+    output.push_back(has_keys() ? flag_keys : 0);
+    output.push_back(0);
+    output.push_back(0);
+    append(output, protoc::uint64_t(size()));
+    for (std::vector<offset_type>::const_iterator it = offsets.begin();
+         it != offsets.end();
+         ++it)
+    {
+        append(output, protoc::uint64_t(*it));
+    }
+    if (has_keys())
+    {
+        for (std::vector<size_type>::const_iterator it = order.begin();
+             it != order.end();
+             ++it)
+        {
+            append(output, protoc::uint64_t(*it));
+        }
+        for (std::vector<std::string>::const_iterator it = keys.begin();
+             it != keys.end();
+             ++it)
+        {
+            append(output, protoc::uint32_t(it->size()));
+            output.insert(output.end(), it->begin(), it->end());
+        }
+    }
+}
+
+void record_index::load(const unsigned char *first, const unsigned char *last)
+{
+    loader input(first, last);
+    const unsigned char *header = input.take(header_size);
+    if (!std::equal(magic, magic + sizeof(magic), header))
+        throw invalid_value("record_index: not an index");
+    if (header[4] != version)
+        throw invalid_value("record_index: unsupported version");
+    const bool keyed = (header[5] & flag_keys);
+
+    const protoc::uint64_t count = endian::load_little<protoc::uint64_t>(header + 8);
+    // Every record needs at least an offset, so larger counts are corrupt
+    if (count > protoc::uint64_t(last - first) / sizeof(protoc::uint64_t))
+        throw invalid_value("record_index: truncated index");
+
+    offsets.reserve(count + 1);
+    for (protoc::uint64_t i = 0; i <= count; ++i)
+    {
+        const offset_type offset = input.get<protoc::uint64_t>();
+        if (!offsets.empty() && (offset < offsets.back()))
+            throw invalid_value("record_index: unordered offsets");
+        offsets.push_back(offset);
+    }
+    if (keyed && (count > 0))
+    {
+        order.reserve(count);
+        std::vector<bool> seen(count, false);
+        for (protoc::uint64_t i = 0; i < count; ++i)
+        {
+            const protoc::uint64_t n = input.get<protoc::uint64_t>();
+            if ((n >= count) || seen[n])
+                throw invalid_value("record_index: invalid key order");
+            seen[n] = true;
+            order.push_back(size_type(n));
+        }
+        keys.reserve(count);
+        for (protoc::uint64_t i = 0; i < count; ++i)
+        {
+            const protoc::uint32_t size = input.get<protoc::uint32_t>();
+            const unsigned char *key = input.take(size);
+            keys.push_back(std::string(key, key + size));
+        }
+        // Lookups rely on the order, so it is verified rather than trusted
+        for (size_type i = 1; i < order.size(); ++i)
+        {
+            if (keys[order[i]] < keys[order[i - 1]])
+                throw invalid_value("record_index: unsorted keys");
+        }
+    }
+    if (!input.at_end())
+        throw invalid_value("record_index: trailing data");
+}
+
+} // namespace protoc
@@ -15,7 +15,9 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
 #include <cassert>
+#include <protoc/endian.hpp>
 #include <protoc/transenc/detail/codes.hpp>
 #include <protoc/transenc/detail/decoder.hpp>
 
@@ -30,6 +32,85 @@ const protoc::transenc::detail::decoder::value_type code_pattern32 = 0xC0;
 const protoc::transenc::detail::decoder::value_type code_pattern_length32 = 0xC8;
 const protoc::transenc::detail::decoder::value_type code_pattern64 = 0xD0;
 const protoc::transenc::detail::decoder::value_type code_pattern_length64 = 0xD8;
+
+// Size of the token that starts with the given header, or zero if the
+// header is too short to tell. Unknown codes and negative lengths count as
+// the values that the decoder has seen when it reports them.
+protoc::uint64_t token_size(const unsigned char *header, std::size_t size)
+{
+    assert(size > 0);
+
+    const unsigned char code = header[0];
+    if (((code & 0x80) == 0x00) || ((code & 0xE0) == 0xE0))
+    {
+        // Small positive and negative integers
+        return 1;
+    }
+
+    std::size_t length_size;
+    switch (code & 0xF8)
+    {
+    case code_pattern8:
+        return 1 + sizeof(protoc::int8_t);
+
+    case code_pattern16:
+        return 1 + sizeof(protoc::int16_t);
+
+    case code_pattern32:
+        return 1 + sizeof(protoc::int32_t);
+
+    case code_pattern64:
+        return 1 + sizeof(protoc::int64_t);
+
+    case code_pattern_length8:
+        length_size = sizeof(protoc::int8_t);
+        break;
+
+    case code_pattern_length16:
+        length_size = sizeof(protoc::int16_t);
+        break;
+
+    case code_pattern_length32:
+        length_size = sizeof(protoc::int32_t);
+        break;
+
+    case code_pattern_length64:
+        length_size = sizeof(protoc::int64_t);
+        break;
+
+    default:
+        return 1;
+    }
+
+    if (size < 1 + length_size)
+        return 0;
+
+    protoc::uint64_t length;
+    switch (length_size)
+    {
+    case sizeof(protoc::int8_t):
+        length = header[1];
+        break;
+
+    case sizeof(protoc::int16_t):
+        length = protoc::endian::load_little<protoc::uint16_t>(header + 1);
+        break;
+
+    case sizeof(protoc::int32_t):
+        length = protoc::endian::load_little<protoc::uint32_t>(header + 1);
+        break;
+
+    default:
+        {
+            const protoc::int64_t value = protoc::endian::load_little<protoc::int64_t>(header + 1);
+            if (value < 0)
+                return 1 + length_size;
+            length = value;
+        }
+        break;
+    }
+    return 1 + length_size + length;
+}
 } // anonymous namespace
 
 namespace protoc
@@ -54,11 +135,29 @@ decoder::decoder(const decoder& other)
     current.range = other.current.range;
 }
 
+void decoder::reset(input_range::const_iterator begin,
+                    input_range::const_iterator end)
+{
+    input = input_range(begin, end);
+    current.type = token_eof;
+    next();
+}
+
 token decoder::type() const
 {
     return current.type;
 }
 
+const decoder::input_range& decoder::remaining() const
+{
+    return input;
+}
+
+bool decoder::is_truncated() const
+{
+    return (current.type == token_eof);
+}
+
 void decoder::next()
 {
     if (current.type == token_error)
@@ -213,12 +312,7 @@ protoc::int16_t decoder::get_int16() const
     assert(current.type == token_int16);
     assert(current.range.size() == sizeof(protoc::int16_t));
 
-    const protoc::int16_t endian = 0x0100;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int16_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    return result;
+    return protoc::endian::load_little<protoc::int16_t>(current.range.begin());
 }
 
 protoc::int32_t decoder::get_int32() const
@@ -226,14 +320,7 @@ protoc::int32_t decoder::get_int32() const
     assert(current.type == token_int32);
     assert(current.range.size() == sizeof(protoc::int32_t));
 
-    const protoc::int32_t endian = 0x03020100;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_little<protoc::int32_t>(current.range.begin());
 }
 
 protoc::int64_t decoder::get_int64() const
@@ -241,18 +328,7 @@ protoc::int64_t decoder::get_int64() const
     assert(current.type == token_int64);
     assert(current.range.size() == sizeof(protoc::int64_t));
 
-    const protoc::int64_t endian = 0x0706050403020100;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_little<protoc::int64_t>(current.range.begin());
 }
 
 protoc::float32_t decoder::get_float32() const
@@ -261,14 +337,7 @@ protoc::float32_t decoder::get_float32() const
     assert(current.range.size() == sizeof(protoc::float32_t));
 
     // IEEE 754 single precision
-    const protoc::int32_t endian = 0x03020100;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_little<protoc::float32_t>(current.range.begin());
 }
 
 protoc::float64_t decoder::get_float64() const
@@ -277,18 +346,14 @@ protoc::float64_t decoder::get_float64() const
     assert(current.range.size() == sizeof(protoc::float64_t));
 
     // IEEE 754 double precision
-    const protoc::int64_t endian = 0x0706050403020100;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&endian)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_little<protoc::float64_t>(current.range.begin());
+}
+
+decoder::input_range decoder::get_string_view() const
+{
+    assert(current.type == token_string);
+
+    return current.range;
 }
 
 decoder::input_range decoder::get_range() const
@@ -478,6 +543,38 @@ token decoder::next(token type, std::size_t size)
     return type;
 }
 
+decoder::token_scanner::token_scanner()
+    : header_size(0),
+      size(0),
+      scanned(0)
+{
+}
+
+std::size_t decoder::token_scanner::scan(input_range::const_iterator first,
+                                         input_range::const_iterator last)
+{
+    input_range::const_iterator position = first;
+    while ((size == 0) && (position != last))
+    {
+        assert(header_size < sizeof(header));
+        header[header_size++] = *position++;
+        ++scanned;
+        size = token_size(header, header_size);
+    }
+    if (size > 0)
+    {
+        const protoc::uint64_t amount = std::min(size - scanned, protoc::uint64_t(last - position));
+        position += amount;
+        scanned += amount;
+    }
+    return position - first;
+}
+
+bool decoder::token_scanner::done() const
+{
+    return (size > 0) && (scanned == size);
+}
+
 } // namespace detail
 } // namespace transenc
 } // namespace protoc
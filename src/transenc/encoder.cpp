@@ -15,7 +15,10 @@
 //
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <algorithm>
+#include <cstring> // std::strlen
 #include <limits>
+#include <protoc/endian.hpp>
 #include <protoc/transenc/detail/codes.hpp>
 #include <protoc/transenc/detail/encoder.hpp>
 
@@ -26,6 +29,14 @@ namespace transenc
 namespace detail
 {
 
+namespace
+{
+
+// Number of values encoded per reservation by put_values()
+const std::size_t values_per_block = 256;
+
+} // anonymous namespace
+
 encoder::encoder(output_type& buffer)
     : buffer(buffer)
 {
@@ -96,28 +107,22 @@ std::size_t encoder::put_int8(protoc::int8_t value)
 {
     if (value >= -32)
     {
-        const std::size_t size = sizeof(value_type);
-
-        if (!buffer.grow(size))
-        {
-            return 0;
-        }
-
-        write(value);
-        return size;
+        return put_token(static_cast<value_type>(value));
     }
     else
     {
         const value_type type(code_int8);
         const std::size_t size = sizeof(type) + sizeof(protoc::int8_t);
 
-        if (!buffer.grow(size))
+        value_type *output = buffer.reserve(size);
+        if (!output)
         {
             return 0;
         }
 
-        buffer.write(type);
-        write(value);
+        *output++ = type;
+        output = write(output, value);
+        buffer.commit(output);
         return size;
     }
 }
@@ -127,13 +132,15 @@ std::size_t encoder::put_int16(protoc::int16_t value)
     const value_type type(code_int16);
     const std::size_t size = sizeof(type) + sizeof(protoc::int16_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
 
     return size;
 }
@@ -143,13 +150,15 @@ std::size_t encoder::put_int32(protoc::int32_t value)
     const value_type type(code_int32);
     const std::size_t size = sizeof(type) + sizeof(protoc::int32_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
 
     return size;
 }
@@ -159,13 +168,15 @@ std::size_t encoder::put_int64(protoc::int64_t value)
     const value_type type(code_int64);
     const std::size_t size = sizeof(type) + sizeof(protoc::int64_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    write(value);
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
 
     return size;
 }
@@ -175,19 +186,15 @@ std::size_t encoder::put(protoc::float32_t value)
     const value_type type(code_float32);
     const std::size_t size = sizeof(type) + sizeof(protoc::float32_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    // IEEE 754 single precision
-    const protoc::int32_t endian = 0x03020100;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[0]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[1]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[2]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[3]]));
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
 
     return size;
 }
@@ -197,129 +204,92 @@ std::size_t encoder::put(protoc::float64_t value)
     const value_type type(code_float64);
     const std::size_t size = sizeof(type) + sizeof(protoc::float64_t);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(type);
-    // IEEE 754 double precision
-    const protoc::int64_t endian = 0x0706050403020100;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[0]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[1]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[2]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[3]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[4]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[5]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[6]]));
-    buffer.write(static_cast<value_type>(value_buffer[((protoc::int8_t *)&endian)[7]]));
+    *output++ = type;
+    output = write(output, value);
+    buffer.commit(output);
 
     return size;
 }
 
 std::size_t encoder::put(const char *value)
 {
-    return put(std::string(value));
+    return put(value, std::strlen(value));
 }
 
 std::size_t encoder::put(const std::string& value)
 {
-    const std::string::size_type length = value.size();
+    return put(value.data(), value.size());
+}
 
-    std::size_t size = 0;
+std::size_t encoder::put(const char *value, std::size_t length)
+{
+    const value_type *data = reinterpret_cast<const value_type *>(value);
 
-    if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint8_t>::max()))
+    if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint8_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint8_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_string_int8);
-        size = write(static_cast<uint8_t>(length));
+        return put_payload(code_string_int8, protoc::uint8_t(length), data, length);
     }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint16_t>::max()))
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint16_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint16_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_string_int16);
-        size = write(static_cast<uint16_t>(length));
-    }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint32_t>::max()))
-    {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::uint32_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_string_int32);
-        size = write(static_cast<uint32_t>(length));
+        return put_payload(code_string_int16, protoc::uint16_t(length), data, length);
     }
-    else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int64_t>::max()))
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::uint32_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::int64_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_string_int64);
-        size = write(static_cast<int64_t>(length));
+        return put_payload(code_string_int32, protoc::uint32_t(length), data, length);
     }
-    else
+    else if (length < static_cast<std::size_t>(std::numeric_limits<protoc::int64_t>::max()))
     {
-        return 0;
+        return put_payload(code_string_int64, protoc::int64_t(length), data, length);
     }
-
-    buffer.write(reinterpret_cast<const value_type *>(value.data()),
-                 value.size());
-
-    return sizeof(value_type) + size + length;
+    return 0;
 }
 
 std::size_t encoder::put(const unsigned char * value, std::size_t length)
 {
-    std::size_t size = 0;
-
     if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int8_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::int8_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_binary_int8);
-        size = write(static_cast<int8_t>(length));
+        return put_binary(code_binary_int8, protoc::int8_t(length), value, length);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int16_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::int16_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_binary_int16);
-        size = write(static_cast<int16_t>(length));
+        return put_binary(code_binary_int16, protoc::int16_t(length), value, length);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int32_t>::max()))
     {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::int32_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_binary_int32);
-        size = write(static_cast<int32_t>(length));
-    }
-    else
-    {
-        if (!buffer.grow(sizeof(value_type) + sizeof(protoc::int64_t) + length))
-        {
-            return 0;
-        }
-        buffer.write(code_binary_int64);
-        size = write(static_cast<int64_t>(length));
+        return put_binary(code_binary_int32, protoc::int32_t(length), value, length);
     }
+    return put_binary(code_binary_int64, protoc::int64_t(length), value, length);
+}
 
-    buffer.write(value, length);
+std::size_t encoder::put_values(const int *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
+
+std::size_t encoder::put_values(const long *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
+
+std::size_t encoder::put_values(const long long *values, std::size_t count, std::size_t *written)
+{
+    return put_integers(values, count, written);
+}
+
+std::size_t encoder::put_values(const float *values, std::size_t count, std::size_t *written)
+{
+    return put_floats(code_float32, values, count, written);
+}
 
-    return sizeof(value_type) + size + length;
+std::size_t encoder::put_values(const double *values, std::size_t count, std::size_t *written)
+{
+    return put_floats(code_float64, values, count, written);
 }
 
 std::size_t encoder::put_record_begin()
@@ -386,117 +356,246 @@ std::size_t encoder::put_token(value_type value)
 {
     const std::size_t size = sizeof(value);
 
-    if (!buffer.grow(size))
+    value_type *output = buffer.reserve(size);
+    if (!output)
     {
         return 0;
     }
 
-    buffer.write(value);
+    *output++ = value;
+    buffer.commit(output);
 
     return size;
 }
 
 std::size_t encoder::put_size_t(std::size_t value)
 {
-    if (value < static_cast<std::size_t>(std::numeric_limits<protoc::int8_t>::max()))
+    if (value < static_cast<std::size_t>(std::numeric_limits<protoc::int64_t>::max()))
     {
-        if (!buffer.grow(sizeof(protoc::uint8_t)))
-        {
-            return 0;
-        }
-        return write(static_cast<protoc::int8_t>(value));
+        // Encoded as the smallest integer that can hold the value
+        return put(static_cast<protoc::int64_t>(value));
+    }
+    return 0;
+}
+
+template <typename T>
+std::size_t encoder::put_payload(value_type type,
+                                 T length,
+                                 const value_type *data,
+                                 std::size_t size)
+{
+    const std::size_t total = sizeof(type) + sizeof(T) + size;
+
+    value_type *output = buffer.reserve(total);
+    if (!output)
+    {
+        return 0;
     }
-    else if (value < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint16_t>::max()))
+
+    *output++ = type;
+    output = write(output, length);
+    output = std::copy(data, data + size, output);
+    buffer.commit(output);
+
+    return total;
+}
+
+template <typename T>
+std::size_t encoder::put_binary(value_type type,
+                                T length,
+                                const value_type *data,
+                                std::size_t size)
+{
+    if (!buffer.by_reference(size))
+    {
+        return put_payload(type, length, data, size);
+    }
+
+    // Only the header is copied, and the output refers to the data
+    const std::size_t header = sizeof(type) + sizeof(T);
+
+    value_type *output = buffer.reserve(header);
+    if (!output)
     {
-        const std::size_t size = sizeof(value_type) + sizeof(protoc::uint16_t);
-        if (!buffer.grow(size))
+        return 0;
+    }
+
+    *output++ = type;
+    output = write(output, length);
+    buffer.commit(output);
+    buffer.reference(data, size);
+    return header + size;
+}
+
+template <typename T>
+std::size_t encoder::put_integers(const T *values,
+                                  std::size_t count,
+                                  std::size_t *written)
+{
+    // The largest encoding of T is a type code followed by the value
+    const std::size_t largest = sizeof(value_type) + sizeof(T);
+
+    const T * const begin = values;
+    std::size_t total = 0;
+    while (count > 0)
+    {
+        const std::size_t block = std::min(count, values_per_block);
+        value_type *output = buffer.reserve(block * largest);
+        if (!output)
         {
-            return 0;
+            // A bounded output may not hold the worst case of the block,
+            // so the next value is written on its own if it fits
+            const std::size_t size = put(protoc::int64_t(*values));
+            if (size == 0)
+                break;
+            total += size;
+            ++values;
+            --count;
+            continue;
         }
-        write(static_cast<uint16_t>(value));
-        return size;
+
+        value_type * const first = output;
+        for (std::size_t i = 0; i < block; ++i)
+        {
+            output = write_integer(output, protoc::int64_t(values[i]));
+        }
+        buffer.commit(output);
+        total += output - first;
+        values += block;
+        count -= block;
+    }
+    if (written)
+    {
+        *written = values - begin;
     }
-    else if (value < static_cast<std::string::size_type>(std::numeric_limits<protoc::uint32_t>::max()))
+    return total;
+}
+
+template <typename T>
+std::size_t encoder::put_floats(value_type type,
+                                const T *values,
+                                std::size_t count,
+                                std::size_t *written)
+{
+    const std::size_t size = sizeof(type) + sizeof(T);
+
+    const T * const begin = values;
+    std::size_t total = 0;
+    while (count > 0)
     {
-        const std::size_t size = sizeof(value_type) + sizeof(protoc::uint32_t);
-        if (!buffer.grow(size))
+        const std::size_t block = std::min(count, values_per_block);
+        value_type *output = buffer.reserve(block * size);
+        if (!output)
         {
-            return 0;
+            // Written on its own as in put_integers()
+            if (put(*values) == 0)
+                break;
+            total += size;
+            ++values;
+            --count;
+            continue;
         }
-        write(static_cast<uint32_t>(value));
-        return size;
+
+        for (std::size_t i = 0; i < block; ++i)
+        {
+            *output++ = type;
+            output = write(output, values[i]);
+        }
+        buffer.commit(output);
+        total += block * size;
+        values += block;
+        count -= block;
     }
-    else if (value < static_cast<std::string::size_type>(std::numeric_limits<protoc::int64_t>::max()))
+    if (written)
     {
-        const std::size_t size = sizeof(value_type) + sizeof(protoc::uint64_t);
-        if (!buffer.grow(size))
+        *written = values - begin;
+    }
+    return total;
+}
+
+// Same encoding as put(protoc::int64_t)
+encoder::value_type *encoder::write_integer(value_type *output, protoc::int64_t value)
+{
+    if ((value <= std::numeric_limits<protoc::int8_t>::max()) &&
+        (value >= std::numeric_limits<protoc::int8_t>::min()))
+    {
+        if (value >= -32)
         {
-            return 0;
+            *output++ = static_cast<value_type>(value);
+            return output;
         }
-        write(static_cast<int64_t>(value));
-        return size;
+        *output++ = code_int8;
+        return write(output, protoc::int8_t(value));
     }
-    else
+    else if ((value <= std::numeric_limits<protoc::int16_t>::max()) &&
+             (value >= std::numeric_limits<protoc::int16_t>::min()))
     {
-        return 0;
+        *output++ = code_int16;
+        return write(output, protoc::int16_t(value));
+    }
+    else if ((value <= std::numeric_limits<protoc::int32_t>::max()) &&
+             (value >= std::numeric_limits<protoc::int32_t>::min()))
+    {
+        *output++ = code_int32;
+        return write(output, protoc::int32_t(value));
     }
+    *output++ = code_int64;
+    return write(output, value);
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::int8_t value)
+{
+    *output++ = static_cast<value_type>(value);
+    return output;
 }
 
-std::size_t encoder::write(protoc::int8_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint8_t value)
 {
-    buffer.write(static_cast<value_type>(value));
-    return sizeof(protoc::int8_t);
+    *output++ = static_cast<value_type>(value);
+    return output;
 }
 
-std::size_t encoder::write(protoc::uint8_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::int16_t value)
 {
-    buffer.write(static_cast<value_type>(value));
-    return sizeof(protoc::uint8_t);
+    return write(output, static_cast<protoc::uint16_t>(value));
 }
 
-std::size_t encoder::write(protoc::int16_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint16_t value)
 {
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    return sizeof(protoc::int16_t);
+    // Little-endian
+    return protoc::endian::store_little(output, value);
 }
 
-std::size_t encoder::write(protoc::uint16_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::int32_t value)
 {
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    return sizeof(protoc::uint16_t);
+    return write(output, static_cast<protoc::uint32_t>(value));
 }
 
-std::size_t encoder::write(protoc::int32_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint32_t value)
 {
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    return sizeof(protoc::int32_t);
+    return protoc::endian::store_little(output, value);
 }
 
-std::size_t encoder::write(protoc::uint32_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::int64_t value)
 {
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    return sizeof(protoc::uint32_t);
+    return write(output, static_cast<protoc::uint64_t>(value));
 }
 
-std::size_t encoder::write(protoc::int64_t value)
+encoder::value_type *encoder::write(value_type *output, protoc::uint64_t value)
 {
-    buffer.write(static_cast<value_type>(value & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 32) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 40) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 48) & 0xFF));
-    buffer.write(static_cast<value_type>((value >> 56) & 0xFF));
-    return sizeof(protoc::int64_t);
+    return protoc::endian::store_little(output, value);
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::float32_t value)
+{
+    // IEEE 754 single precision
+    return protoc::endian::store_little(output, value);
+}
+
+encoder::value_type *encoder::write(value_type *output, protoc::float64_t value)
+{
+    // IEEE 754 double precision
+    return protoc::endian::store_little(output, value);
 }
 
 } // namespace detail
@@ -16,6 +16,7 @@
 ///////////////////////////////////////////////////////////////////////////////
 
 #include <cassert>
+#include <protoc/endian.hpp>
 #include <protoc/ubjson/decoder.hpp>
 
 namespace protoc
@@ -138,12 +139,7 @@ protoc::int16_t decoder::get_int16() const
     assert(current.type == token_int16);
     assert(current.range.size() == sizeof(protoc::int16_t));
 
-    const protoc::int16_t ix = 0x0001;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int16_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[1]] = static_cast<protoc::int8_t>(data[1]);
-    return result;
+    return protoc::endian::load_big<protoc::int16_t>(current.range.begin());
 }
 
 protoc::int32_t decoder::get_int32() const
@@ -151,14 +147,7 @@ protoc::int32_t decoder::get_int32() const
     assert(current.type == token_int32);
     assert(current.range.size() == sizeof(protoc::int32_t));
 
-    const protoc::int32_t ix = 0x00010203;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_big<protoc::int32_t>(current.range.begin());
 }
 
 protoc::int64_t decoder::get_int64() const
@@ -166,18 +155,7 @@ protoc::int64_t decoder::get_int64() const
     assert(current.type == token_int64);
     assert(current.range.size() == sizeof(protoc::int64_t));
 
-    const protoc::int64_t ix = 0x0001020304050607;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::int64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_big<protoc::int64_t>(current.range.begin());
 }
 
 protoc::float32_t decoder::get_float32() const
@@ -187,14 +165,7 @@ protoc::float32_t decoder::get_float32() const
     // FIXME: Report error for Infinity and NaN
 
     // IEEE 754 single precision
-    const protoc::int32_t ix = 0x00010203;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float32_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[3]] = static_cast<protoc::int8_t>(data[3]);
-    return result;
+    return protoc::endian::load_big<protoc::float32_t>(current.range.begin());
 }
 
 protoc::float64_t decoder::get_float64() const
@@ -202,18 +173,7 @@ protoc::float64_t decoder::get_float64() const
     assert(current.type == token_float64);
 
     // IEEE 754 double precision
-    const protoc::int64_t ix = 0x0001020304050607;
-    const input_range::const_iterator data = current.range.begin();
-    protoc::float64_t result;
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[0]] = static_cast<protoc::int8_t>(data[0]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[1]] = static_cast<protoc::int8_t>(data[1]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[2]] = static_cast<protoc::int8_t>(data[2]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[3]] = static_cast<protoc::int8_t>(data[3]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[4]] = static_cast<protoc::int8_t>(data[4]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[5]] = static_cast<protoc::int8_t>(data[5]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[6]] = static_cast<protoc::int8_t>(data[6]);
-    ((volatile protoc::int8_t *)&result)[((protoc::int8_t *)&ix)[7]] = static_cast<protoc::int8_t>(data[7]);
-    return result;
+    return protoc::endian::load_big<protoc::float64_t>(current.range.begin());
 }
 
 std::string decoder::get_string() const
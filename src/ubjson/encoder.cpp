@@ -18,6 +18,7 @@
 #include <limits>
 #include <algorithm> // std::copy
 #include <boost/math/special_functions/fpclassify.hpp>
+#include <protoc/endian.hpp>
 #include <protoc/ubjson/encoder.hpp>
 
 namespace protoc
@@ -45,13 +46,15 @@ std::size_t encoder::put(protoc::int8_t value)
     const output::value_type type('B');
     const std::size_t size = sizeof(type) + sizeof(protoc::int8_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    buffer.write(static_cast<output::value_type>(value));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -61,14 +64,15 @@ std::size_t encoder::put(protoc::int16_t value)
     const output::value_type type('i');
     const std::size_t size = sizeof(type) + sizeof(protoc::int16_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    buffer.write(static_cast<output::value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<output::value_type>(value & 0xFF));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -78,16 +82,15 @@ std::size_t encoder::put(protoc::int32_t value)
     const output::value_type type('I');
     const std::size_t size = sizeof(type) + sizeof(protoc::int32_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    buffer.write(static_cast<output::value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<output::value_type>(value & 0xFF));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -97,20 +100,15 @@ std::size_t encoder::put(protoc::int64_t value)
     const output::value_type type('L');
     const std::size_t size = sizeof(type) + sizeof(protoc::int64_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    buffer.write(static_cast<output::value_type>((value >> 54) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 48) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 40) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 32) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 24) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 16) & 0xFF));
-    buffer.write(static_cast<output::value_type>((value >> 8) & 0xFF));
-    buffer.write(static_cast<output::value_type>(value & 0xFF));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -127,19 +125,15 @@ std::size_t encoder::put(protoc::float32_t value)
     const output::value_type type('d');
     const std::size_t size = sizeof(type) + sizeof(protoc::float32_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    // IEEE 754 single precision
-    const protoc::int32_t ix = 0x00010203;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[0]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[1]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[2]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[3]]));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -153,27 +147,18 @@ std::size_t encoder::put(protoc::float64_t value)
         return put();
     }
 
-
     const output::value_type type('D');
     const std::size_t size = sizeof(type) + sizeof(protoc::float64_t);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(type);
-    // IEEE 754 double precision
-    const protoc::int64_t ix = 0x0001020304050607;
-    protoc::int8_t *value_buffer = (protoc::int8_t *)&value;
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[0]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[1]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[2]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[3]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[4]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[5]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[6]]));
-    buffer.write(static_cast<output::value_type>(value_buffer[((protoc::int8_t *)&ix)[7]]));
+    *position++ = type;
+    position = write(position, value);
+    buffer.commit(position);
 
     return size;
 }
@@ -185,60 +170,21 @@ std::size_t encoder::put(const char *value)
 
 std::size_t encoder::put(const std::string& value)
 {
-    const output::value_type type('s');
     const std::string::size_type length = value.size();
-    std::size_t size = 0;
 
     if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int8_t>::max()))
     {
-        if (buffer.grow(sizeof(type) + sizeof('B') + sizeof(protoc::int8_t) + length))
-        {
-            buffer.write(type);
-            size = put(static_cast<int8_t>(length));
-            if (size > 0)
-                goto success;
-        }
+        return put_string('B', static_cast<protoc::int8_t>(length), value);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int16_t>::max()))
     {
-        if (buffer.grow(sizeof(type) + sizeof('i') + sizeof(protoc::int16_t) + length))
-        {
-            buffer.write(type);
-            size = put(static_cast<int16_t>(length));
-            if (size > 0)
-                goto success;
-        }
+        return put_string('i', static_cast<protoc::int16_t>(length), value);
     }
     else if (length < static_cast<std::string::size_type>(std::numeric_limits<protoc::int32_t>::max()))
     {
-        if (buffer.grow(sizeof(type) + sizeof('I') + sizeof(protoc::int32_t) + length))
-        {
-            buffer.write(type);
-            size = put(static_cast<int32_t>(length));
-            if (size > 0)
-                goto success;
-            
-        }
-    }
-    else
-    {
-        if (buffer.grow(sizeof(type) + sizeof('L') + sizeof(protoc::int64_t) + length))
-        {
-            buffer.write(type);
-            size = put(static_cast<int64_t>(length));
-            if (size > 0)
-                goto success;
-        }
+        return put_string('I', static_cast<protoc::int32_t>(length), value);
     }
-    return 0;
-
- success:
-    for (std::string::const_iterator it = value.begin(); it != value.end(); ++it)
-    {
-        buffer.write(*it);
-    }
-
-    return sizeof(type) + size + length;
+    return put_string('L', static_cast<protoc::int64_t>(length), value);
 }
 
 std::size_t encoder::put_object_begin()
@@ -265,15 +211,80 @@ std::size_t encoder::put_token(output::value_type value)
 {
     const std::size_t size = sizeof(value);
 
-    if (!buffer.grow(size))
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
+    {
+        return 0;
+    }
+
+    *position++ = value;
+    buffer.commit(position);
+
+    return size;
+}
+
+template <typename T>
+std::size_t encoder::put_string(output::value_type length_type,
+                                T length,
+                                const std::string& value)
+{
+    const output::value_type type('s');
+    const std::size_t size = sizeof(type) + sizeof(length_type) + sizeof(T) + value.size();
+
+    output::value_type *position = buffer.reserve(size);
+    if (!position)
     {
         return 0;
     }
 
-    buffer.write(value);
+    *position++ = type;
+    *position++ = length_type;
+    position = write(position, length);
+    position = std::copy(value.begin(), value.end(), position);
+    buffer.commit(position);
 
     return size;
 }
 
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::int8_t value)
+{
+    *position++ = static_cast<output::value_type>(value);
+    return position;
+}
+
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::int16_t value)
+{
+    // Big-endian
+    return protoc::endian::store_big(position, value);
+}
+
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::int32_t value)
+{
+    return protoc::endian::store_big(position, value);
+}
+
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::int64_t value)
+{
+    return protoc::endian::store_big(position, value);
+}
+
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::float32_t value)
+{
+    // IEEE 754 single precision
+    return protoc::endian::store_big(position, value);
+}
+
+encoder::output::value_type *encoder::write(output::value_type *position,
+                                            protoc::float64_t value)
+{
+    // IEEE 754 double precision
+    return protoc::endian::store_big(position, value);
+}
+
 }
 }
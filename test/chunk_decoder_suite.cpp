@@ -0,0 +1,386 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <protoc/chunk_decoder.hpp>
+#include <protoc/json/decoder.hpp>
+#include <protoc/msgpack/detail/decoder.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
+#include <protoc/transenc/detail/decoder.hpp>
+#include <protoc/transenc/detail/codes.hpp>
+
+namespace json = protoc::json::detail;
+namespace msgpack = protoc::msgpack::detail;
+namespace transenc = protoc::transenc::detail;
+
+namespace
+{
+
+// Feeds the input in chunks of the given size and returns the token types
+template <typename Decoder, typename Value>
+std::vector<int> decode(const Value *first, const Value *last, std::size_t size)
+{
+    protoc::chunk_decoder<Decoder> input;
+    std::vector<int> result;
+    while (first != last)
+    {
+        const Value *end = (std::size_t(last - first) < size) ? last : first + size;
+        input.feed(first, end);
+        first = end;
+        while (!input.need_more())
+        {
+            result.push_back(input.current().type());
+            input.next();
+        }
+    }
+    input.finish();
+    result.push_back(input.current().type());
+    return result;
+}
+
+// Feeds the input in two chunks split at the given position and returns the
+// token types, including those that are only complete at the end of input
+template <typename Decoder, typename Value, typename Token>
+std::vector<int> decode_split(const Value *first,
+                              const Value *last,
+                              std::size_t split,
+                              Token eof,
+                              Token error)
+{
+    protoc::chunk_decoder<Decoder> input;
+    std::vector<int> result;
+    const Value *chunks[] = { first, first + split, last };
+    for (int i = 0; i < 2; ++i)
+    {
+        input.feed(chunks[i], chunks[i + 1]);
+        while (!input.need_more())
+        {
+            result.push_back(input.current().type());
+            if (input.current().type() == error)
+                return result;
+            input.next();
+        }
+    }
+    input.finish();
+    while ((input.current().type() != eof) && (input.current().type() != error))
+    {
+        result.push_back(input.current().type());
+        input.next();
+    }
+    result.push_back(input.current().type());
+    return result;
+}
+
+// Decodes the input in one piece and returns the token types
+template <typename Decoder, typename Value, typename Token>
+std::vector<int> decode_whole(const Value *first,
+                              const Value *last,
+                              Token eof,
+                              Token error)
+{
+    Decoder input(first, last);
+    std::vector<int> result;
+    while (input.type() != eof)
+    {
+        result.push_back(input.type());
+        if (input.type() == error)
+            return result;
+        input.next();
+    }
+    result.push_back(input.type());
+    return result;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(chunk_decoder_suite)
+
+//-----------------------------------------------------------------------------
+// JSON
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_json_empty)
+{
+    protoc::chunk_decoder<json::decoder> input;
+    BOOST_REQUIRE(input.need_more());
+    input.finish();
+    BOOST_REQUIRE(!input.need_more());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_keyword_split)
+{
+    const char first[] = "[tr";
+    const char second[] = "ue]";
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(first, first + sizeof(first) - 1);
+    BOOST_REQUIRE(!input.need_more());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_array_begin);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 2);
+    input.feed(second, second + sizeof(second) - 1);
+    BOOST_REQUIRE(!input.need_more());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_true);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_array_end);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_number_at_end)
+{
+    // A number at the end of a chunk may continue in the next chunk
+    const char first[] = "12";
+    const char second[] = "34";
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(first, first + sizeof(first) - 1);
+    BOOST_REQUIRE(input.need_more());
+    input.feed(second, second + sizeof(second) - 1);
+    BOOST_REQUIRE(input.need_more());
+    input.finish();
+    BOOST_REQUIRE(!input.need_more());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_integer);
+    BOOST_REQUIRE_EQUAL(input.current().get_integer(), 1234);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_string_view)
+{
+    // Tokens inside a chunk refer to the chunk itself
+    const std::string chunk("\"alpha\" \"be");
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(chunk.data(), chunk.data() + chunk.size());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_string);
+    BOOST_REQUIRE(input.current().get_string_view().begin() == chunk.data() + 1);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    const std::string rest("ta\"");
+    input.feed(rest.data(), rest.data() + rest.size());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_string);
+    BOOST_REQUIRE_EQUAL(input.current().get_string(), "beta");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_in_place_after_split)
+{
+    // Only the split token is buffered, and the rest of the chunk is
+    // decoded in place
+    const std::string chunk("[\"be");
+    const std::string rest("ta\",\"gamma\"]");
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(chunk.data(), chunk.data() + chunk.size());
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 3);
+    input.feed(rest.data(), rest.data() + rest.size());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_string);
+    BOOST_REQUIRE_EQUAL(input.current().get_string(), "beta");
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_comma);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_string);
+    BOOST_REQUIRE(input.current().get_string_view().begin() == rest.data() + 5);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_array_end);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_number_split)
+{
+    const std::string chunk("[12");
+    const std::string rest("34,5]");
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(chunk.data(), chunk.data() + chunk.size());
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    input.feed(rest.data(), rest.data() + rest.size());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_integer);
+    BOOST_REQUIRE_EQUAL(input.current().get_integer(), 1234);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_comma);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_integer);
+    BOOST_REQUIRE_EQUAL(input.current().get_integer(), 5);
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_array_end);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_string_many_chunks)
+{
+    // The buffer grows by one chunk per feed while the string is open
+    const std::string document("\"a\\\"b\\u0041c\" 1 ");
+    protoc::chunk_decoder<json::decoder> input;
+    std::size_t position = 0;
+    for (; input.need_more(); ++position)
+    {
+        BOOST_REQUIRE_EQUAL(input.pending(), position);
+        input.feed(document.data() + position, document.data() + position + 1);
+    }
+    BOOST_REQUIRE_EQUAL(position, 13);
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_string);
+    BOOST_REQUIRE_EQUAL(input.current().get_string(), "a\"bAc");
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+}
+
+BOOST_AUTO_TEST_CASE(test_json_every_split)
+{
+    const std::string document("{\"key\":[12.5,-3,true,null,\"a\\u00e6b\"],\"k2\":false} ");
+    const char *first = document.data();
+    const char *last = first + document.size();
+    const std::vector<int> expected = decode_whole<json::decoder>(first, last, json::token_eof, json::token_error);
+    for (std::size_t size = 1; size <= document.size(); ++size)
+    {
+        const std::vector<int> result = decode<json::decoder>(first, last, size);
+        BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                        expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_json_number_every_split_point)
+{
+    // Numbers whose prefix is out of range, but the whole number is not
+    const char *documents[] = {
+        "99999999999999999999e-5",
+        "[123456789012345678901.5]",
+        "[-9223372036854775808,9223372036854775807,1.7976931348623157e308]",
+        "[99999999999999999999]",
+        "[2e400 ,1]"
+    };
+    for (std::size_t i = 0; i < sizeof(documents) / sizeof(documents[0]); ++i)
+    {
+        const std::string document(documents[i]);
+        const char *first = document.data();
+        const char *last = first + document.size();
+        const std::vector<int> expected = decode_whole<json::decoder>(first, last, json::token_eof, json::token_error);
+        for (std::size_t split = 0; split <= document.size(); ++split)
+        {
+            const std::vector<int> result = decode_split<json::decoder>(first, last, split, json::token_eof, json::token_error);
+            BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                            expected.begin(), expected.end());
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_json_truncated)
+{
+    const char chunk[] = "[\"abc";
+    protoc::chunk_decoder<json::decoder> input;
+    input.feed(chunk, chunk + sizeof(chunk) - 1);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    input.finish();
+    BOOST_REQUIRE(!input.need_more());
+    BOOST_REQUIRE_EQUAL(input.current().type(), json::token_eof);
+}
+
+//-----------------------------------------------------------------------------
+// MessagePack
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_msgpack_string_split)
+{
+    const unsigned char first[] = { msgpack::code_fixarray_1, msgpack::code_str8, 0x03, 0x41 };
+    const unsigned char second[] = { 0x42, 0x43, msgpack::code_null };
+    protoc::chunk_decoder<msgpack::decoder> input;
+    input.feed(first, first + sizeof(first));
+    BOOST_REQUIRE_EQUAL(input.current().type(), msgpack::token_array8);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 3);
+    input.feed(second, second + sizeof(second));
+    BOOST_REQUIRE_EQUAL(input.current().type(), msgpack::token_str8);
+    BOOST_REQUIRE_EQUAL(input.current().get_string(), "ABC");
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), msgpack::token_null);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_in_place_after_split)
+{
+    const unsigned char first[] = { msgpack::code_fixarray_2, msgpack::code_str8 };
+    const unsigned char second[] = { 0x02, 0x41, 0x42, msgpack::code_fixstr_1, 0x43 };
+    protoc::chunk_decoder<msgpack::decoder> input;
+    input.feed(first, first + sizeof(first));
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 1);
+    input.feed(second, second + sizeof(second));
+    BOOST_REQUIRE_EQUAL(input.current().type(), msgpack::token_str8);
+    BOOST_REQUIRE_EQUAL(input.current().get_string(), "AB");
+    input.next();
+    BOOST_REQUIRE_EQUAL(input.current().type(), msgpack::token_str8);
+    BOOST_REQUIRE(input.current().get_string_view().begin() == second + 4);
+    input.next();
+    BOOST_REQUIRE(input.need_more());
+    BOOST_REQUIRE_EQUAL(input.pending(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_every_split)
+{
+    const unsigned char document[] = { msgpack::code_fixmap_2,
+                                       msgpack::code_fixstr_1, 0x61,
+                                       msgpack::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                       msgpack::code_str8, 0x01, 0x62,
+                                       msgpack::code_fixarray_3, msgpack::code_int16, 0x01, 0x00,
+                                       msgpack::code_bin8, 0x02, 0xC1, 0xC1,
+                                       msgpack::code_uint32, 0x00, 0x00, 0x00, 0x01 };
+    const std::vector<int> expected
+        = decode_whole<msgpack::decoder>(document, document + sizeof(document),
+                                      msgpack::token_eof, msgpack::token_error);
+    for (std::size_t size = 1; size <= sizeof(document); ++size)
+    {
+        const std::vector<int> result
+            = decode<msgpack::decoder>(document, document + sizeof(document), size);
+        BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                        expected.begin(), expected.end());
+    }
+}
+
+//-----------------------------------------------------------------------------
+// Transenc
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_transenc_every_split)
+{
+    const unsigned char document[] = { transenc::code_array_begin,
+                                       transenc::code_int32, 0x01, 0x02, 0x03, 0x04,
+                                       transenc::code_string_int8, 0x02, 0x41, 0x42,
+                                       transenc::code_true,
+                                       transenc::code_binary_int8, 0x01, transenc::code_map_end,
+                                       transenc::code_array_end };
+    const std::vector<int> expected
+        = decode_whole<transenc::decoder>(document, document + sizeof(document),
+                                      transenc::token_eof, transenc::token_error);
+    for (std::size_t size = 1; size <= sizeof(document); ++size)
+    {
+        const std::vector<int> result
+            = decode<transenc::decoder>(document, document + sizeof(document), size);
+        BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                        expected.begin(), expected.end());
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,117 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <protoc/endian.hpp>
+
+BOOST_AUTO_TEST_SUITE(endian_suite)
+
+//-----------------------------------------------------------------------------
+// Load
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_load_big_uint16)
+{
+    const unsigned char input[] = { 0x12, 0x34 };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_big<protoc::uint16_t>(input), 0x1234);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_little_uint16)
+{
+    const unsigned char input[] = { 0x12, 0x34 };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_little<protoc::uint16_t>(input), 0x3412);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_big_int32)
+{
+    const char input[] = { '\xFF', '\xFF', '\xFF', '\xFE' };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_big<protoc::int32_t>(input), -2);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_little_uint64)
+{
+    const unsigned char input[] = { 0x08, 0x07, 0x06, 0x05, 0x04, 0x03, 0x02, 0x01 };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_little<protoc::uint64_t>(input),
+                        0x0102030405060708ULL);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_unaligned)
+{
+    const unsigned char input[] = { 0x00, 0x01, 0x02, 0x03, 0x04 };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_big<protoc::uint32_t>(input + 1), 0x01020304U);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_big_float32)
+{
+    const unsigned char input[] = { 0x3F, 0xC0, 0x00, 0x00 };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_big<protoc::float32_t>(input), 1.5f);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_little_float64)
+{
+    const unsigned char input[] = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF8, 0x3F };
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_little<protoc::float64_t>(input), 1.5);
+}
+
+//-----------------------------------------------------------------------------
+// Store
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_store_big_uint32)
+{
+    unsigned char output[4];
+    unsigned char *position = protoc::endian::store_big(output, protoc::uint32_t(0x01020304));
+    BOOST_REQUIRE(position == output + 4);
+    BOOST_REQUIRE_EQUAL(output[0], 0x01);
+    BOOST_REQUIRE_EQUAL(output[1], 0x02);
+    BOOST_REQUIRE_EQUAL(output[2], 0x03);
+    BOOST_REQUIRE_EQUAL(output[3], 0x04);
+}
+
+BOOST_AUTO_TEST_CASE(test_store_little_int16)
+{
+    char output[2];
+    char *position = protoc::endian::store_little(output, protoc::int16_t(-2));
+    BOOST_REQUIRE(position == output + 2);
+    BOOST_REQUIRE_EQUAL(output[0], '\xFE');
+    BOOST_REQUIRE_EQUAL(output[1], '\xFF');
+}
+
+BOOST_AUTO_TEST_CASE(test_store_big_float64)
+{
+    unsigned char output[8];
+    protoc::endian::store_big(output, protoc::float64_t(1.5));
+    BOOST_REQUIRE_EQUAL(output[0], 0x3F);
+    BOOST_REQUIRE_EQUAL(output[1], 0xF8);
+    for (int i = 2; i < 8; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(output[i], 0x00);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_roundtrip_little_uint64)
+{
+    unsigned char output[9];
+    const protoc::uint64_t value = 0xFEDCBA9876543210ULL;
+    protoc::endian::store_little(output + 1, value);
+    BOOST_REQUIRE_EQUAL(protoc::endian::load_little<protoc::uint64_t>(output + 1), value);
+    BOOST_REQUIRE_EQUAL(output[1], 0x10);
+    BOOST_REQUIRE_EQUAL(output[8], 0xFE);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
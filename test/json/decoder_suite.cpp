@@ -17,6 +17,13 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <boost/math/special_functions/sign.hpp>
 #include <protoc/json/decoder.hpp>
 
 using namespace protoc;
@@ -229,6 +236,57 @@ BOOST_AUTO_TEST_CASE(test_fail_integer_minus_a)
     BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
 }
 
+BOOST_AUTO_TEST_CASE(test_integer_max)
+{
+    const char input[] = "9223372036854775807";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_integer);
+    BOOST_REQUIRE_EQUAL(decoder.get_integer(), std::numeric_limits<protoc::int64_t>::max());
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_integer_min)
+{
+    const char input[] = "-9223372036854775808";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_integer);
+    BOOST_REQUIRE_EQUAL(decoder.get_integer(), std::numeric_limits<protoc::int64_t>::min());
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_integer_leading_zeros)
+{
+    const char input[] = "[0000000000000000000000042]";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_array_begin);
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_integer);
+    BOOST_REQUIRE_EQUAL(decoder.get_integer(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_integer_overflow)
+{
+    const char input[] = "9223372036854775808";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_integer_underflow)
+{
+    const char input[] = "-9223372036854775809";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_integer_too_many_digits)
+{
+    const char input[] = "100000000000000000000";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
 //-----------------------------------------------------------------------------
 // Float
 //-----------------------------------------------------------------------------
@@ -369,6 +427,141 @@ BOOST_AUTO_TEST_CASE(test_fail_float_missing_exponent_minus)
     BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
 }
 
+BOOST_AUTO_TEST_CASE(test_float_minus_zero)
+{
+    const char input[] = "-0.0";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 0.0);
+    BOOST_REQUIRE(boost::math::signbit(decoder.get_float()));
+}
+
+BOOST_AUTO_TEST_CASE(test_float_fraction)
+{
+    const char input[] = "[0.1,3.14159,-2.5e-3,1.7976931348623157e308,5e-324]";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_array_begin);
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 0.1);
+    decoder.next();
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 3.14159);
+    decoder.next();
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), -2.5e-3);
+    decoder.next();
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), std::numeric_limits<double>::max());
+    decoder.next();
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), std::numeric_limits<double>::denorm_min());
+}
+
+BOOST_AUTO_TEST_CASE(test_float_many_digits)
+{
+    // More significant digits than the mantissa can hold
+    const char input[] = "3.141592653589793238462643383279";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 3.141592653589793238462643383279);
+}
+
+BOOST_AUTO_TEST_CASE(test_float_large_integer)
+{
+    const char input[] = "123456789012345678901234567890.0";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 123456789012345678901234567890.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_float_underflow)
+{
+    const char input[] = "1e-400";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+    BOOST_REQUIRE_EQUAL(decoder.get_float(), 0.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_float_overflow)
+{
+    const char input[] = "1e400";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_float_minus_overflow)
+{
+    const char input[] = "-1.8e308";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_float_huge_exponent)
+{
+    const char input[] = "1e99999999999";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_float_strtod)
+{
+    // Random decimal numbers from a linear congruential generator
+    protoc::uint64_t seed = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        const int digits = 1 + static_cast<int>((seed >> 8) % 25);
+        const int exponent = static_cast<int>((seed >> 16) % 660) - 340;
+        std::string text;
+        protoc::uint64_t random = seed;
+        for (int j = 0; j < digits; ++j)
+        {
+            random = random * 6364136223846793005ULL + 1442695040888963407ULL;
+            text += static_cast<char>('0' + (random >> 33) % 10);
+            if (j == 0)
+                text += '.';
+        }
+        if (text[text.size() - 1] == '.')
+            text += '0';
+        char suffix[16];
+        std::sprintf(suffix, "e%d", exponent);
+        text += suffix;
+
+        const double expected = std::strtod(text.c_str(), 0);
+        if (!(std::fabs(expected) <= std::numeric_limits<double>::max()))
+            continue;
+        json::detail::decoder decoder(text.data(), text.data() + text.size());
+        BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+        const double value = decoder.get_float();
+        BOOST_REQUIRE_MESSAGE(std::memcmp(&value, &expected, sizeof(value)) == 0, text);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_float_round_trip)
+{
+    protoc::uint64_t seed = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        double expected;
+        std::memcpy(&expected, &seed, sizeof(expected));
+        if (!(std::fabs(expected) <= std::numeric_limits<double>::max()))
+            continue; // NaN or infinity
+
+        char text[32];
+        const int size = std::sprintf(text, "%.17e", expected);
+        json::detail::decoder decoder(text, text + size);
+        BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_float);
+        const double value = decoder.get_float();
+        BOOST_REQUIRE_MESSAGE(std::memcmp(&value, &expected, sizeof(value)) == 0, text);
+    }
+}
+
 //-----------------------------------------------------------------------------
 // String
 //-----------------------------------------------------------------------------
@@ -533,6 +726,115 @@ BOOST_AUTO_TEST_CASE(test_string_escape_unicode_CDEF)
     BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
 }
 
+BOOST_AUTO_TEST_CASE(test_string_escape_unicode_lowercase)
+{
+    const char input[] = "\"\\u00e9\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    BOOST_REQUIRE_EQUAL(decoder.get_string(), "\u00E9");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_escape_unicode_surrogate_pair)
+{
+    const char input[] = "\"\\uD834\\uDD1E\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    BOOST_REQUIRE_EQUAL(decoder.get_string(), "\xF0\x9D\x84\x9E");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_escape_unicode_lone_surrogate)
+{
+    const char input[] = "\"\\uD834a\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    BOOST_REQUIRE_EQUAL(decoder.get_string(), "\xEF\xBF\xBD" "a");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_append)
+{
+    const char input[] = "\"alpha\\nbravo\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    std::string result("prefix:");
+    decoder.get_string(result);
+    BOOST_REQUIRE_EQUAL(result, "prefix:alpha\nbravo");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_buffer)
+{
+    const char input[] = "\"al\\tpha\\u0062\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    char buffer[7];
+    char *end = decoder.get_string(buffer, buffer + sizeof(buffer));
+    BOOST_REQUIRE(end != 0);
+    BOOST_REQUIRE_EQUAL(std::string(buffer, end), "al\tphab");
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_string_buffer_too_small)
+{
+    const char input[] = "\"alpha\\u00e9\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    char buffer[6];
+    BOOST_REQUIRE(decoder.get_string(buffer, buffer + sizeof(buffer)) == 0);
+    BOOST_REQUIRE(decoder.get_string(buffer, buffer + 4) == 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_utf8)
+{
+    const char input[] = "\"\xC3\xA9t\xC3\xA9\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_string);
+    BOOST_REQUIRE_EQUAL(decoder.get_string(), "\xC3\xA9t\xC3\xA9");
+    decoder.next();
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_long)
+{
+    // Place special characters at every offset to cover vectorized scanning
+    for (std::size_t offset = 0; offset < 70; ++offset)
+    {
+        const std::string text(offset, 'a');
+        const std::string plain = "\"" + text + "\"";
+        json::detail::decoder plain_decoder(plain.data(), plain.data() + plain.size());
+        BOOST_REQUIRE_EQUAL(plain_decoder.type(), json::detail::token_string);
+        BOOST_REQUIRE_EQUAL(plain_decoder.get_string(), text);
+
+        const std::string escaped = "\"" + text + "\\n" + text + "\"";
+        json::detail::decoder escaped_decoder(escaped.data(), escaped.data() + escaped.size());
+        BOOST_REQUIRE_EQUAL(escaped_decoder.type(), json::detail::token_string);
+        BOOST_REQUIRE_EQUAL(escaped_decoder.get_string(), text + "\n" + text);
+
+        const std::string utf8 = "\"" + text + "\xC3\xA9" + text + "\"";
+        json::detail::decoder utf8_decoder(utf8.data(), utf8.data() + utf8.size());
+        BOOST_REQUIRE_EQUAL(utf8_decoder.type(), json::detail::token_string);
+        BOOST_REQUIRE_EQUAL(utf8_decoder.get_string(), text + "\xC3\xA9" + text);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_string_utf8_truncated)
+{
+    const char input[] = "\"\xC3";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_string_utf8_continuation)
+{
+    const char input[] = "\"\xC3" "a\"";
+    json::detail::decoder decoder(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_fail_string_long_eof)
+{
+    const std::string input = "\"" + std::string(40, 'a');
+    json::detail::decoder decoder(input.data(), input.data() + input.size());
+    BOOST_REQUIRE_EQUAL(decoder.type(), json::detail::token_eof);
+}
+
 BOOST_AUTO_TEST_CASE(test_fail_string_escape_unicode_missing_one)
 {
     const char input[] = "\"\\u000\"";
@@ -0,0 +1,271 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <protoc/exceptions.hpp>
+#include <protoc/json/document.hpp>
+
+namespace format = protoc::json;
+
+namespace
+{
+
+struct fixture
+{
+    fixture(const std::string& input)
+        : input(input),
+          doc(this->input.data(), this->input.data() + this->input.size())
+    {
+    }
+
+    std::string input;
+    format::document doc;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(json_document_suite)
+
+//-----------------------------------------------------------------------------
+// Basic types
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_null)
+{
+    fixture data("null");
+    BOOST_REQUIRE_EQUAL(data.doc.root().type(), protoc::token::token_null);
+    BOOST_REQUIRE(data.doc.root().is_null());
+}
+
+BOOST_AUTO_TEST_CASE(test_boolean)
+{
+    fixture data(" true ");
+    BOOST_REQUIRE_EQUAL(data.doc.root().type(), protoc::token::token_boolean);
+    BOOST_REQUIRE_EQUAL(data.doc.root().get_bool(), true);
+}
+
+BOOST_AUTO_TEST_CASE(test_integer)
+{
+    fixture data("-42");
+    BOOST_REQUIRE_EQUAL(data.doc.root().type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(data.doc.root().get_integer(), -42);
+    BOOST_REQUIRE_EQUAL(data.doc.root().get_double(), -42.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_floating)
+{
+    fixture data("1.5e1");
+    BOOST_REQUIRE_EQUAL(data.doc.root().type(), protoc::token::token_floating);
+    BOOST_REQUIRE_EQUAL(data.doc.root().get_double(), 15.0);
+    BOOST_REQUIRE_THROW(data.doc.root().get_integer(), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(test_string)
+{
+    fixture data("\"alpha\"");
+    format::document::value root = data.doc.root();
+    BOOST_REQUIRE_EQUAL(root.type(), protoc::token::token_string);
+    BOOST_REQUIRE_EQUAL(root.get_string(), "alpha");
+    BOOST_REQUIRE_EQUAL(root.has_escapes(), false);
+    protoc::string_view view = root.get_string_view();
+    BOOST_REQUIRE(view.begin() == data.input.data() + 1);
+    BOOST_REQUIRE_EQUAL(view.size(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_escaped)
+{
+    fixture data("\"a\\\"b\\n\"");
+    format::document::value root = data.doc.root();
+    BOOST_REQUIRE_EQUAL(root.has_escapes(), true);
+    BOOST_REQUIRE_EQUAL(root.get_string(), "a\"b\n");
+}
+
+//-----------------------------------------------------------------------------
+// Containers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array)
+{
+    fixture data("[1, [2, 3], {\"A\": [4]}, \"five\"]");
+    format::document::value root = data.doc.root();
+    BOOST_REQUIRE_EQUAL(root.type(), protoc::token::token_array_begin);
+    BOOST_REQUIRE_EQUAL(root.size(), 4);
+    BOOST_REQUIRE_EQUAL(root[0].get_integer(), 1);
+    BOOST_REQUIRE_EQUAL(root[1].size(), 2);
+    BOOST_REQUIRE_EQUAL(root[1][1].get_integer(), 3);
+    BOOST_REQUIRE_EQUAL(root[2]["A"][0].get_integer(), 4);
+    BOOST_REQUIRE_EQUAL(root[3].get_string(), "five");
+    BOOST_REQUIRE_THROW(root[4], protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(test_array_empty)
+{
+    fixture data("[ ]");
+    BOOST_REQUIRE_EQUAL(data.doc.root().size(), 0);
+    BOOST_REQUIRE(data.doc.root().begin() == data.doc.root().end());
+}
+
+BOOST_AUTO_TEST_CASE(test_object)
+{
+    fixture data("{\"alpha\":1,\"bravo\":{\"charlie\":[true,null]},\"delta\":\"echo\"}");
+    format::document::value root = data.doc.root();
+    BOOST_REQUIRE_EQUAL(root.type(), protoc::token::token_map_begin);
+    BOOST_REQUIRE_EQUAL(root.size(), 3);
+    BOOST_REQUIRE_EQUAL(root["alpha"].get_integer(), 1);
+    BOOST_REQUIRE_EQUAL(root["bravo"]["charlie"][0].get_bool(), true);
+    BOOST_REQUIRE(root["bravo"]["charlie"][1].is_null());
+    BOOST_REQUIRE_EQUAL(root[std::string("delta")].get_string(), "echo");
+    BOOST_REQUIRE_THROW(root["foxtrot"], protoc::invalid_value);
+
+    format::document::value result;
+    BOOST_REQUIRE(root.find("bravo", result));
+    BOOST_REQUIRE_EQUAL(result.size(), 1);
+    BOOST_REQUIRE(!root.find("charlie", result));
+}
+
+BOOST_AUTO_TEST_CASE(test_object_escaped_key)
+{
+    fixture data("{\"a\\u0062\":1,\"ab\":2}");
+    BOOST_REQUIRE_EQUAL(data.doc.root()["ab"].get_integer(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_range)
+{
+    fixture data("{\"alpha\": [1, 2] }");
+    protoc::string_view range = data.doc.root()["alpha"].get_range();
+    BOOST_REQUIRE_EQUAL(std::string(range.begin(), range.end()), "[1, 2]");
+}
+
+BOOST_AUTO_TEST_CASE(test_tape_size)
+{
+    // Object, two keys, array with two elements, and a string
+    fixture data("{\"A\":[1,2],\"B\":\"C\"}");
+    BOOST_REQUIRE_EQUAL(data.doc.size(), 7);
+}
+
+//-----------------------------------------------------------------------------
+// Iteration
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_iterate_array)
+{
+    fixture data("[1,[2,[3]],4]");
+    format::document::value root = data.doc.root();
+    format::document::value::const_iterator it = root.begin();
+    BOOST_REQUIRE_EQUAL((*it).get_integer(), 1);
+    ++it;
+    BOOST_REQUIRE_EQUAL((*it).size(), 2);
+    ++it;
+    BOOST_REQUIRE_EQUAL((*it).get_integer(), 4);
+    ++it;
+    BOOST_REQUIRE(it == root.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_iterate_object)
+{
+    fixture data("{\"A\":{\"X\":0},\"B\":2}");
+    format::document::value root = data.doc.root();
+    format::document::value::const_iterator it = root.begin();
+    BOOST_REQUIRE_EQUAL(it.key(), "A");
+    BOOST_REQUIRE_EQUAL((*it)["X"].get_integer(), 0);
+    it++;
+    BOOST_REQUIRE_EQUAL(it.key(), "B");
+    BOOST_REQUIRE_EQUAL((*it).get_integer(), 2);
+    ++it;
+    BOOST_REQUIRE(it == root.end());
+}
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fail_empty)
+{
+    BOOST_REQUIRE_THROW(fixture data(""), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_unbalanced)
+{
+    BOOST_REQUIRE_THROW(fixture data("[1,2"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[1,2}"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("]"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_separator)
+{
+    BOOST_REQUIRE_THROW(fixture data("[1 2]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[1,]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("{\"A\" 1}"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("{1:1}"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_literal)
+{
+    BOOST_REQUIRE_THROW(fixture data("nul"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[tru]"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_trailing)
+{
+    BOOST_REQUIRE_THROW(fixture data("1 2"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_unterminated_string)
+{
+    BOOST_REQUIRE_THROW(fixture data("[\"abc]"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_number)
+{
+    BOOST_REQUIRE_THROW(fixture data("[1-2, 3]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("1-2+3"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("-"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[-a]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[1.]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("[1e+]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(fixture data("01"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(test_number_syntax)
+{
+    fixture data("[0, -0.5, 1E+2, 2e-1]");
+    BOOST_REQUIRE_EQUAL(data.doc.root()[0].type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(data.doc.root()[1].get_double(), -0.5);
+    BOOST_REQUIRE_EQUAL(data.doc.root()[2].get_double(), 100.0);
+    BOOST_REQUIRE_EQUAL(data.doc.root()[3].type(), protoc::token::token_floating);
+}
+
+BOOST_AUTO_TEST_CASE(fail_lazy_string)
+{
+    // Malformed UTF-8 and escape sequences are only detected when the string
+    // is requested
+    fixture data("[\"\xC3\x28\", \"\\x\", \"ok\"]");
+    BOOST_REQUIRE_EQUAL(data.doc.root()[2].get_string(), "ok");
+    BOOST_REQUIRE_THROW(data.doc.root()[0].get_string(), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(data.doc.root()[0].get_string_view(), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(data.doc.root()[1].get_string(), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(fail_max_depth)
+{
+    BOOST_REQUIRE_THROW(fixture data(std::string(2000, '[') + std::string(2000, ']')),
+                        protoc::invalid_scope);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
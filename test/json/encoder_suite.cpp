@@ -17,6 +17,8 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <cstdlib> // std::strtod
+#include <cstring> // std::memcpy
 #include <sstream>
 #include <limits>
 #include <protoc/types.hpp>
@@ -391,6 +393,76 @@ BOOST_AUTO_TEST_CASE(test_float_nan)
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
+BOOST_AUTO_TEST_CASE(test_float_shortest)
+{
+    const double values[] = { 0.1, 0.3, 123.456, 1e16, 1e17, 1e-3, 1e-4, 1e-5, 5e-324, -2.5e-10 };
+    const char *expected[] = { "0.1", "0.3", "123.456", "10000000000000000", "1e+17", "0.001", "0.0001", "1e-05", "5e-324", "-2.5e-10" };
+    for (std::size_t i = 0; i < sizeof(values) / sizeof(values[0]); ++i)
+    {
+        std::ostringstream result;
+        test_stream buffer(result);
+        json::detail::encoder encoder(buffer);
+        BOOST_REQUIRE_EQUAL(encoder.put(values[i]), std::strlen(expected[i]));
+        BOOST_REQUIRE_EQUAL(result.str(), expected[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_float_round_trip)
+{
+    // Bit patterns from a linear congruential generator cover the full range
+    protoc::uint64_t seed = 1;
+    for (int i = 0; i < 100000; ++i)
+    {
+        seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+        double value;
+        std::memcpy(&value, &seed, sizeof(value));
+        if (value != value)
+            continue; // NaN
+        if ((value == std::numeric_limits<double>::infinity()) ||
+            (value == -std::numeric_limits<double>::infinity()))
+            continue;
+
+        std::ostringstream result;
+        test_stream buffer(result);
+        json::detail::encoder encoder(buffer);
+        BOOST_REQUIRE(encoder.put(value) > 0);
+        const std::string text = result.str();
+        const double parsed = std::strtod(text.c_str(), 0);
+        protoc::uint64_t parsed_bits;
+        std::memcpy(&parsed_bits, &parsed, sizeof(parsed_bits));
+        BOOST_REQUIRE_MESSAGE(parsed_bits == seed, text);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_float_round_trip_integers)
+{
+    for (int i = -1000; i <= 1000; ++i)
+    {
+        const double value = i / 8.0;
+        std::ostringstream result;
+        test_stream buffer(result);
+        json::detail::encoder encoder(buffer);
+        BOOST_REQUIRE(encoder.put(value) > 0);
+        BOOST_REQUIRE_EQUAL(std::strtod(result.str().c_str(), 0), value);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_float_buffer_too_small)
+{
+    test_array<2> buffer;
+    json::detail::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put(0.25), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_int64_buffer_too_small)
+{
+    test_array<2> buffer;
+    json::detail::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put(protoc::int64_t(-10)), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+}
+
 //-----------------------------------------------------------------------------
 // String
 //-----------------------------------------------------------------------------
@@ -36,6 +36,7 @@ BOOST_AUTO_TEST_CASE(test_empty)
 {
     std::ostringstream result;
     json::stream_oarchive ar(result);
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "");
 }
 
@@ -45,6 +46,7 @@ BOOST_AUTO_TEST_CASE(test_false)
     json::stream_oarchive out(result);
     bool value = false;
     out << value;
+    out.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "false");
 }
 
@@ -54,6 +56,7 @@ BOOST_AUTO_TEST_CASE(test_const_false)
     json::stream_oarchive out(result);
     const bool value = false;
     out << value;
+    out.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "false");
 }
 
@@ -63,6 +66,7 @@ BOOST_AUTO_TEST_CASE(test_true)
     json::stream_oarchive out(result);
     bool value = true;
     out << value;
+    out.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "true");
 }
 
@@ -72,6 +76,7 @@ BOOST_AUTO_TEST_CASE(test_const_true)
     json::stream_oarchive out(result);
     const bool value = true;
     out << value;
+    out.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "true");
 }
 
@@ -85,6 +90,7 @@ BOOST_AUTO_TEST_CASE(test_int_zero)
     json::stream_oarchive ar(result);
     int value = 0;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "0");
 }
 
@@ -94,6 +100,7 @@ BOOST_AUTO_TEST_CASE(test_const_int_zero)
     json::stream_oarchive ar(result);
     const int value = 0;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "0");
 }
 
@@ -103,6 +110,7 @@ BOOST_AUTO_TEST_CASE(test_int_one)
     json::stream_oarchive ar(result);
     int value = 1;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "1");
 }
 
@@ -112,6 +120,7 @@ BOOST_AUTO_TEST_CASE(test_int_minus_one)
     json::stream_oarchive ar(result);
     int value = -1;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "-1");
 }
 
@@ -125,6 +134,7 @@ BOOST_AUTO_TEST_CASE(test_double_one)
     json::stream_oarchive ar(result);
     double value = 1.0;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "1");
 }
 
@@ -134,6 +144,7 @@ BOOST_AUTO_TEST_CASE(test_const_double_one)
     json::stream_oarchive ar(result);
     const double value = 1.0;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "1");
 }
 
@@ -143,6 +154,7 @@ BOOST_AUTO_TEST_CASE(test_double_half)
     json::stream_oarchive ar(result);
     double value = 0.5;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "0.5");
 }
 
@@ -152,6 +164,7 @@ BOOST_AUTO_TEST_CASE(test_double_max)
     json::stream_oarchive ar(result);
     double value = std::numeric_limits<double>::max();
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "1.7976931348623157e+308");
 }
 
@@ -161,6 +174,7 @@ BOOST_AUTO_TEST_CASE(test_double_min)
     json::stream_oarchive ar(result);
     double value = std::numeric_limits<double>::min();
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "2.2250738585072014e-308");
 }
 
@@ -170,6 +184,7 @@ BOOST_AUTO_TEST_CASE(test_double_infinity)
     json::stream_oarchive ar(result);
     double value = std::numeric_limits<double>::infinity();
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
@@ -179,6 +194,7 @@ BOOST_AUTO_TEST_CASE(test_double_minus_infinity)
     json::stream_oarchive ar(result);
     double value = -std::numeric_limits<double>::infinity();
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
@@ -188,6 +204,7 @@ BOOST_AUTO_TEST_CASE(test_double_nan)
     json::stream_oarchive ar(result);
     double value = std::numeric_limits<double>::quiet_NaN();
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
@@ -201,6 +218,7 @@ BOOST_AUTO_TEST_CASE(test_string_empty)
     json::stream_oarchive ar(result);
     std::string value("");
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\"\"");
 }
 
@@ -210,6 +228,7 @@ BOOST_AUTO_TEST_CASE(test_const_string_empty)
     json::stream_oarchive ar(result);
     const std::string value("");
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\"\"");
 }
 
@@ -219,6 +238,7 @@ BOOST_AUTO_TEST_CASE(test_string_alpha)
     json::stream_oarchive ar(result);
     std::string value("alpha");
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\"alpha\"");
 }
 
@@ -232,6 +252,7 @@ BOOST_AUTO_TEST_CASE(test_pair)
     json::stream_oarchive ar(result);
     std::pair<std::string, bool> value("alpha", true);
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[\"alpha\",true]");
 }
 
@@ -241,6 +262,7 @@ BOOST_AUTO_TEST_CASE(test_const_pair)
     json::stream_oarchive ar(result);
     const std::pair<std::string, bool> value("alpha", true);
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[\"alpha\",true]");
 }
 
@@ -254,6 +276,7 @@ BOOST_AUTO_TEST_CASE(test_optional)
     json::stream_oarchive ar(result);
     boost::optional<std::string> value("alpha");
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\"alpha\"");
 }
 
@@ -263,6 +286,7 @@ BOOST_AUTO_TEST_CASE(test_optional_null)
     json::stream_oarchive ar(result);
     boost::optional<std::string> value;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
@@ -272,6 +296,7 @@ BOOST_AUTO_TEST_CASE(test_const_optional)
     json::stream_oarchive ar(result);
     const boost::optional<std::string> value("alpha");
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\"alpha\"");
 }
 
@@ -281,6 +306,7 @@ BOOST_AUTO_TEST_CASE(test_const_optional_null)
     json::stream_oarchive ar(result);
     const boost::optional<std::string> value;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "null");
 }
 
@@ -294,6 +320,7 @@ BOOST_AUTO_TEST_CASE(test_nvp)
     json::stream_oarchive out(result);
     bool value = false;
     out << boost::serialization::make_nvp("value", value);
+    out.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "{\"value\":false}");
 }
 //-----------------------------------------------------------------------------
@@ -306,6 +333,7 @@ BOOST_AUTO_TEST_CASE(test_array_bool_empty)
     json::stream_oarchive ar(result);
     std::vector<bool> value;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[]");
 }
 
@@ -316,6 +344,7 @@ BOOST_AUTO_TEST_CASE(test_array_bool_one)
     std::vector<bool> value;
     value.push_back(true);
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[true]");
 }
 
@@ -327,6 +356,7 @@ BOOST_AUTO_TEST_CASE(test_array_bool_two)
     value.push_back(true);
     value.push_back(false);
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[true,false]");
 }
 
@@ -336,6 +366,7 @@ BOOST_AUTO_TEST_CASE(test_object_bool_empty)
     json::stream_oarchive ar(result);
     std::map<std::string, bool> value;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "{}");
 }
 
@@ -346,6 +377,7 @@ BOOST_AUTO_TEST_CASE(test_object_bool_one)
     std::map<std::string, bool> value;
     value["A"] = true;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "{\"A\":true}");
 }
 
@@ -357,6 +389,7 @@ BOOST_AUTO_TEST_CASE(test_object_bool_two)
     value["A"] = true;
     value["B"] = false;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "{\"A\":true,\"B\":false}");
 }
 
@@ -366,6 +399,7 @@ BOOST_AUTO_TEST_CASE(test_nonobject_bool_empty)
     json::stream_oarchive ar(result);
     std::map<int, bool> value;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[]");
 }
 
@@ -376,6 +410,7 @@ BOOST_AUTO_TEST_CASE(test_nonobject_bool_one)
     std::map<int, bool> value;
     value[2] = true;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[[2,true]]");
 }
 
@@ -387,6 +422,7 @@ BOOST_AUTO_TEST_CASE(test_nonobject_bool_two)
     value[2] = true;
     value[4] = false;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[[2,true],[4,false]]");
 }
 
@@ -414,6 +450,7 @@ BOOST_AUTO_TEST_CASE(test_array_struct)
     json::stream_oarchive ar(result);
     person value("Kant", 127);
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "[{\"name\":\"Kant\"},{\"age\":127}]");
 }
 
@@ -0,0 +1,187 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <protoc/json/parser.hpp>
+
+namespace format = protoc::json;
+
+namespace
+{
+
+// Records the handler calls as a space separated trace
+struct recorder
+{
+    void on_null() { add("null"); }
+    void on_bool(bool value) { add(value ? "true" : "false"); }
+    void on_int(protoc::int64_t value) { std::ostringstream s; s << value; add(s.str()); }
+    void on_double(protoc::float64_t value) { std::ostringstream s; s << value << "f"; add(s.str()); }
+    void on_string(const protoc::string_view& value) { add("\"" + std::string(value.begin(), value.end()) + "\""); }
+    void on_binary(const protoc::binary_view& value) { std::ostringstream s; s << "bin" << value.size(); add(s.str()); }
+    void on_record_begin() { add("("); }
+    void on_record_end() { add(")"); }
+    void on_array_begin() { add("["); }
+    void on_array_end() { add("]"); }
+    void on_map_begin() { add("{"); }
+    void on_map_end() { add("}"); }
+
+    void add(const std::string& value)
+    {
+        if (!trace.empty())
+            trace += " ";
+        trace += value;
+    }
+
+    std::string trace;
+};
+
+std::string parse(const std::string& input)
+{
+    recorder handler;
+    format::parse(input, handler);
+    return handler.trace;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(json_parser_suite)
+
+//-----------------------------------------------------------------------------
+// Basic types
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_null)
+{
+    BOOST_REQUIRE_EQUAL(parse("null"), "null");
+}
+
+BOOST_AUTO_TEST_CASE(test_boolean)
+{
+    BOOST_REQUIRE_EQUAL(parse("true"), "true");
+    BOOST_REQUIRE_EQUAL(parse(" false "), "false");
+}
+
+BOOST_AUTO_TEST_CASE(test_integer)
+{
+    BOOST_REQUIRE_EQUAL(parse("-42"), "-42");
+}
+
+BOOST_AUTO_TEST_CASE(test_floating)
+{
+    BOOST_REQUIRE_EQUAL(parse("1.5"), "1.5f");
+}
+
+BOOST_AUTO_TEST_CASE(test_string)
+{
+    BOOST_REQUIRE_EQUAL(parse("\"alpha\""), "\"alpha\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_escaped)
+{
+    BOOST_REQUIRE_EQUAL(parse("\"a\\nb\""), "\"a\nb\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_string_view)
+{
+    // Unescaped strings refer to the input buffer
+    struct viewer : public recorder
+    {
+        void on_string(const protoc::string_view& value) { view = value; }
+        protoc::string_view view;
+    } handler;
+    const std::string input("\"alpha\"");
+    format::parse(input, handler);
+    BOOST_REQUIRE(handler.view.begin() == input.data() + 1);
+    BOOST_REQUIRE_EQUAL(handler.view.size(), 5);
+}
+
+//-----------------------------------------------------------------------------
+// Containers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_empty)
+{
+    BOOST_REQUIRE_EQUAL(parse("[]"), "[ ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_array)
+{
+    BOOST_REQUIRE_EQUAL(parse("[null,true,1,\"a\"]"), "[ null true 1 \"a\" ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_map_empty)
+{
+    BOOST_REQUIRE_EQUAL(parse("{}"), "{ }");
+}
+
+BOOST_AUTO_TEST_CASE(test_map)
+{
+    BOOST_REQUIRE_EQUAL(parse("{\"a\":1,\"b\":[2,{}]}"), "{ \"a\" 1 \"b\" [ 2 { } ] }");
+}
+
+BOOST_AUTO_TEST_CASE(test_nested)
+{
+    BOOST_REQUIRE_EQUAL(parse("[[[]],[{\"k\":[true]}]]"), "[ [ [ ] ] [ { \"k\" [ true ] } ] ]");
+}
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fail_empty)
+{
+    BOOST_REQUIRE_THROW(parse(""), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_trailing)
+{
+    BOOST_REQUIRE_THROW(parse("true false"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_array_unbalanced)
+{
+    BOOST_REQUIRE_THROW(parse("[1"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("[1}"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("]"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_array_commas)
+{
+    BOOST_REQUIRE_THROW(parse("[1 2]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("[1,]"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("[,1]"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_map_key)
+{
+    BOOST_REQUIRE_THROW(parse("{1:2}"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("{\"a\"}"), protoc::unexpected_token);
+    BOOST_REQUIRE_THROW(parse("{\"a\":1,}"), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_partial_trace)
+{
+    // Values before the error have been delivered
+    recorder handler;
+    BOOST_REQUIRE_THROW(format::parse(std::string("[1,2,:"), handler), protoc::unexpected_token);
+    BOOST_REQUIRE_EQUAL(handler.trace, "[ 1 2");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
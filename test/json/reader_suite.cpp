@@ -17,6 +17,7 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <string>
 #include <protoc/json/reader.hpp>
 
 using namespace protoc;
@@ -88,6 +89,41 @@ BOOST_AUTO_TEST_CASE(test_string)
     BOOST_REQUIRE_EQUAL(reader.next(), false);
 }
 
+BOOST_AUTO_TEST_CASE(test_string_view)
+{
+    const char input[] = "\"alpha\"";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_string);
+    json::reader::string_view_type view = reader.get_string_view();
+    BOOST_REQUIRE(view.begin() == input + 1);
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "alpha");
+    BOOST_REQUIRE_EQUAL(reader.has_escapes(), false);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_view_escaped)
+{
+    const char input[] = "[\"al\\npha\", \"bravo\"]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_string);
+    json::reader::string_view_type view = reader.get_string_view();
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "al\\npha");
+    BOOST_REQUIRE_EQUAL(reader.has_escapes(), true);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "al\npha");
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    view = reader.get_string_view();
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "bravo");
+    BOOST_REQUIRE_EQUAL(reader.has_escapes(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_string_view_fail)
+{
+    const char input[] = "true";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_THROW(reader.get_string_view(), protoc::invalid_value);
+}
+
 //-----------------------------------------------------------------------------
 // Array
 //-----------------------------------------------------------------------------
@@ -356,4 +392,121 @@ BOOST_AUTO_TEST_CASE(fail_object_missing_value)
     BOOST_REQUIRE_THROW(reader.next(), unexpected_token);
 }
 
+//-----------------------------------------------------------------------------
+// Sibling
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_integer)
+{
+    const char input[] = "[1,2]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 2);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_array)
+{
+    const char input[] = "[[1,[2,{}]],3]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_array_begin);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 3);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+    BOOST_REQUIRE_EQUAL(reader.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_object)
+{
+    const char input[] = "{\"a\":{\"b\":\"]}\\\"[\",\"c\":[{}]},\"d\":4}";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "a");
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_map_begin);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_string);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "d");
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 4);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_map_end);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_outermost)
+{
+    const char input[] = "[1,[2]]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_eof);
+    BOOST_REQUIRE_EQUAL(reader.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_array_end)
+{
+    const char input[] = "[[],1]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_array_end);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_mismatch)
+{
+    const char input[] = "[[1}]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    reader.next_sibling();
+    BOOST_REQUIRE_THROW(reader.type(), unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_eof)
+{
+    const char input[] = "[1,[2]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_unterminated_string)
+{
+    const char input[] = "[\"]\\\"]";
+    json::reader reader(input, input + sizeof(input) - 1);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), token::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(fail_max_depth)
+{
+    const std::string input(2000, '[');
+    json::reader reader(input.data(), input.data() + input.size());
+    reader.max_depth(3);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.size(), 3U);
+    BOOST_REQUIRE_THROW(reader.next(), invalid_scope);
+}
+
+BOOST_AUTO_TEST_CASE(fail_default_max_depth)
+{
+    const std::string input(2000, '[');
+    json::reader reader(input.data(), input.data() + input.size());
+    BOOST_REQUIRE_THROW(while (reader.next()) {}, invalid_scope);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1024U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,105 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <protoc/mapped_file.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
+
+namespace
+{
+
+// Creates a file with the given content and removes it afterwards
+struct scoped_file
+{
+    scoped_file(const std::string& content)
+        : path("protoc_mapped_file_suite.tmp")
+    {
+        std::ofstream file(path.c_str(), std::ios_base::out | std::ios_base::binary);
+        file.write(content.data(), content.size());
+    }
+
+    ~scoped_file()
+    {
+        std::remove(path.c_str());
+    }
+
+    std::string path;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(mapped_file_suite)
+
+BOOST_AUTO_TEST_CASE(test_content)
+{
+    scoped_file file("alpha");
+    protoc::mapped_file input(file.path);
+    BOOST_REQUIRE_EQUAL(input.size(), 5);
+    BOOST_REQUIRE(!input.empty());
+    BOOST_REQUIRE_EQUAL(std::string(input.data(), input.size()), "alpha");
+}
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    scoped_file file("");
+    protoc::mapped_file input(file.path.c_str(), protoc::mapped_file::random);
+    BOOST_REQUIRE(input.empty());
+    BOOST_REQUIRE_EQUAL(input.size(), 0);
+
+    protoc::json::reader reader(input);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_reader)
+{
+    scoped_file file("[\"alpha\",42]");
+    protoc::mapped_file input(file.path);
+    protoc::json::reader reader(input);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_begin);
+    BOOST_REQUIRE(reader.next());
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_string);
+    // The view points into the mapping
+    protoc::reader::string_view_type view = reader.get_string_view();
+    BOOST_REQUIRE(view.begin() == input.data() + 2);
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "alpha");
+    BOOST_REQUIRE(reader.next());
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 42);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_reader)
+{
+    const char content[] = { char(protoc::msgpack::detail::code_fixstr_2), 'A', 'B' };
+    scoped_file file(std::string(content, sizeof(content)));
+    protoc::mapped_file input(file.path);
+    protoc::msgpack::reader reader(input);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_string);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "AB");
+}
+
+BOOST_AUTO_TEST_CASE(fail_missing)
+{
+    BOOST_REQUIRE_THROW(protoc::mapped_file("protoc_mapped_file_suite.missing"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
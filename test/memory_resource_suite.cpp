@@ -0,0 +1,165 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <string>
+#include <vector>
+#include <protoc/memory_resource.hpp>
+
+namespace
+{
+
+// Counts the allocations forwarded to the global heap
+struct counting_resource : public protoc::memory_resource
+{
+    counting_resource() : allocated(0), deallocated(0) {}
+
+    virtual void *do_allocate(std::size_t size, std::size_t alignment)
+    {
+        ++allocated;
+        return protoc::new_delete_resource().allocate(size, alignment);
+    }
+
+    virtual void do_deallocate(void *pointer, std::size_t size, std::size_t alignment)
+    {
+        ++deallocated;
+        protoc::new_delete_resource().deallocate(pointer, size, alignment);
+    }
+
+    int allocated;
+    int deallocated;
+};
+
+typedef std::basic_string<char, std::char_traits<char>, protoc::polymorphic_allocator<char> > arena_string;
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(memory_resource_suite)
+
+//-----------------------------------------------------------------------------
+// Monotonic buffer
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_monotonic_alignment)
+{
+    protoc::monotonic_buffer_resource arena;
+    void *first = arena.allocate(1, 1);
+    void *second = arena.allocate(8, 8);
+    BOOST_REQUIRE(first != 0);
+    BOOST_REQUIRE(second != 0);
+    BOOST_REQUIRE_EQUAL(reinterpret_cast<std::size_t>(second) % 8, 0);
+    BOOST_REQUIRE(static_cast<char *>(second) > static_cast<char *>(first));
+}
+
+BOOST_AUTO_TEST_CASE(test_monotonic_blocks)
+{
+    counting_resource upstream;
+    {
+        protoc::monotonic_buffer_resource arena(64, upstream);
+        arena.allocate(16);
+        BOOST_REQUIRE_EQUAL(upstream.allocated, 1);
+        arena.allocate(16);
+        BOOST_REQUIRE_EQUAL(upstream.allocated, 1);
+        // Larger than the block
+        arena.allocate(1000);
+        BOOST_REQUIRE_EQUAL(upstream.allocated, 2);
+        // Deallocation is deferred
+        arena.deallocate(arena.allocate(16), 16);
+        BOOST_REQUIRE_EQUAL(upstream.deallocated, 0);
+    }
+    BOOST_REQUIRE_EQUAL(upstream.deallocated, upstream.allocated);
+}
+
+BOOST_AUTO_TEST_CASE(test_monotonic_release)
+{
+    counting_resource upstream;
+    protoc::monotonic_buffer_resource arena(64, upstream);
+    arena.allocate(100);
+    arena.allocate(100);
+    BOOST_REQUIRE_EQUAL(upstream.allocated, 2);
+    arena.release();
+    BOOST_REQUIRE_EQUAL(upstream.deallocated, 2);
+    arena.allocate(8);
+    BOOST_REQUIRE_EQUAL(upstream.allocated, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_monotonic_initial_buffer)
+{
+    char buffer[256];
+    counting_resource upstream;
+    protoc::monotonic_buffer_resource arena(buffer, sizeof(buffer), upstream);
+    char *first = static_cast<char *>(arena.allocate(100, 1));
+    BOOST_REQUIRE(first >= buffer && first < buffer + sizeof(buffer));
+    BOOST_REQUIRE_EQUAL(upstream.allocated, 0);
+    arena.allocate(200, 1);
+    BOOST_REQUIRE_EQUAL(upstream.allocated, 1);
+    arena.release();
+    // The initial buffer is reused after release
+    BOOST_REQUIRE(static_cast<char *>(arena.allocate(100, 1)) == first);
+}
+
+//-----------------------------------------------------------------------------
+// Allocator
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_allocator_default)
+{
+    protoc::polymorphic_allocator<int> allocator;
+    BOOST_REQUIRE(allocator.resource() == &protoc::new_delete_resource());
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_equal)
+{
+    protoc::monotonic_buffer_resource first;
+    protoc::monotonic_buffer_resource second;
+    protoc::polymorphic_allocator<int> alpha(&first);
+    protoc::polymorphic_allocator<char> bravo(&first);
+    protoc::polymorphic_allocator<int> charlie(&second);
+    BOOST_REQUIRE(alpha == bravo);
+    BOOST_REQUIRE(alpha != charlie);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_vector)
+{
+    counting_resource upstream;
+    {
+        protoc::monotonic_buffer_resource arena(4096, upstream);
+        std::vector<int, protoc::polymorphic_allocator<int> > numbers(&arena);
+        for (int i = 0; i < 100; ++i)
+        {
+            numbers.push_back(i);
+        }
+        BOOST_REQUIRE_EQUAL(numbers.size(), 100);
+        BOOST_REQUIRE_EQUAL(numbers.back(), 99);
+        BOOST_REQUIRE_EQUAL(upstream.allocated, 1);
+    }
+    BOOST_REQUIRE_EQUAL(upstream.deallocated, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_allocator_string_copy)
+{
+    protoc::monotonic_buffer_resource arena;
+    arena_string original("a string that is too long for the small buffer", &arena);
+    arena_string copy(original);
+    // Copies share the resource
+    BOOST_REQUIRE(copy.get_allocator().resource() == &arena);
+    BOOST_REQUIRE(copy == original);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
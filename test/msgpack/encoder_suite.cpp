@@ -18,6 +18,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <limits>
+#include <vector>
 #include <cmath> // std::abs
 #include <protoc/output.hpp>
 #include <protoc/output_array.hpp>
@@ -648,4 +649,168 @@ BOOST_AUTO_TEST_CASE(test_map_begin_0x10000)
     BOOST_REQUIRE_EQUAL(buffer[4], 0x00);
 }
 
+//-----------------------------------------------------------------------------
+// Bulk values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_values_int)
+{
+    const int values[] = { 0, 1, 127, 128, -1, -32, -33, -128, -129,
+                           255, 256, 32767, 32768, -32768, -32769,
+                           std::numeric_limits<int>::max(),
+                           std::numeric_limits<int>::min() };
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+    test_vector expected;
+    format::encoder single(expected);
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        size += single.put(protoc::int32_t(values[i]));
+    }
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, count), size);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_long_long)
+{
+    const long long values[] = { 0, -32, 128, -129, 32768, -32769,
+                                 2147483648LL, -2147483649LL,
+                                 std::numeric_limits<long long>::max(),
+                                 std::numeric_limits<long long>::min() };
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+    test_vector expected;
+    format::encoder single(expected);
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        size += single.put(protoc::int64_t(values[i]));
+    }
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, count), size);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_int64)
+{
+    // protoc::int64_t is long on LP64 platforms
+    const protoc::int64_t values[] = { 0, -32, 128, -129, 32768, -32769,
+                                       protoc::int64_t(2147483648LL),
+                                       protoc::int64_t(-2147483649LL),
+                                       std::numeric_limits<protoc::int64_t>::max(),
+                                       std::numeric_limits<protoc::int64_t>::min() };
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+    test_vector expected;
+    format::encoder single(expected);
+    std::size_t size = 0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        size += single.put(values[i]);
+    }
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, count), size);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_float)
+{
+    const float values[] = { 0.0f, 1.0f, -2.5f, 3.25e10f };
+    const std::size_t count = sizeof(values) / sizeof(values[0]);
+    test_vector expected;
+    format::encoder single(expected);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        single.put(protoc::float32_t(values[i]));
+    }
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, count), count * 5);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_double)
+{
+    // More values than are encoded per reservation
+    std::vector<double> values;
+    for (int i = 0; i < 1000; ++i)
+    {
+        values.push_back(i * 0.5 - 100.0);
+    }
+    test_vector expected;
+    format::encoder single(expected);
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        single.put(protoc::float64_t(values[i]));
+    }
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    BOOST_REQUIRE_EQUAL(encoder.put_values(&values[0], values.size()), values.size() * 9);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_empty)
+{
+    test_vector buffer;
+    format::encoder encoder(buffer);
+    const double *values = 0;
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, 0), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(fail_values_full)
+{
+    test_array<8> buffer;
+    format::encoder encoder(buffer);
+    const double values[] = { 1.0 };
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, 1), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_values_bounded)
+{
+    // The output is too small for the worst case, but not for the values
+    const int values[] = { 1, 2, 3 };
+    test_array<3> buffer;
+    format::encoder encoder(buffer);
+    std::size_t written = 0;
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, 3, &written), 3);
+    BOOST_REQUIRE_EQUAL(written, 3);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_values_bounded_partial)
+{
+    const int values[] = { 1, 2, 70000 };
+    test_vector expected;
+    format::encoder single(expected);
+    single.put(values[0]);
+    single.put(values[1]);
+    test_array<4> buffer;
+    format::encoder encoder(buffer);
+    std::size_t written = 0;
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, 3, &written), expected.size());
+    BOOST_REQUIRE_EQUAL(written, 2);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_values_bounded_double)
+{
+    const double values[] = { 1.0, 2.0 };
+    test_array<10> buffer;
+    format::encoder encoder(buffer);
+    std::size_t written = 0;
+    BOOST_REQUIRE_EQUAL(encoder.put_values(values, 2, &written), 9);
+    BOOST_REQUIRE_EQUAL(written, 1);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 9);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -16,10 +16,34 @@
 #include <protoc/msgpack/detail/codes.hpp>
 #include <protoc/msgpack/iarchive.hpp>
 #include <protoc/msgpack/string.hpp>
+#include <protoc/msgpack/vector.hpp>
+#include <protoc/msgpack/map.hpp>
+#include <protoc/memory_resource.hpp>
 
 namespace format = protoc::msgpack;
 namespace detail = protoc::msgpack::detail;
 
+typedef std::basic_string<char, std::char_traits<char>, protoc::polymorphic_allocator<char> > arena_string;
+
+// Counts the allocations forwarded to the global heap
+struct counting_resource : public protoc::memory_resource
+{
+    counting_resource() : count(0) {}
+
+    virtual void *do_allocate(std::size_t size, std::size_t alignment)
+    {
+        ++count;
+        return protoc::new_delete_resource().allocate(size, alignment);
+    }
+
+    virtual void do_deallocate(void *pointer, std::size_t size, std::size_t alignment)
+    {
+        protoc::new_delete_resource().deallocate(pointer, size, alignment);
+    }
+
+    int count;
+};
+
 BOOST_AUTO_TEST_SUITE(msgpack_iarchive_suite)
 
 //-----------------------------------------------------------------------------
@@ -128,4 +152,193 @@ BOOST_AUTO_TEST_CASE(test_string_alpha)
     BOOST_REQUIRE_EQUAL(value, "alpha");
 }
 
+//-----------------------------------------------------------------------------
+// Container
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_vector_int)
+{
+    format::iarchive::value_type input[] = { detail::code_fixarray_3, 0x01, detail::code_int16, 0xFF, 0x00, 0x03 };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<int> value;
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 3);
+    BOOST_REQUIRE_EQUAL(value[0], 1);
+    BOOST_REQUIRE_EQUAL(value[1], -256);
+    BOOST_REQUIRE_EQUAL(value[2], 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_double)
+{
+    format::iarchive::value_type input[] = { detail::code_fixarray_2,
+                                             detail::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                             detail::code_float32, 0x40, 0x00, 0x00, 0x00 };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<double> value;
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 2);
+    BOOST_REQUIRE_EQUAL(value[0], 1.0);
+    BOOST_REQUIRE_EQUAL(value[1], 2.0);
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_int_mixed)
+{
+    format::iarchive::value_type input[] = { detail::code_fixarray_2, 0x01, detail::code_null };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<int> value;
+    BOOST_REQUIRE_THROW(in >> value,
+                        protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_int_large)
+{
+    // More elements than are allocated up front
+    std::vector<unsigned char> input;
+    input.push_back(detail::code_array16);
+    input.push_back(0x13);
+    input.push_back(0x88);
+    for (int i = 0; i < 5000; ++i)
+    {
+        input.push_back(i % 100);
+    }
+    format::iarchive in(&input[0], &input[0] + input.size());
+    std::vector<int> value;
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 5000);
+    BOOST_REQUIRE_EQUAL(value[4999], 99);
+}
+
+BOOST_AUTO_TEST_CASE(fail_vector_int_count)
+{
+    // The count is larger than the input can hold
+    format::iarchive::value_type input[] = { detail::code_array32, 0xFF, 0xFF, 0xFF, 0xFF, 0x01, 0x02 };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<int> value;
+    BOOST_REQUIRE_THROW(in >> value,
+                        protoc::invalid_value);
+}
+
+//-----------------------------------------------------------------------------
+// Memory resource
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_resource_default)
+{
+    format::iarchive::value_type input[] = { detail::code_null };
+    format::iarchive in(input, input + sizeof(input));
+    BOOST_REQUIRE(&in.resource() == &protoc::new_delete_resource());
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_string)
+{
+    format::iarchive::value_type input[] = { detail::code_str8, 0x05, 'a', 'l', 'p', 'h', 'a' };
+    protoc::monotonic_buffer_resource arena;
+    format::iarchive in(input, input + sizeof(input), arena);
+    arena_string value(&arena);
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(std::string(value.begin(), value.end()), "alpha");
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_vector_string)
+{
+    format::iarchive::value_type input[] = {
+        detail::code_fixarray_2,
+        detail::code_str8, 0x05, 'a', 'l', 'p', 'h', 'a',
+        detail::code_str8, 0x20,
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p',
+        'q', 'r', 's', 't', 'u', 'v', 'w', 'x', 'y', 'z', '0', '1', '2', '3', '4', '5' };
+    counting_resource upstream;
+    {
+        protoc::monotonic_buffer_resource arena(1024, upstream);
+        format::iarchive in(input, input + sizeof(input), arena);
+        std::vector<arena_string, protoc::polymorphic_allocator<arena_string> > value(&arena);
+        BOOST_REQUIRE_NO_THROW(in >> value);
+        BOOST_REQUIRE_EQUAL(value.size(), 2);
+        BOOST_REQUIRE_EQUAL(std::string(value[0].begin(), value[0].end()), "alpha");
+        BOOST_REQUIRE_EQUAL(std::string(value[1].begin(), value[1].end()), "abcdefghijklmnopqrstuvwxyz012345");
+        BOOST_REQUIRE(value[1].get_allocator().resource() == &arena);
+        // Everything fits in the first block
+        BOOST_REQUIRE_EQUAL(upstream.count, 1);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_map_string)
+{
+    format::iarchive::value_type input[] = {
+        detail::code_fixmap_1,
+        detail::code_str8, 0x03, 'k', 'e', 'y',
+        detail::code_str8, 0x05, 'v', 'a', 'l', 'u', 'e' };
+    protoc::monotonic_buffer_resource arena;
+    format::iarchive in(input, input + sizeof(input), arena);
+    typedef std::map<arena_string,
+                     arena_string,
+                     std::less<arena_string>,
+                     protoc::polymorphic_allocator<std::pair<const arena_string, arena_string> > > map_type;
+    map_type value(std::less<arena_string>(), &arena);
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 1);
+    BOOST_REQUIRE(value.begin()->first == "key");
+    BOOST_REQUIRE(value.begin()->second == "value");
+    BOOST_REQUIRE(value.begin()->second.get_allocator().resource() == &arena);
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_vector_string_in_place)
+{
+    format::iarchive::value_type input[] = {
+        detail::code_fixarray_2,
+        detail::code_str8, 0x14,
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't',
+        detail::code_str8, 0x14,
+        'A', 'B', 'C', 'D', 'E', 'F', 'G', 'H', 'I', 'J', 'K', 'L', 'M', 'N', 'O', 'P', 'Q', 'R', 'S', 'T' };
+    counting_resource resource;
+    format::iarchive in(input, input + sizeof(input), resource);
+    std::vector<arena_string, protoc::polymorphic_allocator<arena_string> > value(&resource);
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 2);
+    BOOST_REQUIRE_EQUAL(std::string(value[1].begin(), value[1].end()), "ABCDEFGHIJKLMNOPQRST");
+    // One for the vector and one for each string, which is not copied
+    BOOST_REQUIRE_EQUAL(resource.count, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_map_string_in_place)
+{
+    format::iarchive::value_type input[] = {
+        detail::code_fixmap_1,
+        detail::code_str8, 0x03, 'k', 'e', 'y',
+        detail::code_str8, 0x14,
+        'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 'q', 'r', 's', 't' };
+    counting_resource resource;
+    format::iarchive in(input, input + sizeof(input), resource);
+    typedef std::map<arena_string,
+                     arena_string,
+                     std::less<arena_string>,
+                     protoc::polymorphic_allocator<std::pair<const arena_string, arena_string> > > map_type;
+    map_type value(std::less<arena_string>(), &resource);
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 1);
+    BOOST_REQUIRE(value.begin()->second == "abcdefghijklmnopqrst");
+    BOOST_REQUIRE(value.begin()->second.get_allocator().resource() == &resource);
+    // One for the node and one for the mapped string, which is not copied
+    BOOST_REQUIRE_EQUAL(resource.count, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_resource_map_duplicate_key)
+{
+    format::iarchive::value_type input[] = {
+        detail::code_fixmap_2,
+        detail::code_fixstr_1, 'k', detail::code_fixstr_1, 'a',
+        detail::code_fixstr_1, 'k', detail::code_fixstr_1, 'b' };
+    protoc::monotonic_buffer_resource arena;
+    format::iarchive in(input, input + sizeof(input), arena);
+    typedef std::map<arena_string,
+                     arena_string,
+                     std::less<arena_string>,
+                     protoc::polymorphic_allocator<std::pair<const arena_string, arena_string> > > map_type;
+    map_type value(std::less<arena_string>(), &arena);
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 1);
+    // The first value is kept
+    BOOST_REQUIRE(value.begin()->second == "a");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -32,6 +32,7 @@ BOOST_AUTO_TEST_CASE(test_empty)
     std::ostringstream result;
     format::stream_oarchive ar(result);
     char expected[] = { };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -44,6 +45,7 @@ BOOST_AUTO_TEST_CASE(test_false)
     bool value = false;
     out << value;
     char expected[] = { detail::code_false };
+    out.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -56,6 +58,7 @@ BOOST_AUTO_TEST_CASE(test_true)
     bool value = true;
     ar << value;
     char expected[] = { detail::code_true };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -72,6 +75,7 @@ BOOST_AUTO_TEST_CASE(test_int_zero)
     int value = 0;
     ar << value;
     char expected[] = { 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -88,6 +92,7 @@ BOOST_AUTO_TEST_CASE(test_float32_one)
     protoc::float32_t value = 1.0f;
     ar << value;
     char expected[] = { detail::code_float32, 0x3F, 0x80, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -100,6 +105,7 @@ BOOST_AUTO_TEST_CASE(test_const_float32_one)
     const protoc::float32_t value = 1.0f;
     ar << value;
     char expected[] = { detail::code_float32, 0x3F, 0x80, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -112,6 +118,7 @@ BOOST_AUTO_TEST_CASE(test_float64_one)
     protoc::float64_t value = 1.0;
     ar << value;
     char expected[] = { detail::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -124,6 +131,7 @@ BOOST_AUTO_TEST_CASE(test_const_float64_one)
     const protoc::float64_t value = 1.0;
     ar << value;
     char expected[] = { detail::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -140,6 +148,7 @@ BOOST_AUTO_TEST_CASE(test_binary_empty)
     std::vector<unsigned char> value;
     ar << value;
     char expected[] = { detail::code_bin8, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -152,6 +161,7 @@ BOOST_AUTO_TEST_CASE(test_binary_one)
     std::vector<unsigned char> value(1, 0xFF);
     ar << value;
     char expected[] = { detail::code_bin8, 0x01, 0xFF };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -169,6 +179,7 @@ BOOST_AUTO_TEST_CASE(test_vector_bool_empty)
     ar << value;
 
     char expected[] = { detail::code_fixarray_0 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -183,6 +194,37 @@ BOOST_AUTO_TEST_CASE(test_vector_bool_one)
     ar << value;
 
     char expected[] = { detail::code_fixarray_1, detail::code_true };
+    ar.flush();
+    std::string got = result.str();
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_int)
+{
+    std::ostringstream result;
+    format::stream_oarchive ar(result);
+    std::vector<int> value;
+    value.push_back(1);
+    value.push_back(200);
+    ar << value;
+
+    char expected[] = { detail::code_fixarray_2, 0x01, detail::code_int16, 0x00, 0xC8 };
+    ar.flush();
+    std::string got = result.str();
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_double)
+{
+    std::ostringstream result;
+    format::stream_oarchive ar(result);
+    std::vector<double> value(1, 1.0);
+    ar << value;
+
+    char expected[] = { detail::code_fixarray_1, detail::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -196,6 +238,7 @@ BOOST_AUTO_TEST_CASE(test_map_bool_empty)
     ar << value;
 
     char expected[] = { detail::code_fixmap_0 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -210,6 +253,7 @@ BOOST_AUTO_TEST_CASE(test_map_bool_one)
     ar << value;
 
     char expected[] = { detail::code_fixmap_1, detail::code_fixstr_1, 0x41, detail::code_true };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
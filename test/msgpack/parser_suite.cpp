@@ -0,0 +1,177 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <protoc/msgpack/parser.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
+
+namespace format = protoc::msgpack;
+namespace detail = format::detail;
+
+namespace
+{
+
+// Records the handler calls as a space separated trace
+struct recorder
+{
+    void on_null() { add("null"); }
+    void on_bool(bool value) { add(value ? "true" : "false"); }
+    void on_int(protoc::int64_t value) { std::ostringstream s; s << value; add(s.str()); }
+    void on_double(protoc::float64_t value) { std::ostringstream s; s << value << "f"; add(s.str()); }
+    void on_string(const protoc::string_view& value) { add("\"" + std::string(value.begin(), value.end()) + "\""); }
+    void on_binary(const protoc::binary_view& value) { std::ostringstream s; s << "bin" << value.size(); add(s.str()); }
+    void on_record_begin() { add("("); }
+    void on_record_end() { add(")"); }
+    void on_array_begin() { add("["); }
+    void on_array_end() { add("]"); }
+    void on_map_begin() { add("{"); }
+    void on_map_end() { add("}"); }
+
+    void add(const std::string& value)
+    {
+        if (!trace.empty())
+            trace += " ";
+        trace += value;
+    }
+
+    std::string trace;
+};
+
+template <std::size_t N>
+std::string parse(const unsigned char (&input)[N])
+{
+    recorder handler;
+    format::parse(input, input + N, handler);
+    return handler.trace;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(msgpack_parser_suite)
+
+//-----------------------------------------------------------------------------
+// Basic types
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    recorder handler;
+    std::string input;
+    BOOST_REQUIRE_THROW(format::parse(input, handler), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(test_null)
+{
+    const unsigned char input[] = { detail::code_null };
+    BOOST_REQUIRE_EQUAL(parse(input), "null");
+}
+
+BOOST_AUTO_TEST_CASE(test_boolean)
+{
+    const unsigned char input[] = { detail::code_fixarray_2, detail::code_true, detail::code_false };
+    BOOST_REQUIRE_EQUAL(parse(input), "[ true false ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_integer)
+{
+    const unsigned char input[] = { detail::code_fixarray_3, 0x01, 0xFF, detail::code_uint16, 0x01, 0x00 };
+    BOOST_REQUIRE_EQUAL(parse(input), "[ 1 -1 256 ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_uint64)
+{
+    const unsigned char input[] = { detail::code_uint64, 0x7F, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+    BOOST_REQUIRE_EQUAL(parse(input), "9223372036854775807");
+}
+
+BOOST_AUTO_TEST_CASE(test_floating)
+{
+    const unsigned char input[] = { detail::code_float64, 0x3F, 0xF8, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    BOOST_REQUIRE_EQUAL(parse(input), "1.5f");
+}
+
+BOOST_AUTO_TEST_CASE(test_string)
+{
+    const unsigned char input[] = { detail::code_fixstr_2, 0x41, 0x42 };
+    BOOST_REQUIRE_EQUAL(parse(input), "\"AB\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_binary)
+{
+    const unsigned char input[] = { detail::code_bin8, 0x03, 0x00, 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL(parse(input), "bin3");
+}
+
+//-----------------------------------------------------------------------------
+// Containers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_empty)
+{
+    const unsigned char input[] = { detail::code_fixarray_0 };
+    BOOST_REQUIRE_EQUAL(parse(input), "[ ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_map)
+{
+    const unsigned char input[] = { detail::code_fixmap_2,
+                                    detail::code_fixstr_1, 0x61, 0x01,
+                                    detail::code_fixstr_1, 0x62, detail::code_fixmap_0 };
+    BOOST_REQUIRE_EQUAL(parse(input), "{ \"a\" 1 \"b\" { } }");
+}
+
+BOOST_AUTO_TEST_CASE(test_nested)
+{
+    // Inner containers end together with their parent
+    const unsigned char input[] = { detail::code_fixarray_2,
+                                    detail::code_fixarray_1, detail::code_fixarray_1, detail::code_null,
+                                    detail::code_fixarray_0 };
+    BOOST_REQUIRE_EQUAL(parse(input), "[ [ [ null ] ] [ ] ]");
+}
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fail_uint64_overflow)
+{
+    const unsigned char input[] = { detail::code_uint64, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    BOOST_REQUIRE_THROW(parse(input), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(fail_array_too_few)
+{
+    const unsigned char input[] = { detail::code_fixarray_2, detail::code_null };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_trailing)
+{
+    const unsigned char input[] = { detail::code_fixarray_1, detail::code_null, detail::code_null };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_string_truncated)
+{
+    const unsigned char input[] = { detail::code_fixstr_2, 0x41 };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -90,6 +90,18 @@ BOOST_AUTO_TEST_CASE(test_string)
     BOOST_REQUIRE_EQUAL(reader.next(), false);
 }
 
+BOOST_AUTO_TEST_CASE(test_string_view)
+{
+    format::reader::value_type input[] = { detail::code_str8, 0x02, 0x41, 0x42 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_string);
+    format::reader::string_view_type view = reader.get_string_view();
+    BOOST_REQUIRE(view.begin() == reinterpret_cast<const char *>(input + 2));
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "AB");
+    BOOST_REQUIRE_EQUAL(reader.has_escapes(), false);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
 BOOST_AUTO_TEST_CASE(test_fixstring)
 {
     format::reader::value_type input[] = { detail::code_fixstr_1, 0x41 };
@@ -99,6 +111,17 @@ BOOST_AUTO_TEST_CASE(test_fixstring)
     BOOST_REQUIRE_EQUAL(reader.next(), false);
 }
 
+BOOST_AUTO_TEST_CASE(test_binary)
+{
+    format::reader::value_type input[] = { detail::code_bin8, 0x02, 0x01, 0x02 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_binary);
+    format::reader::range_type range = reader.get_range();
+    BOOST_REQUIRE(range.begin() == input + 2);
+    BOOST_REQUIRE_EQUAL(range.size(), 2);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
 //-----------------------------------------------------------------------------
 // Array
 //-----------------------------------------------------------------------------
@@ -243,4 +266,177 @@ BOOST_AUTO_TEST_CASE(test_map16_nested_one)
     BOOST_REQUIRE_EQUAL(reader.next(), false);
 }
 
+//-----------------------------------------------------------------------------
+// Sibling
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_nested_sibling)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_2, detail::code_fixarray_1, 0x01, 0x02 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_begin);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+    BOOST_REQUIRE_EQUAL(reader.size(), 2U);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 2);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1U);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_integer)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_2, 0x01, 0x02 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 2);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_map)
+{
+    // [ { "a": [ 1, { } ], "b": null }, 2 ]
+    format::reader::value_type input[] = { detail::code_fixarray_2,
+                                           detail::code_fixmap_2,
+                                           detail::code_fixstr_1, 'a',
+                                           detail::code_fixarray_2, 0x01, detail::code_fixmap_0,
+                                           detail::code_str8, 0x01, 'b',
+                                           detail::code_null,
+                                           0x02 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_map_begin);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 2);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1U);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_outermost)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_2, detail::code_fixarray_1, 0x01, 0x02 };
+    format::reader reader(input, input + sizeof(input));
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+    BOOST_REQUIRE_EQUAL(reader.size(), 0U);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_missing)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_2, detail::code_fixarray_2, 0x01 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+}
+
+BOOST_AUTO_TEST_CASE(fail_max_depth)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_1, detail::code_fixarray_1, detail::code_fixarray_1, detail::code_null };
+    format::reader reader(input, input + sizeof(input));
+    reader.max_depth(2);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1U);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.size(), 2U);
+    BOOST_REQUIRE_THROW(reader.next(), protoc::invalid_scope);
+}
+
+//-----------------------------------------------------------------------------
+// Bulk values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_read_values_int)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_3, 0x01, detail::code_int16, 0xFF, 0x00, detail::code_uint8, 0xFF };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    int values[4] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 4), 3U);
+    BOOST_REQUIRE_EQUAL(values[0], 1);
+    BOOST_REQUIRE_EQUAL(values[1], -256);
+    BOOST_REQUIRE_EQUAL(values[2], 255);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1U);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_partial)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_3, 0x01, 0x02, 0x03 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    long long values[2] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 2U);
+    BOOST_REQUIRE_EQUAL(values[0], 1);
+    BOOST_REQUIRE_EQUAL(values[1], 2);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 3);
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 3);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_mismatch)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_3, detail::code_float64, 0x3F, 0xF0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, detail::code_null, detail::code_float32, 0x40, 0x00, 0x00, 0x00 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    double values[3] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 3), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 1.0);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_null);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    float floats[3] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(floats, 3), 1U);
+    BOOST_REQUIRE_EQUAL(floats[0], 2.0f);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_nested)
+{
+    format::reader::value_type input[] = { detail::code_fixarray_2, detail::code_fixarray_1, 0x01, 0x02 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    int values[2] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 0U);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_begin);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 1);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.size(), 2U);
+    BOOST_REQUIRE_EQUAL(reader.next(), true);
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 2);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1U);
+    BOOST_REQUIRE_EQUAL(reader.next(), false);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_outside_array)
+{
+    format::reader::value_type input[] = { 0x01 };
+    format::reader reader(input, input + sizeof(input));
+    int values[1] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 1), 0U);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
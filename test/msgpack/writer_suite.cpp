@@ -12,9 +12,14 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <sstream>
+#include <string>
+#include <vector>
 #include <protoc/exceptions.hpp>
 #include <protoc/output_vector.hpp>
 #include <protoc/output_array.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/output_stream.hpp>
 #include <protoc/msgpack/writer.hpp>
 #include <protoc/msgpack/detail/codes.hpp>
 
@@ -166,6 +171,18 @@ BOOST_AUTO_TEST_CASE(test_string_alpha)
                                     expected, expected + sizeof(expected));
 }
 
+BOOST_AUTO_TEST_CASE(test_string_length)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    const char text[] = "ALPHABET";
+    BOOST_REQUIRE_EQUAL(writer.write(text, 5), 6);
+
+    format::writer::value_type expected[] = { detail::code_fixstr_5, 0x41, 0x4C, 0x50, 0x48, 0x41 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
 BOOST_AUTO_TEST_CASE(test_binary_empty)
 {
     test_vector buffer;
@@ -307,4 +324,433 @@ BOOST_AUTO_TEST_CASE(fail_map_count_odd)
     BOOST_REQUIRE_THROW(writer.map_end(), protoc::invalid_scope);
 }
 
+//-----------------------------------------------------------------------------
+// Nested containers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_nested)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(0), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_fixarray_2, detail::code_fixarray_1, 0x01, detail::code_fixarray_0 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_array_nested_map)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_fixarray_1, detail::code_fixmap_1, 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_map_nested)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_fixmap_1, 0x01, detail::code_fixarray_1, 0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_map_nested_map)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(0), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(0), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_fixmap_1, detail::code_fixmap_0, detail::code_fixmap_0 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(fail_array_nested_too_many)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(0), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_THROW(writer.array_begin(0), protoc::invalid_scope);
+}
+
+BOOST_AUTO_TEST_CASE(fail_map_nested_too_many)
+{
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(0), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_THROW(writer.write(2), protoc::invalid_scope);
+}
+
+//-----------------------------------------------------------------------------
+// Deferred count
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_deferred_array_empty)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 5);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_array32, 0x00, 0x00, 0x00, 0x00 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_array_three)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(3), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_array32, 0x00, 0x00, 0x00, 0x03, 0x01, 0x02, 0x03 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_map_one)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+
+    format::writer::value_type expected[] = { detail::code_map32, 0x00, 0x00, 0x00, 0x01, 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_nested)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_1,
+        detail::code_map32, 0x00, 0x00, 0x00, 0x01,
+        0x01,
+        detail::code_array32, 0x00, 0x00, 0x00, 0x01,
+        0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_compact_nested)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(3), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(4), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+
+    format::writer::value_type expected[] = {
+        detail::code_fixmap_1,
+        0x01,
+        detail::code_fixarray_2,
+        0x02,
+        detail::code_fixarray_2,
+        0x03,
+        0x04 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_compact_array16)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    for (int i = 0; i < 20; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(writer.write(i), 1);
+    }
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 23);
+    BOOST_REQUIRE_EQUAL(buffer[0], detail::code_array16);
+    BOOST_REQUIRE_EQUAL(buffer[1], 0x00);
+    BOOST_REQUIRE_EQUAL(buffer[2], 20);
+    BOOST_REQUIRE_EQUAL(buffer[3], 0x00);
+    BOOST_REQUIRE_EQUAL(buffer[22], 19);
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_sequence)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_1, 0x01,
+        0x02,
+        detail::code_fixarray_0 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_compact_array)
+{
+    test_array<16> buffer;
+    format::writer writer(buffer, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(3), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = {
+        0x01,
+        detail::code_fixarray_1,
+        detail::code_fixmap_1, 0x02, 0x03 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_compact_container)
+{
+    std::vector<format::writer::value_type> buffer;
+    protoc::output_container<format::writer::value_type, std::vector> output(buffer);
+    format::writer writer(output, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_2, 0x01,
+        detail::code_fixarray_0 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_stream)
+{
+    std::ostringstream result;
+    protoc::output_stream<format::writer::value_type> output(result);
+    format::writer writer(output, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.write(3), 1);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+    // Nothing is written until the outermost deferred container ends
+    BOOST_REQUIRE(result.str().empty());
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.write(4), 1);
+
+    const char expected[] = {
+        char(detail::code_array32), 0x00, 0x00, 0x00, 0x02,
+        0x01,
+        char(detail::code_fixmap_1), 0x02, 0x03,
+        0x04 };
+    BOOST_REQUIRE_EQUAL(result.str(), std::string(expected, sizeof(expected)));
+}
+
+BOOST_AUTO_TEST_CASE(test_deferred_compact_stream)
+{
+    std::ostringstream result;
+    protoc::output_stream<format::writer::value_type> output(result);
+    format::writer writer(output, format::writer::count_deferred_compact);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(writer.map_end(), 0);
+
+    const char expected[] = {
+        char(detail::code_fixmap_1), 0x01,
+        char(detail::code_fixarray_1), 0x02 };
+    BOOST_REQUIRE_EQUAL(result.str(), std::string(expected, sizeof(expected)));
+}
+
+BOOST_AUTO_TEST_CASE(fail_deferred_map_odd)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.map_begin(), 5);
+    BOOST_REQUIRE_EQUAL(writer.write(1), 1);
+    BOOST_REQUIRE_THROW(writer.map_end(), protoc::invalid_scope);
+}
+
+BOOST_AUTO_TEST_CASE(fail_deferred_mismatched_end)
+{
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(), 5);
+    BOOST_REQUIRE_THROW(writer.map_end(), protoc::invalid_scope);
+}
+
+//-----------------------------------------------------------------------------
+// Bulk arrays
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_int)
+{
+    const int values[] = { 1, -200, 70000 };
+    test_vector expected;
+    format::writer single(expected);
+    single.array_begin(3);
+    single.write(values[0]);
+    single.write(values[1]);
+    single.write(values[2]);
+    single.array_end();
+
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 3), expected.size());
+    BOOST_REQUIRE_EQUAL(writer.size(), 0);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_array_int64)
+{
+    const protoc::int64_t values[] = { 1, -200, 5000000000LL };
+    test_vector expected;
+    format::writer single(expected);
+    single.array_begin(3);
+    single.write(static_cast<long long>(values[0]));
+    single.write(static_cast<long long>(values[1]));
+    single.write(static_cast<long long>(values[2]));
+    single.array_end();
+
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 3), expected.size());
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_array_double_nested)
+{
+    const double values[] = { 1.0, 2.0 };
+    test_vector buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.array_begin(2), 1);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 2), 1 + 2 * 9);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 0), 1);
+    BOOST_REQUIRE_EQUAL(writer.array_end(), 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 1 + 1 + 2 * 9 + 1);
+    BOOST_REQUIRE_EQUAL(buffer[1], detail::code_fixarray_2);
+    BOOST_REQUIRE_EQUAL(buffer[2], detail::code_float64);
+    BOOST_REQUIRE_EQUAL(buffer[20], detail::code_fixarray_0);
+}
+
+BOOST_AUTO_TEST_CASE(test_array_deferred)
+{
+    const long long values[] = { 1, 2 };
+    test_vector buffer;
+    format::writer writer(buffer, format::writer::count_deferred_compact);
+    writer.array_begin();
+    writer.write_array(values, 2);
+    writer.array_end();
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_1,
+        detail::code_fixarray_2, 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_array_bounded)
+{
+    const int values[] = { 1, 2, 3 };
+    test_array<8> buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 3), 4);
+    BOOST_REQUIRE_EQUAL(writer.size(), 0);
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_3, 0x01, 0x02, 0x03 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_array_bounded_full)
+{
+    const int values[] = { 1, 2, 70000 };
+    test_array<4> buffer;
+    format::writer writer(buffer);
+    BOOST_REQUIRE_EQUAL(writer.write_array(values, 3), 0);
+    // The array is left open with the value not written
+    BOOST_REQUIRE_EQUAL(writer.size(), 1);
+    format::writer::value_type expected[] = {
+        detail::code_fixarray_3, 0x01, 0x02 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    expected, expected + sizeof(expected));
+    BOOST_REQUIRE_THROW(writer.array_end(), protoc::invalid_scope);
+}
+
+BOOST_AUTO_TEST_CASE(fail_array_too_many)
+{
+    const float values[] = { 1.0f };
+    test_vector buffer;
+    format::writer writer(buffer);
+    writer.array_begin(1);
+    writer.write(true);
+    BOOST_REQUIRE_THROW(writer.write_array(values, 1), protoc::invalid_scope);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,108 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <protoc/nesting_stack.hpp>
+#include <protoc/exceptions.hpp>
+
+BOOST_AUTO_TEST_SUITE(nesting_stack_suite)
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    protoc::nesting_stack<int> stack;
+    BOOST_REQUIRE(stack.empty());
+    BOOST_REQUIRE_EQUAL(stack.size(), 0U);
+    BOOST_REQUIRE_EQUAL(stack.max_depth(), 1024U);
+}
+
+BOOST_AUTO_TEST_CASE(test_push_pop)
+{
+    protoc::nesting_stack<int, 2> stack;
+    stack.push(1);
+    stack.push(2);
+    BOOST_REQUIRE_EQUAL(stack.size(), 2U);
+    BOOST_REQUIRE_EQUAL(stack.top(), 2);
+    stack.top() = 3;
+    BOOST_REQUIRE_EQUAL(stack.top(), 3);
+    stack.pop();
+    BOOST_REQUIRE_EQUAL(stack.top(), 1);
+    stack.pop();
+    BOOST_REQUIRE(stack.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_overflow)
+{
+    // Frames beyond the inline capacity
+    protoc::nesting_stack<std::string, 2> stack;
+    for (int i = 0; i < 10; ++i)
+    {
+        stack.push(std::string(i + 1, 'a'));
+    }
+    BOOST_REQUIRE_EQUAL(stack.size(), 10U);
+    for (int i = 10; i > 0; --i)
+    {
+        BOOST_REQUIRE_EQUAL(stack.top(), std::string(i, 'a'));
+        stack.pop();
+    }
+    BOOST_REQUIRE(stack.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_copy)
+{
+    protoc::nesting_stack<std::string, 2> stack;
+    stack.push("alpha");
+    stack.push("bravo");
+    stack.push("charlie");
+    protoc::nesting_stack<std::string, 2> copy(stack);
+    stack.pop();
+    BOOST_REQUIRE_EQUAL(copy.size(), 3U);
+    BOOST_REQUIRE_EQUAL(copy.top(), "charlie");
+    copy.pop();
+    BOOST_REQUIRE_EQUAL(copy.top(), "bravo");
+    copy.pop();
+    BOOST_REQUIRE_EQUAL(copy.top(), "alpha");
+}
+
+BOOST_AUTO_TEST_CASE(test_clear)
+{
+    protoc::nesting_stack<std::string, 2> stack;
+    stack.push("alpha");
+    stack.push("bravo");
+    stack.push("charlie");
+    stack.clear();
+    BOOST_REQUIRE(stack.empty());
+    stack.push("delta");
+    BOOST_REQUIRE_EQUAL(stack.top(), "delta");
+}
+
+BOOST_AUTO_TEST_CASE(fail_max_depth)
+{
+    protoc::nesting_stack<int, 2> stack(3);
+    stack.push(1);
+    stack.push(2);
+    stack.push(3);
+    BOOST_REQUIRE_THROW(stack.push(4), protoc::invalid_scope);
+    BOOST_REQUIRE_EQUAL(stack.size(), 3U);
+    BOOST_REQUIRE_EQUAL(stack.top(), 3);
+    stack.max_depth(4);
+    stack.push(4);
+    BOOST_REQUIRE_EQUAL(stack.top(), 4);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,633 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <protoc/output.hpp>
+#include <protoc/output_array.hpp>
+#include <protoc/output_vector.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/output_stream.hpp>
+#include <protoc/output_buffered_stream.hpp>
+#include <protoc/output_counter.hpp>
+#include <protoc/output_segments.hpp>
+#include <protoc/json/writer.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/transenc/writer.hpp>
+
+template<std::size_t N>
+struct test_array : public protoc::output_array<char, N>
+{
+};
+
+struct test_vector : public protoc::output_vector<char>
+{
+};
+
+struct test_vector_binary : public protoc::output_vector<unsigned char>
+{
+};
+
+struct test_stream : public protoc::output_stream<char>
+{
+    test_stream(std::ostream& stream)
+        : protoc::output_stream<char>(stream)
+    {
+    }
+};
+
+// Output that only implements the virtual interface
+struct test_legacy : public protoc::output<char>
+{
+    test_legacy(std::size_t limit) : limit(limit), writes(0) {}
+
+    virtual bool grow(size_type delta)
+    {
+        return (limit - content.size() >= delta);
+    }
+
+    virtual void write(value_type value)
+    {
+        content += value;
+        ++writes;
+    }
+
+    virtual void write(const value_type *values, size_type size)
+    {
+        content.append(values, size);
+        ++writes;
+    }
+
+    std::size_t limit;
+    std::string content;
+    int writes;
+};
+
+// Output without a window that takes payloads by reference from 4 values
+struct test_legacy_reference : public test_legacy
+{
+    test_legacy_reference() : test_legacy(64)
+    {
+        set_reference_threshold(4);
+    }
+};
+
+namespace
+{
+
+typedef protoc::output_segments<unsigned char> segment_output;
+
+std::vector<unsigned char> concatenate(const std::vector<segment_output::segment>& segments)
+{
+    std::vector<unsigned char> result;
+    for (std::size_t i = 0; i < segments.size(); ++i)
+    {
+        result.insert(result.end(), segments[i].data, segments[i].data + segments[i].size);
+    }
+    return result;
+}
+
+// Small and large binary payloads around a string
+template <typename Writer>
+void write_blobs(Writer& writer, const std::vector<unsigned char>& blob)
+{
+    writer.array_begin(4);
+    writer.write(&blob[0], 3);
+    writer.write(&blob[0], blob.size());
+    writer.write("alpha");
+    writer.write(&blob[0], blob.size());
+    writer.array_end();
+}
+
+template <typename Writer>
+void write_document(Writer& writer)
+{
+    writer.array_begin(3);
+    writer.write(1234567LL);
+    writer.write(std::string(300, 'x'));
+    writer.map_begin(1);
+    writer.write("key");
+    writer.write(3.25);
+    writer.map_end();
+    writer.array_end();
+}
+
+void write_json_document(protoc::json::writer& writer)
+{
+    writer.write_array_begin(3);
+    writer.write(protoc::int64_t(1234567));
+    writer.write(std::string(300, 'x'));
+    writer.write_map_begin(1);
+    writer.write("key");
+    writer.write(3.25);
+    writer.write_map_end();
+    writer.write_array_end();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(output_suite)
+
+//-----------------------------------------------------------------------------
+// Array
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array_reserve)
+{
+    test_array<4> buffer;
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(3);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    output.commit(position);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 2);
+    BOOST_REQUIRE_EQUAL(buffer[0], 'a');
+    BOOST_REQUIRE_EQUAL(buffer[1], 'b');
+}
+
+BOOST_AUTO_TEST_CASE(test_array_reserve_full)
+{
+    test_array<2> buffer;
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(output.reserve(3) == 0);
+    char *position = output.reserve(2);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    output.commit(position);
+    BOOST_REQUIRE(output.reserve(1) == 0);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_array_mixed)
+{
+    test_array<3> buffer;
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(output.grow(1));
+    output.write('a');
+    char *position = output.reserve(1);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'b';
+    output.commit(position);
+    output.write("c", 1);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 3);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "abc");
+}
+
+BOOST_AUTO_TEST_CASE(test_array_rewrite)
+{
+    test_array<4> buffer;
+    protoc::output<char>& output = buffer;
+    output.write("abc", 3);
+    BOOST_REQUIRE(output.rewritable());
+    BOOST_REQUIRE_EQUAL(output.position(), 3);
+    *output.rewrite(1) = 'B';
+    output.truncate(2);
+    output.write('d');
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "aBd");
+}
+
+//-----------------------------------------------------------------------------
+// Vector
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_vector_reserve)
+{
+    test_vector buffer;
+    protoc::output<char>& output = buffer;
+    for (int i = 0; i < 1000; ++i)
+    {
+        char *position = output.reserve(2);
+        BOOST_REQUIRE(position != 0);
+        *position++ = 'a';
+        output.commit(position);
+    }
+    BOOST_REQUIRE_EQUAL(buffer.size(), 1000);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), std::string(1000, 'a'));
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_mixed)
+{
+    test_vector buffer;
+    protoc::output<char>& output = buffer;
+    output.write('a');
+    char *position = output.reserve(1);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'b';
+    output.commit(position);
+    output.write("cd", 2);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 4);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "abcd");
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_reserve_capacity)
+{
+    test_vector buffer;
+    protoc::output<char>& output = buffer;
+    output.write('a');
+    buffer.reserve_capacity(100);
+    const std::size_t capacity = buffer.capacity();
+    BOOST_REQUIRE_EQUAL(buffer.size(), 1);
+    for (int i = 1; i < 100; ++i)
+    {
+        output.write('b');
+    }
+    BOOST_REQUIRE_EQUAL(buffer.size(), 100);
+    BOOST_REQUIRE_EQUAL(buffer.capacity(), capacity);
+    BOOST_REQUIRE_EQUAL(buffer[0], 'a');
+    BOOST_REQUIRE_EQUAL(buffer[99], 'b');
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_rewrite)
+{
+    test_vector buffer;
+    protoc::output<char>& output = buffer;
+    output.write("abc", 3);
+    BOOST_REQUIRE(output.rewritable());
+    BOOST_REQUIRE_EQUAL(output.position(), 3);
+    *output.rewrite(1) = 'B';
+    output.truncate(2);
+    output.write('d');
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "aBd");
+}
+
+//-----------------------------------------------------------------------------
+// Container
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_container_rewrite)
+{
+    std::vector<char> content;
+    protoc::output_container<char, std::vector> buffer(content);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(3);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    *position++ = 'c';
+    output.commit(position);
+    BOOST_REQUIRE(output.rewritable());
+    BOOST_REQUIRE_EQUAL(output.position(), 3);
+    *output.rewrite(1) = 'B';
+    output.truncate(2);
+    output.write('d');
+    BOOST_REQUIRE_EQUAL(std::string(content.begin(), content.end()), "aBd");
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_not_rewritable)
+{
+    std::ostringstream result;
+    protoc::output_stream<char> buffer(result);
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(!output.rewritable());
+    BOOST_REQUIRE(output.rewrite(0) == 0);
+}
+
+//-----------------------------------------------------------------------------
+// Counter
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_counter_mixed)
+{
+    protoc::output_counter<char> counter;
+    protoc::output<char>& output = counter;
+    BOOST_REQUIRE_EQUAL(counter.size(), 0);
+    output.write('a');
+    char *position = output.reserve(1000);
+    BOOST_REQUIRE(position != 0);
+    position = std::fill_n(position, 1000, 'b');
+    output.commit(position);
+    output.write("cd", 2);
+    position = output.reserve(3);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'e';
+    output.commit(position);
+    BOOST_REQUIRE_EQUAL(counter.size(), 1004);
+    counter.clear();
+    BOOST_REQUIRE_EQUAL(counter.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_counter_json)
+{
+    protoc::output_counter<char> counter;
+    protoc::json::writer sizer(counter);
+    write_json_document(sizer);
+
+    test_vector buffer;
+    protoc::json::writer writer(buffer);
+    write_json_document(writer);
+    BOOST_REQUIRE_EQUAL(counter.size(), buffer.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_counter_msgpack)
+{
+    protoc::output_counter<unsigned char> counter;
+    protoc::msgpack::writer sizer(counter);
+    write_document(sizer);
+
+    std::vector<unsigned char> buffer;
+    buffer.reserve(counter.size());
+    const std::size_t capacity = buffer.capacity();
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    protoc::msgpack::writer writer(output);
+    write_document(writer);
+    BOOST_REQUIRE_EQUAL(counter.size(), buffer.size());
+    BOOST_REQUIRE_EQUAL(buffer.capacity(), capacity);
+}
+
+BOOST_AUTO_TEST_CASE(test_counter_transenc)
+{
+    protoc::output_counter<unsigned char> counter;
+    protoc::transenc::writer sizer(counter);
+    write_document(sizer);
+
+    protoc::output_vector<unsigned char> buffer;
+    buffer.reserve_capacity(counter.size());
+    const std::size_t capacity = buffer.capacity();
+    protoc::transenc::writer writer(buffer);
+    write_document(writer);
+    BOOST_REQUIRE_EQUAL(counter.size(), buffer.size());
+    BOOST_REQUIRE_EQUAL(buffer.capacity(), capacity);
+}
+
+//-----------------------------------------------------------------------------
+// Segments
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_segments_inline)
+{
+    segment_output buffer(16);
+    protoc::output<unsigned char>& output = buffer;
+    output.write('a');
+    unsigned char *position = output.reserve(2);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'b';
+    output.commit(position);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 2);
+    BOOST_REQUIRE_EQUAL(buffer.segments().size(), 1);
+    BOOST_REQUIRE_EQUAL(buffer.segments()[0].size, 2);
+    BOOST_REQUIRE_EQUAL(buffer.segments()[0].data[1], 'b');
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_empty)
+{
+    segment_output buffer;
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+    BOOST_REQUIRE(buffer.segments().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_msgpack)
+{
+    const std::vector<unsigned char> blob(300, 0x2A);
+    test_vector_binary expected;
+    protoc::msgpack::writer reference_writer(expected);
+    write_blobs(reference_writer, blob);
+
+    segment_output buffer(256);
+    protoc::msgpack::writer writer(buffer);
+    write_blobs(writer, blob);
+    BOOST_REQUIRE_EQUAL(buffer.size(), expected.size());
+
+    // Headers and small values are inline, large payloads are referenced
+    const std::vector<segment_output::segment>& segments = buffer.segments();
+    BOOST_REQUIRE_EQUAL(segments.size(), 4);
+    BOOST_REQUIRE(segments[1].data == &blob[0]);
+    BOOST_REQUIRE_EQUAL(segments[1].size, blob.size());
+    BOOST_REQUIRE(segments[3].data == &blob[0]);
+    std::vector<unsigned char> result = concatenate(segments);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_transenc)
+{
+    const std::vector<unsigned char> blob(300, 0x2A);
+    test_vector_binary expected;
+    protoc::transenc::writer reference_writer(expected);
+    write_blobs(reference_writer, blob);
+
+    segment_output buffer(256);
+    protoc::transenc::writer writer(buffer);
+    write_blobs(writer, blob);
+    BOOST_REQUIRE_EQUAL(buffer.size(), expected.size());
+
+    const std::vector<segment_output::segment>& segments = buffer.segments();
+    BOOST_REQUIRE_EQUAL(segments.size(), 5);
+    BOOST_REQUIRE(segments[1].data == &blob[0]);
+    BOOST_REQUIRE(segments[3].data == &blob[0]);
+    std::vector<unsigned char> result = concatenate(segments);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                    expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_threshold)
+{
+    const std::vector<unsigned char> blob(300, 0x2A);
+    segment_output buffer(301);
+    protoc::msgpack::writer writer(buffer);
+    write_blobs(writer, blob);
+    // Below the threshold everything is copied
+    BOOST_REQUIRE_EQUAL(buffer.segments().size(), 1);
+    BOOST_REQUIRE(buffer.segments()[0].data != &blob[0]);
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_clear)
+{
+    const std::vector<unsigned char> blob(300, 0x2A);
+    segment_output buffer(256);
+    protoc::msgpack::writer writer(buffer);
+    writer.write(&blob[0], blob.size());
+    BOOST_REQUIRE_EQUAL(buffer.segments().size(), 2);
+    buffer.clear();
+    BOOST_REQUIRE_EQUAL(buffer.size(), 0);
+    BOOST_REQUIRE(buffer.segments().empty());
+    writer.write(true);
+    BOOST_REQUIRE_EQUAL(buffer.size(), 1);
+    BOOST_REQUIRE_EQUAL(buffer.segments().size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_segments_counter)
+{
+    const std::vector<unsigned char> blob(300, 0x2A);
+    protoc::output_counter<unsigned char> counter;
+    protoc::msgpack::writer sizer(counter);
+    write_blobs(sizer, blob);
+
+    segment_output buffer(256);
+    protoc::msgpack::writer writer(buffer);
+    write_blobs(writer, blob);
+    BOOST_REQUIRE_EQUAL(counter.size(), buffer.size());
+}
+
+//-----------------------------------------------------------------------------
+// Container
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_container_commit)
+{
+    std::vector<char> content;
+    protoc::output_container<char, std::vector> buffer(content);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(4);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    output.commit(position);
+    // Container only holds committed data
+    BOOST_REQUIRE_EQUAL(content.size(), 2);
+    output.write('c');
+    BOOST_REQUIRE_EQUAL(std::string(content.begin(), content.end()), "abc");
+}
+
+//-----------------------------------------------------------------------------
+// Stream
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_stream_commit)
+{
+    std::ostringstream result;
+    test_stream buffer(result);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(3);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    *position++ = 'c';
+    output.commit(position);
+    BOOST_REQUIRE_EQUAL(result.str(), "abc");
+}
+
+//-----------------------------------------------------------------------------
+// Buffered stream
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_buffered_stream_flush)
+{
+    std::ostringstream result;
+    protoc::output_buffered_stream<char> buffer(result);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(2);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    output.commit(position);
+    output.write('c');
+    BOOST_REQUIRE_EQUAL(buffer.pending(), 3);
+    BOOST_REQUIRE_EQUAL(result.str(), "");
+    BOOST_REQUIRE(buffer.flush());
+    BOOST_REQUIRE_EQUAL(buffer.pending(), 0);
+    BOOST_REQUIRE_EQUAL(result.str(), "abc");
+}
+
+BOOST_AUTO_TEST_CASE(test_buffered_stream_destructor)
+{
+    std::ostringstream result;
+    {
+        protoc::output_buffered_stream<char> buffer(result);
+        protoc::output<char>& output = buffer;
+        output.write("abc", 3);
+    }
+    BOOST_REQUIRE_EQUAL(result.str(), "abc");
+}
+
+BOOST_AUTO_TEST_CASE(test_buffered_stream_block)
+{
+    std::ostringstream result;
+    protoc::output_buffered_stream<char> buffer(result, 4);
+    protoc::output<char>& output = buffer;
+    output.write("abc", 3);
+    BOOST_REQUIRE_EQUAL(result.str(), "");
+    // Block is full so previous data is written
+    char *position = output.reserve(2);
+    BOOST_REQUIRE(position != 0);
+    BOOST_REQUIRE_EQUAL(result.str(), "abc");
+    *position++ = 'd';
+    *position++ = 'e';
+    output.commit(position);
+    // Larger than the block
+    position = output.reserve(6);
+    BOOST_REQUIRE(position != 0);
+    position = std::fill_n(position, 6, 'f');
+    output.commit(position);
+    output.write("ghijk", 5);
+    BOOST_REQUIRE(buffer.flush());
+    BOOST_REQUIRE_EQUAL(result.str(), "abcdeffffffghijk");
+}
+
+BOOST_AUTO_TEST_CASE(test_buffered_stream_fail)
+{
+    std::ostringstream result;
+    result.setstate(std::ios_base::badbit);
+    protoc::output_buffered_stream<char> buffer(result, 2);
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(!output.grow(1));
+    BOOST_REQUIRE(output.reserve(4) == 0);
+}
+
+//-----------------------------------------------------------------------------
+// Fallback for outputs without a window
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_legacy_commit)
+{
+    test_legacy buffer(8);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(4);
+    BOOST_REQUIRE(position != 0);
+    *position++ = 'a';
+    *position++ = 'b';
+    output.commit(position);
+    BOOST_REQUIRE_EQUAL(buffer.content, "ab");
+    BOOST_REQUIRE_EQUAL(buffer.writes, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_legacy_full)
+{
+    test_legacy buffer(2);
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(output.reserve(3) == 0);
+    BOOST_REQUIRE(buffer.content.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_legacy_empty_commit)
+{
+    test_legacy buffer(8);
+    protoc::output<char>& output = buffer;
+    char *position = output.reserve(4);
+    BOOST_REQUIRE(position != 0);
+    output.commit(position);
+    BOOST_REQUIRE(buffer.content.empty());
+    BOOST_REQUIRE_EQUAL(buffer.writes, 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_legacy_reference_copies)
+{
+    test_legacy_reference buffer;
+    protoc::output<char>& output = buffer;
+    BOOST_REQUIRE(!output.by_reference(3));
+    BOOST_REQUIRE(output.by_reference(4));
+    output.write('a');
+    output.reference("bcde", 4);
+    BOOST_REQUIRE_EQUAL(buffer.content, "abcde");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
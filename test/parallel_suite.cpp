@@ -0,0 +1,292 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <vector>
+#include <protoc/parallel.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/json/split.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/msgpack/split.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
+#include <protoc/transenc/writer.hpp>
+#include <protoc/transenc/split.hpp>
+#include <protoc/transenc/detail/codes.hpp>
+
+namespace
+{
+
+typedef std::vector<unsigned char> binary_buffer;
+
+std::string text(const protoc::string_view& view)
+{
+    return std::string(view.begin(), view.end());
+}
+
+// Returns the integer of a JSON document that holds a single integer
+struct decode_json_integer
+{
+    long long operator () (const protoc::string_view& record) const
+    {
+        protoc::json::reader reader(record.begin(), record.end());
+        return reader.get_long_long();
+    }
+};
+
+// Returns the sum of the integers of a msgpack array
+struct decode_msgpack_sum
+{
+    long long operator () (const protoc::binary_view& record) const
+    {
+        protoc::msgpack::reader reader(record.begin(), record.end());
+        long long result = 0;
+        reader.next(protoc::token::token_array_begin);
+        while (reader.type() == protoc::token::token_integer)
+        {
+            result += reader.get_long_long();
+            reader.next();
+        }
+        return result;
+    }
+};
+
+// Counts the calls of the function object owned by each worker
+struct decode_counter
+{
+    decode_counter() : calls(0) {}
+
+    int operator () (const protoc::string_view&)
+    {
+        return ++calls;
+    }
+
+    int calls;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(parallel_suite)
+
+//-----------------------------------------------------------------------------
+// JSON split
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_json_split)
+{
+    const std::string input("1\n[2]\n{\"A\":3}\n");
+    std::vector<protoc::string_view> records;
+    protoc::json::split(input.data(), input.data() + input.size(), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_REQUIRE_EQUAL(text(records[0]), "1");
+    BOOST_REQUIRE_EQUAL(text(records[1]), "[2]");
+    BOOST_REQUIRE_EQUAL(text(records[2]), "{\"A\":3}");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_split_blank)
+{
+    const std::string input("\n1\r\n \t\r\n\n2");
+    std::vector<protoc::string_view> records;
+    protoc::json::split(input.data(), input.data() + input.size(), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 2);
+    BOOST_REQUIRE_EQUAL(text(records[0]), "1\r");
+    BOOST_REQUIRE_EQUAL(text(records[1]), "2");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_split_empty)
+{
+    const std::string input;
+    std::vector<protoc::string_view> records;
+    protoc::json::split(input.data(), input.data() + input.size(), records);
+    BOOST_REQUIRE(records.empty());
+}
+
+//-----------------------------------------------------------------------------
+// msgpack split
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_msgpack_split)
+{
+    using namespace protoc::msgpack::detail;
+    const unsigned char input[] = { 0x01,
+                                    code_fixarray_2, code_fixmap_1, code_fixstr_1, 0x41, code_null, 0x02,
+                                    code_bin8, 0x01, code_fixarray_1 };
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(input, input + sizeof(input), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_REQUIRE(records[0].begin() == input);
+    BOOST_REQUIRE_EQUAL(records[0].size(), 1);
+    BOOST_REQUIRE(records[1].begin() == input + 1);
+    BOOST_REQUIRE_EQUAL(records[1].size(), 6);
+    BOOST_REQUIRE(records[2].begin() == input + 7);
+    BOOST_REQUIRE_EQUAL(records[2].size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(fail_msgpack_split_truncated)
+{
+    using namespace protoc::msgpack::detail;
+    const unsigned char input[] = { 0x01, code_fixarray_2, 0x02 };
+    std::vector<protoc::binary_view> records;
+    BOOST_REQUIRE_THROW(protoc::msgpack::split(input, input + sizeof(input), records),
+                        protoc::unexpected_token);
+}
+
+//-----------------------------------------------------------------------------
+// transenc split
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_transenc_split)
+{
+    binary_buffer input;
+    {
+        protoc::output_container<unsigned char, std::vector> output(input);
+        protoc::transenc::writer writer(output);
+        writer.write(true);
+        writer.array_begin();
+        writer.map_begin(1);
+        writer.write("alpha");
+        writer.write(1);
+        writer.map_end();
+        writer.array_end();
+        writer.write("bravo");
+    }
+    std::vector<protoc::binary_view> records;
+    protoc::transenc::split(input.data(), input.data() + input.size(), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 3);
+    BOOST_REQUIRE(records[0].begin() == input.data());
+    BOOST_REQUIRE_EQUAL(records[0].size(), 1);
+    BOOST_REQUIRE(records[1].begin() == records[0].end());
+    BOOST_REQUIRE(records[2].begin() == records[1].end());
+    BOOST_REQUIRE(records[2].end() == input.data() + input.size());
+}
+
+BOOST_AUTO_TEST_CASE(fail_transenc_split_truncated)
+{
+    using namespace protoc::transenc::detail;
+    const unsigned char input[] = { code_array_begin, code_null, code_true };
+    std::vector<protoc::binary_view> records;
+    BOOST_REQUIRE_THROW(protoc::transenc::split(input, input + sizeof(input), records),
+                        protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_transenc_split_unbalanced)
+{
+    using namespace protoc::transenc::detail;
+    const unsigned char input[] = { code_true, code_array_end };
+    std::vector<protoc::binary_view> records;
+    BOOST_REQUIRE_THROW(protoc::transenc::split(input, input + sizeof(input), records),
+                        protoc::unexpected_token);
+}
+
+//-----------------------------------------------------------------------------
+// Parallel decoding
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_decode_empty)
+{
+    std::vector<protoc::string_view> records;
+    std::vector<long long> results(1);
+    protoc::decode_parallel(records, results, decode_json_integer(), 4);
+    BOOST_REQUIRE(results.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_json_ordered)
+{
+    std::ostringstream input;
+    for (int i = 0; i < 10000; ++i)
+    {
+        // Records of different sizes
+        input << std::string(i % 7, ' ') << i << "\n";
+    }
+    const std::string buffer = input.str();
+    std::vector<protoc::string_view> records;
+    protoc::json::split(buffer.data(), buffer.data() + buffer.size(), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 10000);
+
+    std::vector<long long> results;
+    protoc::decode_parallel(records, results, decode_json_integer(), 4);
+    BOOST_REQUIRE_EQUAL(results.size(), 10000);
+    for (int i = 0; i < 10000; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(results[i], i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_msgpack_ordered)
+{
+    binary_buffer input;
+    {
+        protoc::output_container<unsigned char, std::vector> output(input);
+        protoc::msgpack::writer writer(output);
+        for (int i = 0; i < 1000; ++i)
+        {
+            writer.array_begin(i % 5);
+            for (int j = 0; j < i % 5; ++j)
+            {
+                writer.write(i);
+            }
+            writer.array_end();
+        }
+    }
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(input.data(), input.data() + input.size(), records);
+    BOOST_REQUIRE_EQUAL(records.size(), 1000);
+
+    std::vector<long long> results;
+    protoc::decode_parallel(records, results, decode_msgpack_sum(), 3);
+    for (int i = 0; i < 1000; ++i)
+    {
+        BOOST_REQUIRE_EQUAL(results[i], (i % 5) * i);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_function_per_worker)
+{
+    const std::string input("1\n2\n3\n4\n");
+    std::vector<protoc::string_view> records;
+    protoc::json::split(input.data(), input.data() + input.size(), records);
+    std::vector<int> results;
+    // A single worker uses one copy of the function for all records
+    protoc::decode_parallel(records, results, decode_counter(), 1);
+    BOOST_REQUIRE_EQUAL(results.size(), 4);
+    BOOST_REQUIRE_EQUAL(results[3], 4);
+}
+
+BOOST_AUTO_TEST_CASE(fail_decode_first_error)
+{
+    std::ostringstream input;
+    for (int i = 0; i < 1000; ++i)
+    {
+        if ((i == 300) || (i == 700))
+            input << "[\n";
+        else
+            input << i << "\n";
+    }
+    const std::string buffer = input.str();
+    std::vector<protoc::string_view> records;
+    protoc::json::split(buffer.data(), buffer.data() + buffer.size(), records);
+
+    std::vector<long long> results;
+    BOOST_REQUIRE_THROW(protoc::decode_parallel(records, results, decode_json_integer(), 4),
+                        protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,389 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <protoc/exceptions.hpp>
+#include <protoc/query.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/transenc/reader.hpp>
+#include <protoc/transenc/writer.hpp>
+
+namespace
+{
+
+typedef std::vector<unsigned char> binary_buffer;
+
+// Records the paths in the order they are found, and their integer values
+struct collector
+{
+    template <typename Reader>
+    void operator () (std::size_t which, Reader& input)
+    {
+        order.push_back(which);
+        values.push_back((input.type() == protoc::token::token_integer)
+                         ? input.get_long_long()
+                         : -1);
+    }
+
+    std::vector<std::size_t> order;
+    std::vector<long long> values;
+};
+
+bool query_json(const std::string& input, const char *where, long long& result)
+{
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    if (!protoc::query(reader, protoc::path(where)))
+        return false;
+    result = reader.get_long_long();
+    return true;
+}
+
+// {"user":{"name":"alpha","id":42},"tags":[1,[2,3]],1:7}
+template <typename Writer>
+void write_document(binary_buffer& buffer)
+{
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    Writer writer(output);
+    writer.map_begin(3);
+    writer.write("user");
+    writer.map_begin(2);
+    writer.write("name");
+    writer.write("alpha");
+    writer.write("id");
+    writer.write(42);
+    writer.map_end();
+    writer.write("tags");
+    writer.array_begin(2);
+    writer.write(1);
+    writer.array_begin(2);
+    writer.write(2);
+    writer.write(3);
+    writer.array_end();
+    writer.array_end();
+    writer.write(1);
+    writer.write(7);
+    writer.map_end();
+}
+
+template <typename Reader>
+bool query_binary(const binary_buffer& input, const char *where, long long& result)
+{
+    Reader reader(input.data(), input.data() + input.size());
+    if (!protoc::query(reader, protoc::path(where)))
+        return false;
+    result = reader.get_long_long();
+    return true;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(query_suite)
+
+//-----------------------------------------------------------------------------
+// Path
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_path_root)
+{
+    protoc::path where("");
+    BOOST_REQUIRE(where.empty());
+    BOOST_REQUIRE(protoc::path().empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_path_keys)
+{
+    protoc::path where("/user/id");
+    BOOST_REQUIRE_EQUAL(where.size(), 2);
+    BOOST_REQUIRE_EQUAL(where.key(0), "user");
+    BOOST_REQUIRE_EQUAL(where.key(1), "id");
+    BOOST_REQUIRE(where.index(0) == protoc::path::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_path_empty_keys)
+{
+    protoc::path where("//");
+    BOOST_REQUIRE_EQUAL(where.size(), 2);
+    BOOST_REQUIRE_EQUAL(where.key(0), "");
+    BOOST_REQUIRE_EQUAL(where.key(1), "");
+}
+
+BOOST_AUTO_TEST_CASE(test_path_escapes)
+{
+    protoc::path where("/a~1b/m~0n/~01");
+    BOOST_REQUIRE_EQUAL(where.size(), 3);
+    BOOST_REQUIRE_EQUAL(where.key(0), "a/b");
+    BOOST_REQUIRE_EQUAL(where.key(1), "m~n");
+    BOOST_REQUIRE_EQUAL(where.key(2), "~1");
+}
+
+BOOST_AUTO_TEST_CASE(test_path_indices)
+{
+    protoc::path where("/0/10/01/-/1a/99999999999999999999999");
+    BOOST_REQUIRE_EQUAL(where.size(), 6);
+    BOOST_REQUIRE_EQUAL(where.index(0), 0);
+    BOOST_REQUIRE_EQUAL(where.index(1), 10);
+    BOOST_REQUIRE(where.index(2) == protoc::path::npos);
+    BOOST_REQUIRE(where.index(3) == protoc::path::npos);
+    BOOST_REQUIRE(where.index(4) == protoc::path::npos);
+    BOOST_REQUIRE(where.index(5) == protoc::path::npos);
+    BOOST_REQUIRE_EQUAL(where.key(2), "01");
+}
+
+BOOST_AUTO_TEST_CASE(test_path_invalid)
+{
+    BOOST_REQUIRE_THROW(protoc::path("user"), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(protoc::path("/user~"), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(protoc::path("/user~2"), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(protoc::path("/us~/er"), protoc::invalid_value);
+}
+
+//-----------------------------------------------------------------------------
+// JSON
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_json_root)
+{
+    long long result = 0;
+    BOOST_REQUIRE(query_json("42", "", result));
+    BOOST_REQUIRE_EQUAL(result, 42);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_key)
+{
+    const std::string input("{\"name\":\"alpha\",\"list\":[1,{\"id\":2}],\"user\":{\"id\":42}}");
+    long long result = 0;
+    BOOST_REQUIRE(query_json(input, "/user/id", result));
+    BOOST_REQUIRE_EQUAL(result, 42);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_index)
+{
+    const std::string input("{\"list\":[1,{\"id\":2},[3,4]]}");
+    long long result = 0;
+    BOOST_REQUIRE(query_json(input, "/list/0", result));
+    BOOST_REQUIRE_EQUAL(result, 1);
+    BOOST_REQUIRE(query_json(input, "/list/1/id", result));
+    BOOST_REQUIRE_EQUAL(result, 2);
+    BOOST_REQUIRE(query_json(input, "/list/2/1", result));
+    BOOST_REQUIRE_EQUAL(result, 4);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_missing)
+{
+    const std::string input("{\"list\":[1,2],\"user\":{\"id\":42}}");
+    long long result = 0;
+    BOOST_REQUIRE(!query_json(input, "/user/name", result));
+    BOOST_REQUIRE(!query_json(input, "/list/2", result));
+    BOOST_REQUIRE(!query_json(input, "/list/-", result));
+    BOOST_REQUIRE(!query_json(input, "/list/0/id", result));
+    BOOST_REQUIRE(!query_json(input, "/user/id/0", result));
+    BOOST_REQUIRE(!query_json(input, "/0", result));
+}
+
+BOOST_AUTO_TEST_CASE(test_json_missing_position)
+{
+    const std::string input("{\"user\":{\"id\":42}} 7");
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    BOOST_REQUIRE(!protoc::query(reader, protoc::path("/user/name")));
+    // The reader is left after the document
+    BOOST_REQUIRE_EQUAL(reader.get_long_long(), 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_escaped_key)
+{
+    const std::string input("{\"a/b\":1,\"m\u007En\":2}");
+    long long result = 0;
+    BOOST_REQUIRE(query_json(input, "/a~1b", result));
+    BOOST_REQUIRE_EQUAL(result, 1);
+    BOOST_REQUIRE(query_json(input, "/m~0n", result));
+    BOOST_REQUIRE_EQUAL(result, 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_duplicate_key)
+{
+    const std::string input("{\"id\":1,\"id\":2}");
+    long long result = 0;
+    BOOST_REQUIRE(query_json(input, "/id", result));
+    BOOST_REQUIRE_EQUAL(result, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_container)
+{
+    const std::string input("{\"user\":{\"id\":42}}");
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    BOOST_REQUIRE(protoc::query(reader, protoc::path("/user")));
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_map_begin);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_truncated)
+{
+    const std::string input("{\"user\":{\"id\":42");
+    long long result = 0;
+    BOOST_REQUIRE_THROW(query_json(input, "/user/name", result), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_multiple)
+{
+    const std::string input("{\"a\":1,\"b\":{\"c\":2,\"d\":[3,4]},\"e\":5}");
+    std::vector<protoc::path> paths;
+    paths.push_back(protoc::path("/e"));
+    paths.push_back(protoc::path("/b/d/1"));
+    paths.push_back(protoc::path("/x"));
+    paths.push_back(protoc::path("/b"));
+    paths.push_back(protoc::path("/a"));
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    collector visitor;
+    BOOST_REQUIRE_EQUAL(protoc::query(reader, paths, visitor), 4);
+    // Paths are reported in document order, and containers before their children
+    BOOST_REQUIRE_EQUAL(visitor.order.size(), 4);
+    BOOST_REQUIRE_EQUAL(visitor.order[0], 4);
+    BOOST_REQUIRE_EQUAL(visitor.values[0], 1);
+    BOOST_REQUIRE_EQUAL(visitor.order[1], 3);
+    BOOST_REQUIRE_EQUAL(visitor.values[1], -1);
+    BOOST_REQUIRE_EQUAL(visitor.order[2], 1);
+    BOOST_REQUIRE_EQUAL(visitor.values[2], 4);
+    BOOST_REQUIRE_EQUAL(visitor.order[3], 0);
+    BOOST_REQUIRE_EQUAL(visitor.values[3], 5);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_multiple_early_stop)
+{
+    const std::string input("{\"a\":1,\"b\":2,\"c\":3}");
+    std::vector<protoc::path> paths;
+    paths.push_back(protoc::path("/b"));
+    paths.push_back(protoc::path("/a"));
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    collector visitor;
+    BOOST_REQUIRE_EQUAL(protoc::query(reader, paths, visitor), 2);
+    // The pass stops at the last value found
+    BOOST_REQUIRE_EQUAL(reader.get_long_long(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_multiple_empty)
+{
+    const std::string input("1");
+    std::vector<protoc::path> paths;
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    collector visitor;
+    BOOST_REQUIRE_EQUAL(protoc::query(reader, paths, visitor), 0);
+}
+
+//-----------------------------------------------------------------------------
+// msgpack
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_msgpack_query)
+{
+    binary_buffer input;
+    write_document<protoc::msgpack::writer>(input);
+    long long result = 0;
+    BOOST_REQUIRE(query_binary<protoc::msgpack::reader>(input, "/user/id", result));
+    BOOST_REQUIRE_EQUAL(result, 42);
+    BOOST_REQUIRE(query_binary<protoc::msgpack::reader>(input, "/tags/1/0", result));
+    BOOST_REQUIRE_EQUAL(result, 2);
+    BOOST_REQUIRE(!query_binary<protoc::msgpack::reader>(input, "/user/age", result));
+    BOOST_REQUIRE(!query_binary<protoc::msgpack::reader>(input, "/tags/2", result));
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_integer_key)
+{
+    binary_buffer input;
+    write_document<protoc::msgpack::writer>(input);
+    long long result = 0;
+    BOOST_REQUIRE(query_binary<protoc::msgpack::reader>(input, "/1", result));
+    BOOST_REQUIRE_EQUAL(result, 7);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_multiple)
+{
+    binary_buffer input;
+    write_document<protoc::msgpack::writer>(input);
+    std::vector<protoc::path> paths;
+    paths.push_back(protoc::path("/tags/1/1"));
+    paths.push_back(protoc::path("/user/id"));
+    protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+    collector visitor;
+    BOOST_REQUIRE_EQUAL(protoc::query(reader, paths, visitor), 2);
+    BOOST_REQUIRE_EQUAL(visitor.values[0], 42);
+    BOOST_REQUIRE_EQUAL(visitor.values[1], 3);
+}
+
+//-----------------------------------------------------------------------------
+// transenc
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_transenc_query)
+{
+    binary_buffer input;
+    write_document<protoc::transenc::writer>(input);
+    long long result = 0;
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/user/id", result));
+    BOOST_REQUIRE_EQUAL(result, 42);
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/tags/1/1", result));
+    BOOST_REQUIRE_EQUAL(result, 3);
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/1", result));
+    BOOST_REQUIRE_EQUAL(result, 7);
+    BOOST_REQUIRE(!query_binary<protoc::transenc::reader>(input, "/user/name/0", result));
+}
+
+BOOST_AUTO_TEST_CASE(test_transenc_map_count)
+{
+    // {"a":1,"b":2} with the count after the map begin
+    binary_buffer input;
+    {
+        protoc::output_container<unsigned char, std::vector> output(input);
+        protoc::transenc::writer writer(output);
+        writer.map_begin(2);
+        writer.write("a");
+        writer.write(1);
+        writer.write("b");
+        writer.write(2);
+        writer.map_end();
+    }
+    long long result = 0;
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/b", result));
+    BOOST_REQUIRE_EQUAL(result, 2);
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/a", result));
+    BOOST_REQUIRE_EQUAL(result, 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_transenc_record)
+{
+    binary_buffer input;
+    {
+        protoc::output_container<unsigned char, std::vector> output(input);
+        protoc::transenc::writer writer(output);
+        writer.record_begin();
+        writer.write("alpha");
+        writer.array_begin();
+        writer.write(1);
+        writer.write(2);
+        writer.array_end();
+        writer.record_end();
+    }
+    long long result = 0;
+    BOOST_REQUIRE(query_binary<protoc::transenc::reader>(input, "/1/1", result));
+    BOOST_REQUIRE_EQUAL(result, 2);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,371 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <protoc/exceptions.hpp>
+#include <protoc/record_index.hpp>
+#include <protoc/output_container.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/msgpack/split.hpp>
+#include <protoc/transenc/reader.hpp>
+#include <protoc/transenc/writer.hpp>
+#include <protoc/transenc/split.hpp>
+
+namespace
+{
+
+typedef std::vector<unsigned char> binary_buffer;
+
+// Writes count records of the form [key, number]
+template <typename Writer>
+void write_records(binary_buffer& buffer, const std::vector<std::string>& keys)
+{
+    protoc::output_container<unsigned char, std::vector> output(buffer);
+    Writer writer(output);
+    for (std::size_t i = 0; i < keys.size(); ++i)
+    {
+        writer.array_begin(2);
+        writer.write(keys[i]);
+        writer.write(int(i));
+        writer.array_end();
+    }
+}
+
+std::vector<std::string> make_keys(const char *first, const char *second, const char *third)
+{
+    std::vector<std::string> result;
+    result.push_back(first);
+    result.push_back(second);
+    result.push_back(third);
+    return result;
+}
+
+// Moves the reader from the start of a record to its first element
+template <typename Reader>
+void enter_record(Reader& reader)
+{
+    std::size_t count = 0;
+    protoc::transcoder_reader_traits<Reader>::container_begin(reader, count);
+}
+
+// Returns the key of a record of the form [key, number]
+template <typename Reader>
+struct record_key
+{
+    std::string operator () (const protoc::binary_view& record) const
+    {
+        Reader reader(record.begin(), record.end());
+        enter_record(reader);
+        return reader.get_string();
+    }
+};
+
+// Returns the number of a record of the form [key, number]
+template <typename Reader>
+int record_number(const protoc::binary_view& record)
+{
+    Reader reader(record.begin(), record.end());
+    enter_record(reader);
+    reader.next();
+    return reader.get_int();
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(record_index_suite)
+
+//-----------------------------------------------------------------------------
+// Building
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    protoc::record_index index;
+    BOOST_REQUIRE(index.empty());
+    BOOST_REQUIRE_EQUAL(index.size(), 0);
+    BOOST_REQUIRE(!index.has_keys());
+    BOOST_REQUIRE_EQUAL(index.find("alpha"), protoc::record_index::npos);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_offsets)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+
+    protoc::record_index index(buffer.data(), records);
+    BOOST_REQUIRE_EQUAL(index.size(), 3);
+    BOOST_REQUIRE(!index.has_keys());
+    // fixarray, fixstr header and key, positive fixint
+    BOOST_REQUIRE_EQUAL(index.offset(0), 0);
+    BOOST_REQUIRE_EQUAL(index.length(0), 8);
+    BOOST_REQUIRE_EQUAL(index.offset(1), 8);
+    BOOST_REQUIRE_EQUAL(index.length(1), 4);
+    BOOST_REQUIRE_EQUAL(index.offset(2), 12);
+    BOOST_REQUIRE_EQUAL(index.length(2), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_record)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    protoc::record_index index(buffer.data(), records);
+
+    BOOST_REQUIRE_EQUAL(record_number<protoc::msgpack::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), 2)), 2);
+    BOOST_REQUIRE_EQUAL(record_number<protoc::msgpack::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), 0)), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_range)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    protoc::record_index index(buffer.data(), records);
+
+    protoc::binary_view range = index.range(buffer.data(), buffer.data() + buffer.size(), 1, 3);
+    BOOST_REQUIRE(range.begin() == buffer.data() + 8);
+    BOOST_REQUIRE(range.end() == buffer.data() + buffer.size());
+    protoc::msgpack::reader reader(range.begin(), range.end());
+    reader.next(protoc::token::token_array_begin);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "b");
+    reader.next();
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+    reader.next();
+    reader.next(protoc::token::token_array_end);
+    reader.next(protoc::token::token_array_begin);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "charlie");
+
+    BOOST_REQUIRE(index.range(buffer.data(), buffer.data() + buffer.size(), 1, 1).empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_keys)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("charlie", "alpha", "bravo"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+
+    protoc::record_index index(buffer.data(), records, record_key<protoc::msgpack::reader>());
+    BOOST_REQUIRE(index.has_keys());
+    BOOST_REQUIRE_EQUAL(index.key(0), "charlie");
+    BOOST_REQUIRE_EQUAL(index.find("alpha"), 1);
+    BOOST_REQUIRE_EQUAL(index.find("bravo"), 2);
+    BOOST_REQUIRE_EQUAL(index.find("charlie"), 0);
+    BOOST_REQUIRE_EQUAL(index.find("delta"), protoc::record_index::npos);
+    BOOST_REQUIRE_EQUAL(index.find("a"), protoc::record_index::npos);
+
+    const std::size_t n = index.find("bravo");
+    BOOST_REQUIRE_EQUAL(record_number<protoc::msgpack::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), n)), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_duplicate_keys)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("bravo", "alpha", "bravo"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+
+    protoc::record_index index(buffer.data(), records, record_key<protoc::msgpack::reader>());
+    BOOST_REQUIRE_EQUAL(index.find("bravo"), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_transenc_record)
+{
+    binary_buffer buffer;
+    write_records<protoc::transenc::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::transenc::split(buffer.data(), buffer.data() + buffer.size(), records);
+
+    protoc::record_index index(buffer.data(), records, record_key<protoc::transenc::reader>());
+    BOOST_REQUIRE_EQUAL(index.size(), 3);
+    BOOST_REQUIRE_EQUAL(index.offset(0), 0);
+    BOOST_REQUIRE_EQUAL(index.offset(2) + index.length(2), buffer.size());
+    BOOST_REQUIRE_EQUAL(record_number<protoc::transenc::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), index.find("b"))), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_push_back)
+{
+    protoc::record_index index;
+    index.push_back(4, 10);
+    index.push_back(10, 12);
+    BOOST_REQUIRE_EQUAL(index.size(), 2);
+    BOOST_REQUIRE_EQUAL(index.offset(0), 4);
+    BOOST_REQUIRE_EQUAL(index.length(0), 6);
+    BOOST_REQUIRE_EQUAL(index.length(1), 2);
+    BOOST_REQUIRE_THROW(index.push_back(13, 14), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(index.push_back(12, 11), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(index.push_back(12, 14, "alpha"), protoc::invalid_value);
+    BOOST_REQUIRE_EQUAL(index.size(), 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_push_back_keys)
+{
+    protoc::record_index index;
+    index.push_back(0, 1, "charlie");
+    index.push_back(1, 2, "alpha");
+    index.push_back(2, 3, "bravo");
+    BOOST_REQUIRE_EQUAL(index.find("alpha"), 1);
+    BOOST_REQUIRE_EQUAL(index.find("bravo"), 2);
+    BOOST_REQUIRE_EQUAL(index.find("charlie"), 0);
+    BOOST_REQUIRE_THROW(index.push_back(3, 4), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(test_not_contiguous)
+{
+    const unsigned char input[] = { 0x01, 0x02, 0x03 };
+    std::vector<protoc::binary_view> records;
+    records.push_back(protoc::binary_view(input, input + 1));
+    records.push_back(protoc::binary_view(input + 2, input + 3));
+    BOOST_REQUIRE_THROW(protoc::record_index(input, records), protoc::invalid_value);
+}
+
+//-----------------------------------------------------------------------------
+// Saving and loading
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_save)
+{
+    protoc::record_index index;
+    index.push_back(0, 2);
+    binary_buffer output;
+    index.save(output);
+    const unsigned char expected[] = { 'P', 'R', 'I', 'X', 0x01, 0x00, 0x00, 0x00,
+                                       0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                       0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                                       0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(output.begin(), output.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_load)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    binary_buffer saved;
+    protoc::record_index(buffer.data(), records).save(saved);
+
+    protoc::record_index index(saved.data(), saved.data() + saved.size());
+    BOOST_REQUIRE_EQUAL(index.size(), 3);
+    BOOST_REQUIRE(!index.has_keys());
+    BOOST_REQUIRE_EQUAL(index.offset(2), 12);
+    BOOST_REQUIRE_EQUAL(index.length(2), 10);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_keys)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("charlie", "alpha", "bravo"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    binary_buffer saved;
+    protoc::record_index(buffer.data(), records, record_key<protoc::msgpack::reader>()).save(saved);
+
+    protoc::record_index index(saved.data(), saved.data() + saved.size());
+    BOOST_REQUIRE(index.has_keys());
+    BOOST_REQUIRE_EQUAL(index.key(1), "alpha");
+    BOOST_REQUIRE_EQUAL(index.find("bravo"), 2);
+    BOOST_REQUIRE_EQUAL(record_number<protoc::msgpack::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), index.find("charlie"))), 0);
+}
+
+BOOST_AUTO_TEST_CASE(fail_load_beyond_stream)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    binary_buffer saved;
+    protoc::record_index(buffer.data(), records).save(saved);
+
+    // The end of the last record is moved past the stream
+    saved[40] = 0xFF;
+    protoc::record_index index(saved.data(), saved.data() + saved.size());
+    BOOST_REQUIRE_EQUAL(index.offset(2), 12);
+    BOOST_REQUIRE_EQUAL(index.length(2), 0xFF - 12);
+    BOOST_REQUIRE_EQUAL(record_number<protoc::msgpack::reader>(index.record(buffer.data(), buffer.data() + buffer.size(), 0)), 0);
+    BOOST_REQUIRE_THROW(index.record(buffer.data(), buffer.data() + buffer.size(), 2), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(index.range(buffer.data(), buffer.data() + buffer.size(), 0, 3), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(fail_record_beyond_stream)
+{
+    binary_buffer buffer;
+    write_records<protoc::msgpack::writer>(buffer, make_keys("alpha", "b", "charlie"));
+    std::vector<protoc::binary_view> records;
+    protoc::msgpack::split(buffer.data(), buffer.data() + buffer.size(), records);
+    protoc::record_index index(buffer.data(), records);
+
+    // Index of a longer stream than the one at hand
+    const unsigned char *end = buffer.data() + buffer.size() - 1;
+    BOOST_REQUIRE_EQUAL(index.record(buffer.data(), end, 1).size(), 4);
+    BOOST_REQUIRE_THROW(index.record(buffer.data(), end, 2), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_CASE(test_load_empty)
+{
+    binary_buffer saved;
+    protoc::record_index().save(saved);
+    protoc::record_index index(saved.data(), saved.data() + saved.size());
+    BOOST_REQUIRE(index.empty());
+}
+
+BOOST_AUTO_TEST_CASE(test_load_invalid)
+{
+    protoc::record_index original;
+    original.push_back(0, 1, "bravo");
+    original.push_back(1, 2, "alpha");
+    binary_buffer saved;
+    original.save(saved);
+
+    // Truncated
+    BOOST_REQUIRE_THROW(protoc::record_index(saved.data(), saved.data() + saved.size() - 1), protoc::invalid_value);
+    BOOST_REQUIRE_THROW(protoc::record_index(saved.data(), saved.data() + 4), protoc::invalid_value);
+    // Trailing data
+    binary_buffer trailing(saved);
+    trailing.push_back(0x00);
+    BOOST_REQUIRE_THROW(protoc::record_index(trailing.data(), trailing.data() + trailing.size()), protoc::invalid_value);
+    // Magic
+    binary_buffer magic(saved);
+    magic[0] = 'X';
+    BOOST_REQUIRE_THROW(protoc::record_index(magic.data(), magic.data() + magic.size()), protoc::invalid_value);
+    // Huge count
+    binary_buffer count(saved);
+    count[15] = 0x01;
+    BOOST_REQUIRE_THROW(protoc::record_index(count.data(), count.data() + count.size()), protoc::invalid_value);
+    // Unordered offsets
+    binary_buffer offsets(saved);
+    offsets[24] = 0x05;
+    BOOST_REQUIRE_THROW(protoc::record_index(offsets.data(), offsets.data() + offsets.size()), protoc::invalid_value);
+    // Unsorted keys, by swapping the record numbers of the key order
+    binary_buffer order(saved);
+    std::swap(order[40], order[48]);
+    BOOST_REQUIRE_THROW(protoc::record_index(order.data(), order.data() + order.size()), protoc::invalid_value);
+    // Repeated record number in the key order
+    order[40] = order[48];
+    BOOST_REQUIRE_THROW(protoc::record_index(order.data(), order.data() + order.size()), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
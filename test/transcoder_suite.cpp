@@ -0,0 +1,291 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2014 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <vector>
+#include <protoc/output_container.hpp>
+#include <protoc/transcoder.hpp>
+#include <protoc/json/reader.hpp>
+#include <protoc/json/transcoder.hpp>
+#include <protoc/msgpack/reader.hpp>
+#include <protoc/msgpack/writer.hpp>
+#include <protoc/msgpack/detail/codes.hpp>
+#include <protoc/transenc/reader.hpp>
+#include <protoc/transenc/writer.hpp>
+
+namespace
+{
+
+typedef std::vector<unsigned char> binary_buffer;
+typedef protoc::output_container<unsigned char, std::vector> binary_output;
+typedef protoc::output_container<char, std::vector> text_output;
+
+std::string json_to_json(const std::string& input)
+{
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    protoc::transcode(reader, writer);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+binary_buffer json_to_msgpack(const std::string& input)
+{
+    protoc::json::reader reader(input.data(), input.data() + input.size());
+    binary_buffer buffer;
+    binary_output output(buffer);
+    protoc::msgpack::writer writer(output, protoc::msgpack::writer::count_deferred_compact);
+    protoc::transcode(reader, writer);
+    return buffer;
+}
+
+std::string msgpack_to_json(const binary_buffer& input)
+{
+    protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    protoc::transcode(reader, writer);
+    return std::string(buffer.begin(), buffer.end());
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(transcoder_suite)
+
+//-----------------------------------------------------------------------------
+// JSON to JSON
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_json_scalars)
+{
+    BOOST_REQUIRE_EQUAL(json_to_json("null"), "null");
+    BOOST_REQUIRE_EQUAL(json_to_json("true"), "true");
+    BOOST_REQUIRE_EQUAL(json_to_json("42"), "42");
+    BOOST_REQUIRE_EQUAL(json_to_json("\"alpha\""), "\"alpha\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_escaped_string)
+{
+    BOOST_REQUIRE_EQUAL(json_to_json("\"a\\nb\""), "\"a\\nb\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_json_nested)
+{
+    BOOST_REQUIRE_EQUAL(json_to_json("[1,{\"key\":[true,null]},[]]"),
+                        "[1,{\"key\":[true,null]},[]]");
+}
+
+//-----------------------------------------------------------------------------
+// JSON to msgpack
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_json_msgpack_array)
+{
+    binary_buffer result = json_to_msgpack("[1,\"A\",true]");
+    const unsigned char expected[] = { protoc::msgpack::detail::code_fixarray_3,
+                                       0x01,
+                                       protoc::msgpack::detail::code_fixstr_1, 0x41,
+                                       protoc::msgpack::detail::code_true };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_json_msgpack_escaped_string)
+{
+    binary_buffer result = json_to_msgpack("\"a\\nb\"");
+    const unsigned char expected[] = { protoc::msgpack::detail::code_fixstr_3, 'a', '\n', 'b' };
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_json_msgpack_roundtrip)
+{
+    const std::string input("{\"alpha\":[1,-2,3.5],\"bravo\":{\"charlie\":\"delta\"},\"echo\":[]}");
+    BOOST_REQUIRE_EQUAL(msgpack_to_json(json_to_msgpack(input)), input);
+}
+
+//-----------------------------------------------------------------------------
+// msgpack
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_msgpack_counted)
+{
+    // The element count of the input is passed on, so the output can be
+    // written without deferred counts
+    binary_buffer input = json_to_msgpack("[[1,2],{\"A\":null}]");
+    protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+    binary_buffer buffer;
+    binary_output output(buffer);
+    protoc::msgpack::writer writer(output);
+    protoc::transcode(reader, writer);
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(buffer.begin(), buffer.end(),
+                                    input.begin(), input.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_binary_transenc)
+{
+    const unsigned char data[] = { 0x00, 0x01, 0xFF };
+    binary_buffer input;
+    {
+        binary_output output(input);
+        protoc::msgpack::writer writer(output);
+        writer.array_begin(2);
+        writer.write(data, sizeof(data));
+        writer.write("alpha");
+        writer.array_end();
+    }
+
+    // msgpack to transenc
+    binary_buffer intermediate;
+    {
+        protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+        binary_output output(intermediate);
+        protoc::transenc::writer writer(output);
+        protoc::transcode(reader, writer);
+    }
+    {
+        protoc::transenc::reader reader(intermediate.data(), intermediate.data() + intermediate.size());
+        BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_begin);
+        BOOST_REQUIRE(reader.next());
+        // Count
+        BOOST_REQUIRE_EQUAL(reader.get_int(), 2);
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_binary);
+        protoc::reader::range_type range = reader.get_range();
+        BOOST_REQUIRE_EQUAL_COLLECTIONS(range.begin(), range.end(),
+                                        data, data + sizeof(data));
+        BOOST_REQUIRE(reader.next());
+        BOOST_REQUIRE_EQUAL(reader.get_string(), "alpha");
+    }
+
+    // transenc back to msgpack with the count from the input
+    binary_buffer result;
+    {
+        protoc::transenc::reader reader(intermediate.data(), intermediate.data() + intermediate.size());
+        binary_output output(result);
+        protoc::msgpack::writer writer(output);
+        protoc::transcode(reader, writer);
+    }
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(result.begin(), result.end(),
+                                    input.begin(), input.end());
+}
+
+BOOST_AUTO_TEST_CASE(test_transenc_json)
+{
+    // Containers without count
+    binary_buffer input;
+    {
+        binary_output output(input);
+        protoc::transenc::writer writer(output);
+        writer.map_begin();
+        writer.write("alpha");
+        writer.array_begin();
+        writer.write(1);
+        writer.write(true);
+        writer.array_end();
+        writer.map_end();
+    }
+    protoc::transenc::reader reader(input.data(), input.data() + input.size());
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    protoc::transcode(reader, writer);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "{\"alpha\":[1,true]}");
+}
+
+BOOST_AUTO_TEST_CASE(test_transenc_count_json)
+{
+    // The reader traits come with transenc/reader.hpp, so the count is not
+    // mistaken for an element
+    binary_buffer input;
+    {
+        binary_output output(input);
+        protoc::transenc::writer writer(output);
+        writer.array_begin(2);
+        writer.write(7);
+        writer.write(8);
+        writer.array_end();
+    }
+    protoc::transenc::reader reader(input.data(), input.data() + input.size());
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    protoc::transcode(reader, writer);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "[7,8]");
+}
+
+BOOST_AUTO_TEST_CASE(test_msgpack_dynamic_reader)
+{
+    // Without the static type of the reader the counts are unknown
+    binary_buffer input = json_to_msgpack("[1,2]");
+    protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+    protoc::reader& dynamic_reader = reader;
+    binary_buffer buffer;
+    binary_output output(buffer);
+    protoc::msgpack::writer writer(output);
+    BOOST_REQUIRE_THROW(protoc::transcode(dynamic_reader, writer), protoc::invalid_value);
+}
+
+//-----------------------------------------------------------------------------
+// Single value
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_value)
+{
+    binary_buffer input = json_to_msgpack("[1,[2]]");
+    binary_buffer second = json_to_msgpack("3");
+    input.insert(input.end(), second.begin(), second.end());
+
+    protoc::msgpack::reader reader(input.data(), input.data() + input.size());
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    protoc::transcode_value(reader, writer);
+    BOOST_REQUIRE_EQUAL(std::string(buffer.begin(), buffer.end()), "[1,[2]]");
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_integer);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 3);
+}
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fail_truncated)
+{
+    const unsigned char input[] = { protoc::msgpack::detail::code_fixarray_2, 0x01 };
+    protoc::msgpack::reader reader(input, input + sizeof(input));
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    BOOST_REQUIRE_THROW(protoc::transcode(reader, writer), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_json_binary)
+{
+    const unsigned char input[] = { protoc::msgpack::detail::code_bin8, 0x01, 0x00 };
+    protoc::msgpack::reader reader(input, input + sizeof(input));
+    std::vector<char> buffer;
+    text_output output(buffer);
+    protoc::json::writer writer(output);
+    BOOST_REQUIRE_THROW(protoc::transcode(reader, writer), protoc::invalid_value);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -434,6 +434,38 @@ BOOST_AUTO_TEST_CASE(test_vector_missing_begin)
                         protoc::unexpected_token);
 }
 
+BOOST_AUTO_TEST_CASE(test_vector_int)
+{
+    format::iarchive::value_type input[] = { detail::code_array_begin, 0x03, 0x01, detail::code_int16, 0x00, 0xFF, 0x03, detail::code_array_end };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<int> value;
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 3);
+    BOOST_REQUIRE_EQUAL(value[0], 1);
+    BOOST_REQUIRE_EQUAL(value[1], -256);
+    BOOST_REQUIRE_EQUAL(value[2], 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_int_without_count)
+{
+    format::iarchive::value_type input[] = { detail::code_array_begin, detail::code_null, 0x01, 0x02, detail::code_array_end };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<long long> value;
+    BOOST_REQUIRE_NO_THROW(in >> value);
+    BOOST_REQUIRE_EQUAL(value.size(), 2);
+    BOOST_REQUIRE_EQUAL(value[0], 1);
+    BOOST_REQUIRE_EQUAL(value[1], 2);
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_double_mixed)
+{
+    format::iarchive::value_type input[] = { detail::code_array_begin, 0x02, detail::code_float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, detail::code_true, detail::code_array_end };
+    format::iarchive in(input, input + sizeof(input));
+    std::vector<double> value;
+    BOOST_REQUIRE_THROW(in >> value,
+                        protoc::invalid_value);
+}
+
 BOOST_AUTO_TEST_CASE(test_set_int_empty)
 {
     format::iarchive::value_type input[] = { detail::code_array_begin, detail::code_null, detail::code_array_end };
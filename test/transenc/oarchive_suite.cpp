@@ -62,6 +62,7 @@ BOOST_AUTO_TEST_CASE(test_empty)
     format::stream_oarchive ar(result);
 
     char expected[] = { };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -75,6 +76,7 @@ BOOST_AUTO_TEST_CASE(test_false)
     ar << value;
 
     char expected[] = { detail::code_false };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -88,6 +90,7 @@ BOOST_AUTO_TEST_CASE(test_true)
     ar << value;
 
     char expected[] = { detail::code_true };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -101,6 +104,7 @@ BOOST_AUTO_TEST_CASE(test_const_false)
     ar << value;
 
     char expected[] = { detail::code_false };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -114,6 +118,7 @@ BOOST_AUTO_TEST_CASE(test_const_true)
     ar << value;
 
     char expected[] = { detail::code_true };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -131,6 +136,7 @@ BOOST_AUTO_TEST_CASE(test_int_zero)
     ar << value;
 
     char expected[] = { 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -144,6 +150,7 @@ BOOST_AUTO_TEST_CASE(test_const_int_zero)
     ar << value;
 
     char expected[] = { 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -157,6 +164,7 @@ BOOST_AUTO_TEST_CASE(test_int_one)
     ar << value;
 
     char expected[] = { 0x01 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -170,6 +178,7 @@ BOOST_AUTO_TEST_CASE(test_int_minus_one)
     ar << value;
 
     char expected[] = { 0xFF };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -183,6 +192,7 @@ BOOST_AUTO_TEST_CASE(test_int_minus_128)
     ar << value;
 
     char expected[] = { detail::code_int8, 0x80 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -196,6 +206,7 @@ BOOST_AUTO_TEST_CASE(test_int16)
     ar << value;
 
     char expected[] = { detail::code_int16, 0x00, 0x01 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -209,6 +220,7 @@ BOOST_AUTO_TEST_CASE(test_const_int16)
     ar << value;
 
     char expected[] = { detail::code_int16, 0x00, 0x01 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -222,6 +234,7 @@ BOOST_AUTO_TEST_CASE(test_int32)
     ar << value;
 
     char expected[] = { detail::code_int32, 0x00, 0x00, 0x01, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -235,6 +248,7 @@ BOOST_AUTO_TEST_CASE(test_const_int32)
     ar << value;
 
     char expected[] = { detail::code_int32, 0x00, 0x00, 0x01, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -248,6 +262,7 @@ BOOST_AUTO_TEST_CASE(test_int64)
     ar << value;
 
     char expected[] = { detail::code_int64, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -261,6 +276,7 @@ BOOST_AUTO_TEST_CASE(test_const_int64)
     ar << value;
 
     char expected[] = { detail::code_int64, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -281,6 +297,7 @@ BOOST_AUTO_TEST_CASE(test_int_all_types)
                         detail::code_int16, 0x00, 0x01,
                         detail::code_int32, 0x00, 0x00, 0x01, 0x00,
                         detail::code_int64, 0x00, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -298,6 +315,7 @@ BOOST_AUTO_TEST_CASE(test_float32_one)
     ar << value;
 
     char expected[] = { detail::code_float32, 0x00, 0x00, 0x80, 0x3F };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -311,6 +329,7 @@ BOOST_AUTO_TEST_CASE(test_const_float32_one)
     ar << value;
 
     char expected[] = { detail::code_float32, 0x00, 0x00, 0x80, 0x3F };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -324,6 +343,7 @@ BOOST_AUTO_TEST_CASE(test_float64_one)
     ar << value;
 
     char expected[] = { detail::code_float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -337,6 +357,7 @@ BOOST_AUTO_TEST_CASE(test_const_float64_one)
     ar << value;
 
     char expected[] = { detail::code_float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -354,6 +375,7 @@ BOOST_AUTO_TEST_CASE(test_string_empty)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -367,6 +389,7 @@ BOOST_AUTO_TEST_CASE(test_const_string_empty)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -380,6 +403,7 @@ BOOST_AUTO_TEST_CASE(test_string_a)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x01, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -393,6 +417,7 @@ BOOST_AUTO_TEST_CASE(test_string_alpha)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x05, 0x41, 0x4C, 0x50, 0x48, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -406,6 +431,7 @@ BOOST_AUTO_TEST_CASE(test_literal_alpha)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x05, 0x41, 0x4C, 0x50, 0x48, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -418,6 +444,7 @@ BOOST_AUTO_TEST_CASE(test_literal_alpha_2)
     ar << "ALPHA";
 
     char expected[] = { detail::code_string_int8, 0x05, 0x41, 0x4C, 0x50, 0x48, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -435,6 +462,7 @@ BOOST_AUTO_TEST_CASE(test_pair)
     ar << value;
 
     char expected[] = { detail::code_record_begin, detail::code_string_int8, 0x01, 0x41, detail::code_true, detail::code_record_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -448,6 +476,7 @@ BOOST_AUTO_TEST_CASE(test_const_pair)
     ar << value;
 
     char expected[] = { detail::code_record_begin, detail::code_string_int8, 0x01, 0x41, detail::code_true, detail::code_record_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -465,6 +494,7 @@ BOOST_AUTO_TEST_CASE(test_optional)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x01, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -478,6 +508,7 @@ BOOST_AUTO_TEST_CASE(test_optional_null)
     ar << value;
 
     char expected[] = { detail::code_null };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -491,6 +522,7 @@ BOOST_AUTO_TEST_CASE(test_const_optional)
     ar << value;
 
     char expected[] = { detail::code_string_int8, 0x01, 0x41 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -504,6 +536,7 @@ BOOST_AUTO_TEST_CASE(test_const_optional_null)
     ar << value;
 
     char expected[] = { detail::code_null };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -521,6 +554,7 @@ BOOST_AUTO_TEST_CASE(test_nvp)
     out << boost::serialization::make_nvp("value", value);
 
     char expected[] = { detail::code_false };
+    out.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -538,6 +572,7 @@ BOOST_AUTO_TEST_CASE(test_vector_bool_empty)
     ar << value;
 
     char expected[] = { detail::code_array_begin, 0x00, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -552,6 +587,7 @@ BOOST_AUTO_TEST_CASE(test_vector_bool_one)
     ar << value;
 
     char expected[] = { detail::code_array_begin, 0x01, detail::code_true, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -567,6 +603,37 @@ BOOST_AUTO_TEST_CASE(test_vector_bool_two)
     ar << value;
 
     char expected[] = { detail::code_array_begin, 0x02, detail::code_true, detail::code_false, detail::code_array_end };
+    ar.flush();
+    std::string got = result.str();
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_int)
+{
+    std::ostringstream result;
+    format::stream_oarchive ar(result);
+    std::vector<int> value;
+    value.push_back(1);
+    value.push_back(200);
+    ar << value;
+
+    char expected[] = { detail::code_array_begin, 0x02, 0x01, detail::code_int16, 0xC8, 0x00, detail::code_array_end };
+    ar.flush();
+    std::string got = result.str();
+    BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
+                                    expected, expected + sizeof(expected));
+}
+
+BOOST_AUTO_TEST_CASE(test_vector_double)
+{
+    std::ostringstream result;
+    format::stream_oarchive ar(result);
+    std::vector<double> value(1, 1.0);
+    ar << value;
+
+    char expected[] = { detail::code_array_begin, 0x01, detail::code_float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -580,6 +647,7 @@ BOOST_AUTO_TEST_CASE(test_set_int_empty)
     ar << value;
 
     char expected[] = { detail::code_array_begin, detail::code_null, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -594,6 +662,7 @@ BOOST_AUTO_TEST_CASE(test_set_int_one)
     ar << value;
 
     char expected[] = { detail::code_array_begin, detail::code_null, 0x01, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -609,6 +678,7 @@ BOOST_AUTO_TEST_CASE(test_set_int_two)
     ar << value;
 
     char expected[] = { detail::code_array_begin, detail::code_null, 0x01, 0x02, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -622,6 +692,7 @@ BOOST_AUTO_TEST_CASE(test_map_bool_empty)
     ar << value;
 
     char expected[] = { detail::code_map_begin, detail::code_null, detail::code_map_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -636,6 +707,7 @@ BOOST_AUTO_TEST_CASE(test_map_bool_one)
     ar << value;
 
     char expected[] = { detail::code_map_begin, detail::code_null, detail::code_record_begin, detail::code_string_int8, 0x01, 0x41, detail::code_true, detail::code_record_end, detail::code_map_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -651,6 +723,7 @@ BOOST_AUTO_TEST_CASE(test_map_bool_two)
     ar << value;
 
     char expected[] = { detail::code_map_begin, detail::code_null, detail::code_record_begin, detail::code_string_int8, 0x01, 0x41, detail::code_true, detail::code_record_end, detail::code_record_begin, detail::code_string_int8, 0x01, 0x42, detail::code_false, detail::code_record_end, detail::code_map_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -672,6 +745,7 @@ BOOST_AUTO_TEST_CASE(test_enum_one)
     format::stream_oarchive ar(result);
     enum Number value = one;
     ar << value;
+    ar.flush();
     BOOST_REQUIRE_EQUAL(result.str().data(), "\xA3\x01");
 }
 #endif
@@ -733,6 +807,7 @@ BOOST_AUTO_TEST_CASE(test_struct_person)
     ar << value;
 
     char expected[] = { detail::code_record_begin, detail::code_string_int8, 0x04, 0x4B, 0x41, 0x4E, 0x54, 0x7F, detail::code_record_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -746,6 +821,7 @@ BOOST_AUTO_TEST_CASE(test_struct_split_person)
     ar << value;
 
     char expected[] = { detail::code_record_begin, detail::code_string_int8, 0x04, 0x4B, 0x41, 0x4E, 0x54, 0x7F, detail::code_record_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -760,6 +836,7 @@ BOOST_AUTO_TEST_CASE(test_vector_of_struct_person)
     ar << persons;
 
     char expected[] = { detail::code_array_begin, 0x01, detail::code_record_begin, detail::code_string_int8, 0x04, 0x4B, 0x41, 0x4E, 0x54, 0x7F, detail::code_record_end, detail::code_array_end };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -776,6 +853,7 @@ BOOST_AUTO_TEST_CASE(test_binary_empty)
     ar << value;
 
     char expected[] = { detail::code_binary_int8, 0x00 };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -789,6 +867,7 @@ BOOST_AUTO_TEST_CASE(test_binary_one)
     ar << value;
 
     char expected[] = { detail::code_binary_int8, 0x01, 0xFF };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -802,6 +881,7 @@ BOOST_AUTO_TEST_CASE(test_binary_two)
     ar << value;
 
     char expected[] = { detail::code_binary_int8, 0x02, 0xFF, 0xFF };
+    ar.flush();
     std::string got = result.str();
     BOOST_REQUIRE_EQUAL_COLLECTIONS(got.begin(), got.end(),
                                     expected, expected + sizeof(expected));
@@ -0,0 +1,145 @@
+///////////////////////////////////////////////////////////////////////////////
+//
+// http://protoc.sourceforge.net/
+//
+// Copyright (C) 2013 Bjorn Reese <breese@users.sourceforge.net>
+//
+// Permission to use, copy, modify, and distribute this software for any
+// purpose with or without fee is hereby granted, provided that the above
+// copyright notice and this permission notice appear in all copies.
+//
+// THIS SOFTWARE IS PROVIDED ``AS IS'' AND WITHOUT ANY EXPRESS OR IMPLIED
+// WARRANTIES, INCLUDING, WITHOUT LIMITATION, THE IMPLIED WARRANTIES OF
+// MERCHANTIBILITY AND FITNESS FOR A PARTICULAR PURPOSE. THE AUTHORS AND
+// CONTRIBUTORS ACCEPT NO RESPONSIBILITY IN ANY CONCEIVABLE MANNER.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include <boost/test/unit_test.hpp>
+
+#include <sstream>
+#include <string>
+#include <protoc/transenc/parser.hpp>
+#include <protoc/transenc/detail/codes.hpp>
+
+namespace format = protoc::transenc;
+namespace detail = format::detail;
+
+namespace
+{
+
+// Records the handler calls as a space separated trace
+struct recorder
+{
+    void on_null() { add("null"); }
+    void on_bool(bool value) { add(value ? "true" : "false"); }
+    void on_int(protoc::int64_t value) { std::ostringstream s; s << value; add(s.str()); }
+    void on_double(protoc::float64_t value) { std::ostringstream s; s << value << "f"; add(s.str()); }
+    void on_string(const protoc::string_view& value) { add("\"" + std::string(value.begin(), value.end()) + "\""); }
+    void on_binary(const protoc::binary_view& value) { std::ostringstream s; s << "bin" << value.size(); add(s.str()); }
+    void on_record_begin() { add("("); }
+    void on_record_end() { add(")"); }
+    void on_array_begin() { add("["); }
+    void on_array_end() { add("]"); }
+    void on_map_begin() { add("{"); }
+    void on_map_end() { add("}"); }
+
+    void add(const std::string& value)
+    {
+        if (!trace.empty())
+            trace += " ";
+        trace += value;
+    }
+
+    std::string trace;
+};
+
+template <std::size_t N>
+std::string parse(const unsigned char (&input)[N])
+{
+    recorder handler;
+    format::parse(input, input + N, handler);
+    return handler.trace;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(transenc_parser_suite)
+
+//-----------------------------------------------------------------------------
+// Basic types
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_empty)
+{
+    recorder handler;
+    std::string input;
+    BOOST_REQUIRE_THROW(format::parse(input, handler), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(test_null)
+{
+    const unsigned char input[] = { detail::code_null };
+    BOOST_REQUIRE_EQUAL(parse(input), "null");
+}
+
+BOOST_AUTO_TEST_CASE(test_integer)
+{
+    const unsigned char input[] = { detail::code_int16, 0x00, 0x01 };
+    BOOST_REQUIRE_EQUAL(parse(input), "256");
+}
+
+BOOST_AUTO_TEST_CASE(test_string)
+{
+    const unsigned char input[] = { detail::code_string_int8, 0x02, 0x41, 0x42 };
+    BOOST_REQUIRE_EQUAL(parse(input), "\"AB\"");
+}
+
+BOOST_AUTO_TEST_CASE(test_binary)
+{
+    const unsigned char input[] = { detail::code_binary_int8, 0x01, detail::code_map_end };
+    BOOST_REQUIRE_EQUAL(parse(input), "bin1");
+}
+
+//-----------------------------------------------------------------------------
+// Containers
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_array)
+{
+    // The count written after the array begin is an ordinary value
+    const unsigned char input[] = { detail::code_array_begin, 0x02, detail::code_true, detail::code_false, detail::code_array_end };
+    BOOST_REQUIRE_EQUAL(parse(input), "[ 2 true false ]");
+}
+
+BOOST_AUTO_TEST_CASE(test_record)
+{
+    const unsigned char input[] = { detail::code_record_begin,
+                                    detail::code_map_begin, detail::code_null, detail::code_map_end,
+                                    detail::code_record_end };
+    BOOST_REQUIRE_EQUAL(parse(input), "( { null } )");
+}
+
+//-----------------------------------------------------------------------------
+// Errors
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(fail_mismatched_end)
+{
+    const unsigned char input[] = { detail::code_array_begin, detail::code_null, detail::code_map_end };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_unbalanced_end)
+{
+    const unsigned char input[] = { detail::code_array_end };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_missing_end)
+{
+    const unsigned char input[] = { detail::code_array_begin, detail::code_null };
+    BOOST_REQUIRE_THROW(parse(input), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -81,6 +81,27 @@ BOOST_AUTO_TEST_CASE(test_floating)
     BOOST_REQUIRE(!reader.next());
 }
 
+BOOST_AUTO_TEST_CASE(test_string)
+{
+    format::reader::value_type input[] = { detail::code_string_int8, 0x02, 0x41, 0x42 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_string);
+    BOOST_REQUIRE_EQUAL(reader.get_string(), "AB");
+    BOOST_REQUIRE(!reader.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_string_view)
+{
+    format::reader::value_type input[] = { detail::code_string_int8, 0x02, 0x41, 0x42 };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_string);
+    format::reader::string_view_type view = reader.get_string_view();
+    BOOST_REQUIRE(view.begin() == reinterpret_cast<const char *>(input + 2));
+    BOOST_REQUIRE_EQUAL(std::string(view.begin(), view.end()), "AB");
+    BOOST_REQUIRE_EQUAL(reader.has_escapes(), false);
+    BOOST_REQUIRE(!reader.next());
+}
+
 //-----------------------------------------------------------------------------
 // Containers
 //-----------------------------------------------------------------------------
@@ -99,4 +120,131 @@ BOOST_AUTO_TEST_CASE(test_record)
     BOOST_REQUIRE_EQUAL(reader.size(), 0);
 }
 
+//-----------------------------------------------------------------------------
+// Sibling
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_null)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, detail::code_null, detail::code_true, detail::code_array_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_null);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_boolean);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_record)
+{
+    // The string and binary contain container codes that must not be counted
+    format::reader::value_type input[] = { detail::code_array_begin,
+                                           detail::code_record_begin,
+                                           detail::code_string_int8, 0x02, detail::code_record_end, detail::code_array_end,
+                                           detail::code_map_begin,
+                                           detail::code_binary_int8, 0x01, detail::code_map_end,
+                                           detail::code_null,
+                                           detail::code_map_end,
+                                           detail::code_record_end,
+                                           detail::code_true,
+                                           detail::code_array_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_record_begin);
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_boolean);
+    BOOST_REQUIRE_EQUAL(reader.get_bool(), true);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+    BOOST_REQUIRE(reader.next());
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE(!reader.next());
+    BOOST_REQUIRE_EQUAL(reader.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_next_sibling_outermost)
+{
+    format::reader::value_type input[] = { detail::code_map_begin, detail::code_null, detail::code_null, detail::code_map_end };
+    format::reader reader(input, input + sizeof(input));
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+    BOOST_REQUIRE_EQUAL(reader.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_mismatch)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, detail::code_null, detail::code_map_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE_THROW(reader.next_sibling(), protoc::unexpected_token);
+}
+
+BOOST_AUTO_TEST_CASE(fail_next_sibling_eof)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, detail::code_null };
+    format::reader reader(input, input + sizeof(input));
+    reader.next_sibling();
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_eof);
+}
+
+//-----------------------------------------------------------------------------
+// Bulk values
+//-----------------------------------------------------------------------------
+
+BOOST_AUTO_TEST_CASE(test_read_values_int)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, 0x01, detail::code_int16, 0x00, 0xFF, detail::code_int32, 0x00, 0x00, 0x01, 0x00, detail::code_array_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    int values[4] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 4), 3U);
+    BOOST_REQUIRE_EQUAL(values[0], 1);
+    BOOST_REQUIRE_EQUAL(values[1], -256);
+    BOOST_REQUIRE_EQUAL(values[2], 65536);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE_EQUAL(reader.size(), 1);
+    BOOST_REQUIRE(!reader.next());
+    BOOST_REQUIRE_EQUAL(reader.size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_partial)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, 0x01, 0x02, 0x03, detail::code_array_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    long long values[2] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 2U);
+    BOOST_REQUIRE_EQUAL(values[0], 1);
+    BOOST_REQUIRE_EQUAL(values[1], 2);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 3);
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 3);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_mismatch)
+{
+    format::reader::value_type input[] = { detail::code_array_begin, detail::code_float64, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xF0, 0x3F, detail::code_null, detail::code_float32, 0x00, 0x00, 0x00, 0x40, detail::code_array_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    double values[3] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 3), 1U);
+    BOOST_REQUIRE_EQUAL(values[0], 1.0);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_null);
+    BOOST_REQUIRE(reader.next());
+    float floats[3] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(floats, 3), 1U);
+    BOOST_REQUIRE_EQUAL(floats[0], 2.0f);
+    BOOST_REQUIRE_EQUAL(reader.type(), protoc::token::token_array_end);
+    BOOST_REQUIRE(!reader.next());
+}
+
+BOOST_AUTO_TEST_CASE(test_read_values_outside_array)
+{
+    format::reader::value_type input[] = { detail::code_map_begin, 0x01, 0x02, detail::code_map_end };
+    format::reader reader(input, input + sizeof(input));
+    BOOST_REQUIRE(reader.next());
+    int values[2] = {};
+    BOOST_REQUIRE_EQUAL(reader.read_values(values, 2), 0U);
+    BOOST_REQUIRE_EQUAL(reader.get_int(), 1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()